@@ -61,6 +61,7 @@ util::Status FileAnalyzer::Tokenize(Lexer* lexer) {
   lexer->Restart(Data().Contents());
   TokenSequence& tokens = MutableData().MutableTokenStream();
   do {
+    if (budget_ != nullptr && budget_->Exhausted()) return budget_->status();
     const auto& new_token = lexer->DoNextToken();
     tokens.push_back(new_token);
     if (lexer->TokenIsError(new_token)) {  // one more virtual function call
@@ -94,7 +95,9 @@ util::Status FileAnalyzer::Parse(Parser* parser) {
   if (status.ok()) {
     CHECK(SyntaxTree().get()) << "Expected syntax tree from parsing \""
                               << filename_ << "\", but got none.";
-  } else {
+  } else if (!BudgetExhausted()) {
+    // When the budget ran out, syntax errors are only artifacts of stopping
+    // early, and are not reported.
     for (const auto& token : parser->RejectedTokens()) {
       rejected_tokens_.push_back(RejectedToken{
           token, AnalysisPhase::kParsePhase, "" /* no detailed explanation */});
@@ -47,6 +47,7 @@
 #include "common/parser/parse.h"
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 
 namespace verible {
@@ -79,7 +80,18 @@ class FileAnalyzer : public TextStructure {
 
   virtual util::Status Tokenize() = 0;
 
+  // Limits the time and memory spent on analysis.  Once 'budget' is
+  // exhausted, analysis stops with the budget's status.
+  // 'budget' (not owned) must outlive analysis; nullptr means unlimited.
+  void SetBudget(ResourceBudget* budget) { budget_ = budget; }
+
+  // Returns true if analysis was cut short by the budget.
+  bool BudgetExhausted() const {
+    return budget_ != nullptr && !budget_->status().ok();
+  }
+
   // Break file contents (string) into tokens.
+  // Stops early (without an EOF token) when the budget is exhausted.
   util::Status Tokenize(Lexer* lexer);
 
   // Construct ConcreteSyntaxTree from TokenStreamView.
@@ -106,6 +118,9 @@ class FileAnalyzer : public TextStructure {
 
   // Locations of syntax-rejected tokens.
   std::vector<RejectedToken> rejected_tokens_;
+
+  // Limits analysis, if not null.
+  ResourceBudget* budget_ = nullptr;
 };
 
 }  // namespace verible
@@ -21,8 +21,11 @@
 #include "gtest/gtest.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/lexer/lexer.h"
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 
 namespace verible {
@@ -34,6 +37,8 @@ class FakeFileAnalyzer : public FileAnalyzer {
   FakeFileAnalyzer(const std::string& text, const std::string& filename)
       : FileAnalyzer(text, filename) {}
 
+  using FileAnalyzer::Tokenize;
+
   util::Status Tokenize() override {
     // TODO(fangism): Tokenize(lexer) interface is not directly tested, but
     // covered elsewhere.
@@ -41,6 +46,38 @@ class FakeFileAnalyzer : public FileAnalyzer {
   }
 };
 
+// Lexer that never reaches the end of its input.
+class EndlessLexer : public Lexer {
+ public:
+  EndlessLexer() : token_(1, "") {}
+
+  const TokenInfo& GetLastToken() const override { return token_; }
+
+  const TokenInfo& DoNextToken() override { return token_; }
+
+  // Repeats the first character of 'text'.
+  void Restart(absl::string_view text) override {
+    token_ = TokenInfo(1, text.substr(0, 1));
+  }
+
+  bool TokenIsError(const TokenInfo&) const override { return false; }
+
+ private:
+  TokenInfo token_;
+};
+
+// Verify that tokenizing stops when the budget runs out.
+TEST(FileAnalyzerTest, TokenizeStopsWhenBudgetExhausted) {
+  FakeFileAnalyzer analyzer("x", "x.txt");
+  ResourceBudget budget(absl::Milliseconds(5), 0);
+  analyzer.SetBudget(&budget);
+  EndlessLexer lexer;
+  const auto status = analyzer.Tokenize(&lexer);
+  EXPECT_EQ(status.code(), util::StatusCode::kDeadlineExceeded);
+  EXPECT_TRUE(analyzer.BudgetExhausted());
+  EXPECT_TRUE(analyzer.GetRejectedTokens().empty());
+}
+
 // Verify that an error token on one line is reported correctly.
 TEST(FileAnalyzerTest, TokenErrorMessageSameLine) {
   const std::string text("hello, world\nbye w0rld\n");
@@ -19,6 +19,7 @@
 #define VERIBLE_COMMON_ANALYSIS_LINT_RULE_H_
 
 #include "common/analysis/lint_rule_status.h"
+#include "common/text/identifier_table.h"
 
 namespace verible {
 
@@ -30,6 +31,24 @@ class LintRule {
   // Report() returns a LintRuleStatus, which summarizes the results so
   // far of running the LintRule.
   virtual LintRuleStatus Report() const = 0;
+
+  // Shares the identifier table of the file being analyzed (not owned), which
+  // must outlive the analysis.  nullptr restores the empty table.
+  void SetIdentifierTable(const LazyIdentifierTable* table) {
+    identifiers_ = table;
+  }
+
+ protected:
+  // Identifiers of the file being analyzed, interned on the first call by any
+  // rule.  Without a table (e.g. in tests), lookups compute properties
+  // directly.
+  const IdentifierTable& Identifiers() const {
+    return identifiers_ != nullptr ? identifiers_->Get()
+                                   : IdentifierTable::Empty();
+  }
+
+ private:
+  const LazyIdentifierTable* identifiers_ = nullptr;
 };
 
 }  // namespace verible
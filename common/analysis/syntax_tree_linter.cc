@@ -21,6 +21,7 @@
 #include "common/analysis/syntax_tree_lint_rule.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
+#include "common/text/flat_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/util/logging.h"
@@ -30,7 +31,47 @@ namespace verible {
 void SyntaxTreeLinter::Lint(const Symbol& root) {
   VLOG(1) << "SyntaxTreeLinter analyzing syntax tree with " << rules_.size()
           << " rules.";
-  root.Accept(this);
+  Traverse(root);
+}
+
+namespace {
+// Exposes the stack operations of SyntaxTreeContext for traversals that are
+// not recursive, where AutoPop does not apply.
+class FlatTreeContext : public SyntaxTreeContext {
+ public:
+  using SyntaxTreeContext::Pop;
+  using SyntaxTreeContext::Push;
+};
+}  // namespace
+
+void SyntaxTreeLinter::Lint(const FlatSyntaxTree& tree) {
+  VLOG(1) << "SyntaxTreeLinter analyzing flat syntax tree with "
+          << rules_.size() << " rules.";
+  FlatTreeContext context;
+  // Indices of the nodes in 'context', parallel to its stack.
+  std::vector<FlatSyntaxTree::index_type> open_nodes;
+  for (FlatSyntaxTree::index_type i = 0; i < tree.size(); ++i) {
+    if (budget_ != nullptr && budget_->Exhausted()) break;
+    while (!open_nodes.empty() && tree.SubtreeEnd(open_nodes.back()) <= i) {
+      open_nodes.pop_back();
+      context.Pop();
+    }
+    if (tree.IsLeaf(i)) {
+      const SyntaxTreeLeaf& leaf = tree.Leaf(i);
+      for (const auto& rule : rules_) {
+        rule->HandleLeaf(leaf, context);
+        rule->HandleSymbol(leaf, context);
+      }
+    } else {
+      const SyntaxTreeNode& node = tree.Node(i);
+      for (const auto& rule : rules_) {
+        rule->HandleNode(node, context);
+        rule->HandleSymbol(node, context);
+      }
+      open_nodes.push_back(i);
+      context.Push(node);
+    }
+  }
 }
 
 std::vector<LintRuleStatus> SyntaxTreeLinter::ReportStatus() const {
@@ -54,6 +95,8 @@ void SyntaxTreeLinter::Visit(const SyntaxTreeLeaf& leaf) {
 // Second, linter recurses on every non-null child of that node in order
 // to visit the entire tree
 void SyntaxTreeLinter::Visit(const SyntaxTreeNode& node) {
+  // Skip the rest of the tree once the budget is exhausted.
+  if (budget_ != nullptr && budget_->Exhausted()) return;
   for (const auto& rule : rules_) {
     // Have rule handle the node as both a node and a symbol.
     ABSL_DIE_IF_NULL(rule)->HandleNode(node, Context());
@@ -27,9 +27,12 @@
 #include "common/analysis/syntax_tree_lint_rule.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
+#include "common/text/flat_tree.h"
+#include "common/text/identifier_table.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/tree_context_visitor.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 
@@ -59,16 +62,35 @@ class SyntaxTreeLinter : public TreeContextVisitor {
     rules_.emplace_back(std::move(rule));
   }
 
+  // Limits the time and memory spent in Lint().  Once 'budget' is exhausted,
+  // the rest of the tree is skipped.  'budget' (not owned) must outlive
+  // Lint(); nullptr means unlimited.
+  void SetBudget(ResourceBudget* budget) { budget_ = budget; }
+
+  // Shares 'table' (not owned) with all rules added so far.
+  void SetIdentifierTable(const LazyIdentifierTable* table) {
+    for (auto& rule : rules_) rule->SetIdentifierTable(table);
+  }
+
   // Aggregates results of each held LintRule
   std::vector<LintRuleStatus> ReportStatus() const;
 
   // Performs lint analysis on root
   void Lint(const Symbol& root);
 
+  // Performs lint analysis on a flattened tree.  Rules see the same symbols
+  // and contexts in the same order as with Lint(root), but the traversal is
+  // a loop over the flattened tree, without recursion.  Rules still receive
+  // the original nodes and leaves.
+  void Lint(const FlatSyntaxTree& tree);
+
  private:
   // List of rules that the linter is using. Rules are responsible for tracking
   // their own internal state.
   std::vector<std::unique_ptr<SyntaxTreeLintRule>> rules_;
+
+  // Limits analysis, if not null.
+  ResourceBudget* budget_ = nullptr;
 };
 
 }  // namespace verible
@@ -18,14 +18,19 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/syntax_tree_lint_rule.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
+#include "common/text/flat_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/token_info.h"
 #include "common/text/tree_builder_test_util.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 namespace {
@@ -275,5 +280,78 @@ TEST(SyntaxTreeLinterTest, DepthSuccess) {
   EXPECT_EQ(statuses[0].violations.size(), 0);
 }
 
+TEST(SyntaxTreeLinterTest, FlatTreeHeterogenousTests) {
+  constexpr absl::string_view text("abcde");
+  SymbolPtr root =
+      Node(Leaf(1, text.substr(0, 1)), Leaf(4, text.substr(1, 1)),
+           Node(Leaf(210, text.substr(2, 1)), Leaf(10, text.substr(3, 1))),
+           Leaf(1, text.substr(4, 1)));
+  SyntaxTreeLinter linter;
+  linter.AddRule(MakeAscending());
+  linter.AddRule(MakeRuleN(1));
+  ASSERT_NE(root.get(), nullptr);
+  const FlatSyntaxTree flat_tree(root.get());
+  linter.Lint(flat_tree);
+
+  std::vector<LintRuleStatus> statuses = linter.ReportStatus();
+  EXPECT_EQ(statuses.size(), 2);
+  EXPECT_FALSE(statuses[0].isOk());
+  EXPECT_EQ(statuses[0].violations.size(), 2);
+  EXPECT_FALSE(statuses[1].isOk());
+  EXPECT_EQ(statuses[1].violations.size(), 3);
+}
+
+TEST(SyntaxTreeLinterTest, FlatTreeDepth) {
+  constexpr absl::string_view text("abcde");
+  SymbolPtr root =
+      Node(Leaf(1, text.substr(0, 1)), Leaf(4, text.substr(1, 1)),
+           Node(Leaf(210, text.substr(2, 1)), nullptr,
+                Leaf(2, text.substr(3, 1))),
+           Leaf(1, text.substr(4, 1)));
+  SyntaxTreeLinter linter;
+  linter.AddRule(MakeDepth());
+  ASSERT_NE(root.get(), nullptr);
+  const FlatSyntaxTree flat_tree(root.get());
+  linter.Lint(flat_tree);
+
+  std::vector<LintRuleStatus> statuses = linter.ReportStatus();
+  EXPECT_EQ(statuses.size(), 1);
+  EXPECT_FALSE(statuses[0].isOk());
+  EXPECT_EQ(statuses[0].violations.size(), 2);
+}
+
+// Returns a budget that is already exhausted.
+std::unique_ptr<ResourceBudget> ExhaustedBudget() {
+  auto budget = absl::make_unique<ResourceBudget>(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  EXPECT_TRUE(budget->Exhausted());
+  return budget;
+}
+
+TEST(SyntaxTreeLinterTest, ExhaustedBudgetSkipsTree) {
+  SymbolPtr root = Node(XLeaf(2), XLeaf(2), Node(XLeaf(2)), XLeaf(3));
+  const auto budget = ExhaustedBudget();
+  SyntaxTreeLinter linter;
+  linter.AddRule(MakeRuleN(2));
+  linter.SetBudget(budget.get());
+  linter.Lint(*root);
+  const std::vector<LintRuleStatus> statuses = linter.ReportStatus();
+  ASSERT_EQ(statuses.size(), 1);
+  EXPECT_TRUE(statuses[0].violations.empty());
+}
+
+TEST(SyntaxTreeLinterTest, FlatTreeExhaustedBudgetSkipsTree) {
+  SymbolPtr root = Node(XLeaf(2), XLeaf(2), Node(XLeaf(2)), XLeaf(3));
+  const auto budget = ExhaustedBudget();
+  SyntaxTreeLinter linter;
+  linter.AddRule(MakeRuleN(2));
+  linter.SetBudget(budget.get());
+  const FlatSyntaxTree flat_tree(root.get());
+  linter.Lint(flat_tree);
+  const std::vector<LintRuleStatus> statuses = linter.ReportStatus();
+  ASSERT_EQ(statuses.size(), 1);
+  EXPECT_TRUE(statuses[0].violations.empty());
+}
+
 }  // namespace
 }  // namespace verible
@@ -41,7 +41,7 @@ class SyntaxTreeSearcher : public TreeContextVisitor {
       std::function<bool(const SyntaxTreeContext&)> context_predicate)
       : matcher_(m), context_predicate_(context_predicate) {}
 
-  void Search(const Symbol& root) { root.Accept(this); }
+  void Search(const Symbol& root) { Traverse(root); }
 
   const std::vector<TreeSearchMatch> Matches() const { return matches_; }
 
@@ -0,0 +1,105 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Measures SearchSyntaxTree() on a wide and deep tree in which most leaves
+// match, so that the cost of recording each match (including its context)
+// dominates, as in lint rules that collect all identifiers of a module.
+// It is measured without a context predicate, and with one that asks which
+// kind of enclosing node comes first, as many lint rules do.
+//
+// usage: syntax_tree_search_benchmark [runs]
+// Example:
+//   bazel run -c opt //common/analysis:syntax_tree_search_benchmark -- 20
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "common/analysis/matcher/matcher_builders.h"
+#include "common/analysis/syntax_tree_search.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/syntax_tree_context.h"
+#include "common/text/token_info.h"
+
+namespace verible {
+namespace {
+
+// Parser-generated languages have a few hundred node tags.
+constexpr int kNumNodeTags = 400;
+constexpr int kLeafTag = 1;
+
+// Returns a tree of the given depth, in which every node has 'fanout'
+// children.  Node tags vary with depth and position, across kNumNodeTags.
+SymbolPtr BuildTree(int depth, int fanout, int* counter) {
+  if (depth == 0) {
+    return SymbolPtr(new SyntaxTreeLeaf(TokenInfo(kLeafTag, "x")));
+  }
+  auto node = absl::make_unique<SyntaxTreeNode>(
+      (depth * 37 + (*counter)++ * 7) % kNumNodeTags);
+  for (int i = 0; i < fanout; ++i) {
+    node->AppendChild(BuildTree(depth - 1, fanout, counter));
+  }
+  return std::move(node);
+}
+
+void Measure(const char* name, const Symbol& tree,
+             const std::function<bool(const SyntaxTreeContext&)>& predicate,
+             int runs) {
+  const auto matcher =
+      matcher::TagMatchBuilder<SymbolKind::kLeaf, int, kLeafTag>()();
+  double best_seconds = 0;
+  size_t num_matches = 0;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    num_matches = SearchSyntaxTree(tree, matcher, predicate).size();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0) best_seconds = elapsed.count();
+    best_seconds = std::min(best_seconds, elapsed.count());
+  }
+  std::cout << name << ": " << num_matches << " matches, fastest of " << runs
+            << " runs: " << best_seconds * 1e3 << " ms" << std::endl;
+}
+
+int Run(int runs) {
+  int counter = 0;
+  const SymbolPtr tree = BuildTree(10, 3, &counter);
+  Measure(
+      "all leaves", *tree, [](const SyntaxTreeContext&) { return true; },
+      runs);
+  Measure(
+      "leaves by context", *tree,
+      [](const SyntaxTreeContext& context) {
+        return context.IsInsideFirst({11, 22, 33}, {44, 55, 66});
+      },
+      runs);
+  return 0;
+}
+
+}  // namespace
+}  // namespace verible
+
+int main(int argc, char** argv) {
+  const int runs = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 10;
+  return verible::Run(runs);
+}
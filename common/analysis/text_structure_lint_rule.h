@@ -43,6 +43,11 @@ class TextStructureLintRule : public LintRule {
   // Analyze text structure for violations.
   virtual void Lint(const TextStructureView& text_structure,
                     absl::string_view filename) = 0;
+
+  // Returns true if this rule examines the syntax tree.  Rules that only
+  // look at lines and tokens should override this to return false, so that
+  // parsing can be skipped when no active rule needs a syntax tree.
+  virtual bool NeedsSyntaxTree() const { return true; }
 };
 
 }  // namespace verible
@@ -25,6 +25,7 @@
 
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/token_stream_lint_rule.h"
+#include "common/text/identifier_table.h"
 #include "common/text/token_stream_view.h"
 
 namespace verible {
@@ -39,6 +40,11 @@ class TokenStreamLinter {
     rules_.emplace_back(std::move(rule));
   }
 
+  // Shares 'table' (not owned) with all rules added so far.
+  void SetIdentifierTable(const LazyIdentifierTable* table) {
+    for (auto& rule : rules_) rule->SetIdentifierTable(table);
+  }
+
   // Aggregates results of each held LintRule
   std::vector<LintRuleStatus> ReportStatus() const;
 
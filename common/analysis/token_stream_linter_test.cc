@@ -22,6 +22,7 @@
 #include "absl/strings/string_view.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/token_stream_lint_rule.h"
+#include "common/text/identifier_table.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
 
@@ -89,5 +90,66 @@ TEST(TokenStreamLinterTest, OneRuleRejectsTokenStream) {
   EXPECT_THAT(statuses[0].violations, SizeIs(1));
 }
 
+// Example lint rule that forbids names that are not lower_snake_case.
+class LowerSnakeCaseRule : public TokenStreamLintRule {
+ public:
+  void HandleToken(const TokenInfo& token) override {
+    if (token.token_enum != 1) return;
+    if (!(Identifiers().NamingStylesOf(token) &
+          IdentifierTable::kLowerSnakeCase)) {
+      violations_.insert(LintViolation(token, "bad name"));
+    }
+    if (Identifiers().Find(token) != IdentifierTable::kNotFound) ++interned_;
+  }
+
+  LintRuleStatus Report() const override { return LintRuleStatus(violations_); }
+
+  int interned_ = 0;
+
+ private:
+  std::set<LintViolation> violations_;
+};
+
+// This test verifies that rules see the identifier table given to the linter,
+// and give the same results without one.
+TEST(TokenStreamLinterTest, SharesIdentifierTable) {
+  const absl::string_view text("good Bad good");
+  const TokenSequence tokens = {
+      TokenInfo(1, text.substr(0, 4)), TokenInfo(1, text.substr(5, 3)),
+      TokenInfo(1, text.substr(9, 4)), TokenInfo::EOFToken()};
+  const LazyIdentifierTable table(
+      tokens, [](const TokenInfo& token) { return token.token_enum == 1; });
+  const LazyIdentifierTable* const tables[] = {&table, nullptr};
+  for (const LazyIdentifierTable* shared : tables) {
+    TokenStreamLinter linter;
+    auto* rule = new LowerSnakeCaseRule;
+    linter.AddRule(std::unique_ptr<TokenStreamLintRule>(rule));
+    linter.SetIdentifierTable(shared);
+    linter.Lint(tokens);
+    EXPECT_EQ(rule->interned_, shared != nullptr ? 3 : 0);
+    std::vector<LintRuleStatus> statuses = linter.ReportStatus();
+    ASSERT_THAT(statuses, SizeIs(1));
+    ASSERT_THAT(statuses[0].violations, SizeIs(1));
+    EXPECT_EQ(statuses[0].violations.begin()->token.text, "Bad");
+  }
+  EXPECT_TRUE(table.built());
+}
+
+// This test verifies that the identifier table is not built when no rule
+// looks up identifiers.
+TEST(TokenStreamLinterTest, IdentifierTableBuiltOnDemand) {
+  const absl::string_view text("good Bad good");
+  const TokenSequence tokens = {
+      TokenInfo(2, text.substr(0, 4)), TokenInfo(2, text.substr(5, 3)),
+      TokenInfo(2, text.substr(9, 4)), TokenInfo::EOFToken()};
+  const LazyIdentifierTable table(
+      tokens, [](const TokenInfo& token) { return token.token_enum == 2; });
+  TokenStreamLinter linter;
+  linter.AddRule(std::unique_ptr<TokenStreamLintRule>(new LowerSnakeCaseRule));
+  linter.SetIdentifierTable(&table);
+  linter.Lint(tokens);
+  EXPECT_FALSE(table.built());
+}
+
 }  // namespace
 }  // namespace verible
@@ -0,0 +1,135 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/formatting/flat_line_wrapper.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/formatting/basic_format_style.h"
+#include "common/formatting/format_token.h"
+#include "common/formatting/state_node.h"
+#include "common/formatting/unwrapped_line.h"
+#include "common/util/logging.h"
+
+namespace verible {
+
+bool IsFlatPartition(const UnwrappedLine& uwline) {
+  const auto tokens = uwline.TokensRange();
+  for (auto iter = tokens.begin(); iter != tokens.end(); ++iter) {
+    if (iter->before.break_decision == SpacingOptions::Preserve) return false;
+    // An open group only affects the wrap column of the tokens after it.
+    if (iter->balancing == GroupBalancing::Open && iter + 1 != tokens.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+// Cheapest wrapping of the tokens from some index to the end of the
+// partition, given that the token at that index starts a line.
+struct SuffixSolution {
+  // Penalty of wrapping the suffix, excluding the break before its first
+  // token.
+  int cost = 0;
+
+  // Column after the last token of the partition.
+  int final_column = 0;
+
+  // Index of the token that starts the next line, or the number of tokens if
+  // this is the last line.
+  size_t next_line = 0;
+
+  // Same order as StateNode::operator<() for complete solutions.
+  bool operator<(const SuffixSolution& r) const {
+    return cost < r.cost ||
+           (cost == r.cost && final_column < r.final_column);
+  }
+};
+}  // namespace
+
+FormattedExcerpt WrapFlatLine(const UnwrappedLine& uwline,
+                              const BasicFormatStyle& style, int* cost) {
+  CHECK(IsFlatPartition(uwline));
+  if (cost != nullptr) *cost = 0;
+  const auto tokens = uwline.TokensRange();
+  if (tokens.empty()) return FormattedExcerpt();
+  const size_t num_tokens = tokens.size();
+  const auto token_at = [&tokens](size_t i) -> const PreFormatToken& {
+    return *(tokens.begin() + i);
+  };
+
+  // Like StateNode: the first line starts at the indentation, and every
+  // wrapped line at the indentation plus wrap_spaces.
+  const int wrap_column = uwline.IndentationSpaces() + style.wrap_spaces;
+
+  // Solve every suffix, from right to left.
+  std::vector<SuffixSolution> best(num_tokens);
+  for (size_t start = num_tokens; start-- > 0;) {
+    SuffixSolution& solution = best[start];
+    bool found = false;
+    const auto consider = [&solution, &found](const SuffixSolution& candidate) {
+      if (!found || candidate < solution) solution = candidate;
+      found = true;
+    };
+
+    // Extend the line that starts at 'start' one token at a time.
+    int column = (start == 0 ? uwline.IndentationSpaces() : wrap_column) +
+                 token_at(start).Length();
+    int line_cost = 0;
+    for (size_t end = start + 1;; ++end) {
+      if (end == num_tokens) {
+        consider({line_cost, column, num_tokens});
+        break;
+      }
+      // Either break before token 'end', ...
+      const InterTokenInfo& before = token_at(end).before;
+      if (before.break_decision != SpacingOptions::MustAppend) {
+        consider({line_cost + before.break_penalty + best[end].cost,
+                  best[end].final_column, end});
+      }
+      if (before.break_decision == SpacingOptions::MustWrap) break;
+
+      // ... or append it to this line.
+      column += before.spaces_required + token_at(end).Length();
+      if (column > style.column_limit) {
+        line_cost +=
+            style.over_column_limit_penalty + column - style.column_limit;
+      }
+      // Longer lines only cost more, so they cannot be better.
+      if (found && line_cost > solution.cost) break;
+    }
+  }
+
+  // Replay the decisions through StateNode, to compute the spacing exactly
+  // like SearchLineWraps() does.
+  auto state = std::make_shared<const StateNode>(uwline, style);
+  size_t next_line = best.front().next_line;
+  for (size_t i = 1; i < num_tokens; ++i) {
+    const bool wrap = i == next_line;
+    if (wrap) next_line = best[i].next_line;
+    state = std::make_shared<const StateNode>(
+        state, style, wrap ? SpacingDecision::Wrap : SpacingDecision::Append);
+  }
+  CHECK_EQ(state->cumulative_cost, best.front().cost);
+
+  FormattedExcerpt result(uwline);
+  state->ReconstructFormatDecisions(&result);
+  if (cost != nullptr) *cost = state->cumulative_cost;
+  return result;
+}
+
+}  // namespace verible
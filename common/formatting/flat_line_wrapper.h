@@ -0,0 +1,52 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Line wrapping by dynamic programming, for partitions whose wrapped lines
+// always start at the same column.
+//
+// In general, SearchLineWraps() must explore a decision tree, because
+// balanced groups (parentheses, braces) make the column of every wrapped
+// line depend on earlier decisions.  Without open groups, every wrapped line
+// starts at the indentation plus wrap_spaces, so the cheapest way to wrap the
+// tokens after a line break does not depend on how the preceding tokens were
+// wrapped.  This is the classic line breaking problem (Knuth-Plass style):
+// the optimum for each suffix of the partition is computed once, from right
+// to left, using the same penalties as SearchLineWraps().
+
+#ifndef VERIBLE_COMMON_FORMATTING_FLAT_LINE_WRAPPER_H_
+#define VERIBLE_COMMON_FORMATTING_FLAT_LINE_WRAPPER_H_
+
+#include "common/formatting/basic_format_style.h"
+#include "common/formatting/format_token.h"
+#include "common/formatting/unwrapped_line.h"
+
+namespace verible {
+
+// Returns true if WrapFlatLine() applies to 'uwline': no token (except the
+// last) opens a balanced group, and no token preserves its original spacing.
+bool IsFlatPartition(const UnwrappedLine& uwline);
+
+// Returns an optimal wrapping of a flat partition (see IsFlatPartition()),
+// i.e. one with the same penalty as the result of SearchLineWraps().  Among
+// equally cheap wrappings, one that ends at the lowest column is chosen,
+// like SearchLineWraps() does.  If 'cost' is not null, it is set to the
+// penalty of the result.
+// This takes O(N*L) time for N tokens and about L tokens per line.
+FormattedExcerpt WrapFlatLine(const UnwrappedLine& uwline,
+                              const BasicFormatStyle& style,
+                              int* cost = nullptr);
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_FORMATTING_FLAT_LINE_WRAPPER_H_
@@ -0,0 +1,181 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/formatting/flat_line_wrapper.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/formatting/basic_format_style.h"
+#include "common/formatting/format_token.h"
+#include "common/formatting/line_wrap_searcher.h"
+#include "common/formatting/unwrapped_line.h"
+#include "common/formatting/unwrapped_line_test_utils.h"
+#include "common/text/token_info.h"
+
+namespace verible {
+namespace {
+
+class FlatLineWrapperTest : public UnwrappedLineMemoryHandler,
+                            public ::testing::Test {
+ public:
+  FlatLineWrapperTest() {
+    // Shorter column limit makes test case examples shorter.
+    style_.column_limit = 20;
+    style_.indentation_spaces = 3;
+    style_.wrap_spaces = 6;
+    style_.over_column_limit_penalty = 80;
+  }
+
+  // Returns a partition of the given tokens, indented one level, with one
+  // space required between tokens.
+  UnwrappedLine MakeLine(const std::vector<TokenInfo>& tokens) {
+    CreateTokenInfos(tokens);
+    UnwrappedLine uwline(style_.indentation_spaces,
+                         pre_format_tokens_.begin());
+    AddFormatTokens(&uwline);
+    for (auto& ftoken : pre_format_tokens_) {
+      ftoken.before.break_penalty = 1;
+      ftoken.before.spaces_required = 1;
+    }
+    return uwline;
+  }
+
+ protected:
+  BasicFormatStyle style_;
+};
+
+TEST_F(FlatLineWrapperTest, IsFlatPartition) {
+  const UnwrappedLine uwline =
+      MakeLine({{0, "f"}, {0, "("}, {0, "a"}, {0, ")"}, {0, "("}});
+  EXPECT_TRUE(IsFlatPartition(uwline));
+
+  // Closing groups that were never opened change nothing.
+  pre_format_tokens_[3].balancing = GroupBalancing::Close;
+  EXPECT_TRUE(IsFlatPartition(uwline));
+
+  // Opening a group at the very end changes nothing.
+  pre_format_tokens_[4].balancing = GroupBalancing::Open;
+  EXPECT_TRUE(IsFlatPartition(uwline));
+
+  pre_format_tokens_[1].balancing = GroupBalancing::Open;
+  EXPECT_FALSE(IsFlatPartition(uwline));
+  pre_format_tokens_[1].balancing = GroupBalancing::None;
+  EXPECT_TRUE(IsFlatPartition(uwline));
+
+  pre_format_tokens_[2].before.break_decision = SpacingOptions::Preserve;
+  EXPECT_FALSE(IsFlatPartition(uwline));
+}
+
+TEST_F(FlatLineWrapperTest, Empty) {
+  const UnwrappedLine uwline = MakeLine({});
+  int cost = -1;
+  const FormattedExcerpt result = WrapFlatLine(uwline, style_, &cost);
+  EXPECT_TRUE(result.Tokens().empty());
+  EXPECT_EQ(cost, 0);
+}
+
+TEST_F(FlatLineWrapperTest, FitsOnOneLine) {
+  const UnwrappedLine uwline = MakeLine({{0, "aaa"}, {0, "bbb"}, {0, "cc"}});
+  int cost = -1;
+  const FormattedExcerpt result = WrapFlatLine(uwline, style_, &cost);
+  EXPECT_EQ(cost, 0);
+  EXPECT_EQ(result.Render(), "   aaa bbb cc");
+}
+
+TEST_F(FlatLineWrapperTest, WrapsAtLimit) {
+  const UnwrappedLine uwline =
+      MakeLine({{0, "aaaaaa"}, {0, "bbbbbb"}, {0, "cccccc"}, {0, "dd"}});
+  int cost = -1;
+  const FormattedExcerpt result = WrapFlatLine(uwline, style_, &cost);
+  EXPECT_EQ(cost, 1);
+  EXPECT_EQ(result.Render(),
+            "   aaaaaa bbbbbb\n"
+            "         cccccc dd");
+}
+
+TEST_F(FlatLineWrapperTest, HonorsBreakDecisions) {
+  const UnwrappedLine uwline =
+      MakeLine({{0, "aaaa"}, {0, "bbbb"}, {0, "cccc"}, {0, "dd"}});
+  pre_format_tokens_[1].before.break_decision = SpacingOptions::MustWrap;
+  pre_format_tokens_[2].before.break_decision = SpacingOptions::MustAppend;
+  int cost = -1;
+  const FormattedExcerpt result = WrapFlatLine(uwline, style_, &cost);
+  EXPECT_EQ(cost, 2);
+  EXPECT_EQ(result.Render(),
+            "   aaaa\n"
+            "         bbbb cccc\n"  // would not fit with "dd"
+            "         dd");
+}
+
+// Differential test: on random flat partitions, dynamic programming must find
+// wrappings exactly as cheap as the exhaustive search.
+TEST(FlatLineWrapperDifferentialTest, SameCostAsSearch) {
+  BasicFormatStyle style;
+  style.column_limit = 30;
+  style.indentation_spaces = 2;
+  style.wrap_spaces = 4;
+  style.over_column_limit_penalty = 50;
+
+  std::mt19937 generator(1234);
+  const auto random_int = [&generator](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(generator);
+  };
+  constexpr int kTrials = 300;
+  for (int trial = 0; trial < kTrials; ++trial) {
+    const int num_tokens = random_int(1, 12);
+    std::vector<std::string> texts;
+    for (int i = 0; i < num_tokens; ++i) {
+      texts.push_back(std::string(random_int(1, 14), 'a' + i));
+    }
+    std::vector<TokenInfo> tokens;
+    for (const auto& text : texts) tokens.emplace_back(0, text);
+
+    UnwrappedLineMemoryHandler handler;
+    handler.CreateTokenInfos(tokens);
+    UnwrappedLine uwline(random_int(0, 3) * style.indentation_spaces,
+                         handler.GetPreFormatTokensBegin());
+    handler.AddFormatTokens(&uwline);
+    for (auto& ftoken : handler.pre_format_tokens_) {
+      ftoken.before.spaces_required = random_int(0, 2);
+      ftoken.before.break_penalty = random_int(0, 10);
+      const int decision = random_int(0, 9);
+      if (decision == 0) {
+        ftoken.before.break_decision = SpacingOptions::MustWrap;
+      } else if (decision == 1) {
+        ftoken.before.break_decision = SpacingOptions::MustAppend;
+      }
+      if (random_int(0, 9) == 0) ftoken.balancing = GroupBalancing::Close;
+    }
+    ASSERT_TRUE(IsFlatPartition(uwline));
+
+    int dp_cost = -1;
+    const FormattedExcerpt dp_result = WrapFlatLine(uwline, style, &dp_cost);
+    LineWrapSearchLimits limits;
+    LineWrapSearchStats search_stats;
+    const auto search_results =
+        SearchLineWraps(uwline, style, limits, &search_stats);
+    ASSERT_EQ(search_stats.outcome, LineWrapSearchStats::Outcome::kOptimal);
+    EXPECT_EQ(dp_cost, search_stats.cost)
+        << "trial " << trial << ", dynamic programming:\n"
+        << dp_result.Render() << "\nsearch:\n"
+        << search_results.front().Render();
+    EXPECT_EQ(dp_result.Tokens().size(), uwline.Size());
+  }
+}
+
+}  // namespace
+}  // namespace verible
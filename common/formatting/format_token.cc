@@ -141,6 +141,27 @@ std::ostream& FormattedToken::FormattedText(std::ostream& stream) const {
   return stream << token->text;
 }
 
+void FormattedToken::AppendFormattedText(std::string* output) const {
+  switch (before.action) {
+    case SpacingDecision::Preserve: {
+      if (before.preserved_space_start != nullptr) {
+        const absl::string_view original_spaces(OriginalLeadingSpaces());
+        output->append(original_spaces.data(), original_spaces.size());
+      } else {
+        output->append(before.spaces, ' ');
+      }
+      break;
+    }
+    case SpacingDecision::Wrap:
+      output->push_back('\n');
+      ABSL_FALLTHROUGH_INTENDED;
+    case SpacingDecision::Append:
+      output->append(before.spaces, ' ');
+      break;
+  }
+  output->append(token->text.data(), token->text.size());
+}
+
 std::ostream& operator<<(std::ostream& stream, const FormattedToken& token) {
   return token.FormattedText(stream);
 }
@@ -183,6 +183,10 @@ struct FormattedToken {
   // Print out formatted result after formatting decision optimization.
   std::ostream& FormattedText(std::ostream&) const;
 
+  // Same as FormattedText(), but appends directly to a string buffer,
+  // bypassing any stream formatting overhead.
+  void AppendFormattedText(std::string* output) const;
+
   // The token this PreFormatToken holds. TokenInfo must outlive this object.
   const TokenInfo* token = nullptr;
 
@@ -175,6 +175,37 @@ TEST(FormattedTokenTest, FormattedText) {
   }
 }
 
+// Test that AppendFormattedText appends the same text as FormattedText.
+TEST(FormattedTokenTest, AppendFormattedText) {
+  const absl::string_view text("ab  cd");
+  const TokenInfo tok1(1, text.substr(0, 2)), tok2(2, text.substr(4, 2));
+  const PreFormatToken p1(&tok1), p2(&tok2);
+  {
+    FormattedToken ft(p2);
+    ft.before.spaces = 1;
+    std::string buffer("x");
+    ft.AppendFormattedText(&buffer);
+    EXPECT_EQ(buffer, "x cd");
+  }
+  {
+    FormattedToken ft(p2);
+    ft.before.action = SpacingDecision::Wrap;
+    ft.before.spaces = 2;
+    std::string buffer;
+    ft.AppendFormattedText(&buffer);
+    EXPECT_EQ(buffer, "\n  cd");
+  }
+  {
+    FormattedToken ft1(p1), ft2(p2);
+    ft2.before.action = SpacingDecision::Preserve;
+    ft2.before.preserved_space_start = tok1.text.end();
+    std::string buffer;
+    ft1.AppendFormattedText(&buffer);
+    ft2.AppendFormattedText(&buffer);
+    EXPECT_EQ(buffer, text);
+  }
+}
+
 TEST(FormattedTokenTest, OriginalLeadingSpaces) {
   const absl::string_view text("abcdefgh");
   const TokenInfo tok1(1, text.substr(1, 3)), tok2(2, text.substr(5, 2));
@@ -14,17 +14,22 @@
 
 #include "common/formatting/line_wrap_searcher.h"
 
+#include <cstddef>
+#include <iostream>
 #include <memory>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "common/formatting/basic_format_style.h"
 #include "common/formatting/format_token.h"
 #include "common/formatting/state_node.h"
 #include "common/formatting/unwrapped_line.h"
 #include "common/text/token_info.h"
 #include "common/util/logging.h"
+#include "common/util/resource_budget.h"
 #include "common/util/spacer.h"
 
 namespace verible {
@@ -44,18 +49,57 @@ struct SearchState {
 };
 }  // namespace
 
-std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
-                                              const BasicFormatStyle& style,
-                                              int max_search_states) {
+// Number of unexplored partial solutions that are completed greedily (in
+// addition to the most advanced one) when a search is stopped early.
+static constexpr int kMaxFinishedCandidates = 8;
+
+// Returns the number of tokens that remain to be decided after 'state'.
+static size_t RemainingTokens(const StateNode& state) {
+  return state.undecided_path.end() - state.undecided_path.begin();
+}
+
+// Returns true if 'a' is a better candidate than 'b' to finish greedily when
+// a search is stopped early: it has decided more tokens, or as many tokens at
+// a lower penalty.
+static bool IsMoreAdvanced(const StateNode& a, const StateNode& b) {
+  const size_t a_remaining = RemainingTokens(a);
+  const size_t b_remaining = RemainingTokens(b);
+  return a_remaining < b_remaining || (a_remaining == b_remaining && a < b);
+}
+
+std::ostream& operator<<(std::ostream& stream,
+                         LineWrapSearchStats::Outcome outcome) {
+  switch (outcome) {
+    case LineWrapSearchStats::Outcome::kOptimal:
+      return stream << "optimal";
+    case LineWrapSearchStats::Outcome::kStateLimit:
+      return stream << "state limit";
+    case LineWrapSearchStats::Outcome::kTimeLimit:
+      return stream << "time limit";
+    case LineWrapSearchStats::Outcome::kBudgetExhausted:
+      return stream << "budget exhausted";
+  }
+  return stream << "???";
+}
+
+std::vector<FormattedExcerpt> SearchLineWraps(
+    const UnwrappedLine& uwline, const BasicFormatStyle& style,
+    const LineWrapSearchLimits& limits, LineWrapSearchStats* stats) {
   // Dijkstra's algorithm for now: prioritize searching minimum penalty path
   // until destination is reached.
 
   VLOG(2) << "SearchLineWraps on: " << uwline;
+  LineWrapSearchStats local_stats;
+  if (stats == nullptr) stats = &local_stats;
+  *stats = LineWrapSearchStats();
   if (uwline.TokensRange().empty()) {
     std::vector<FormattedExcerpt> result(1);
     return result;
   }
 
+  // The search's own deadline (unlimited by default).
+  ResourceBudget deadline(limits.time_limit, 0);
+
   // Worklist for decision searching, ordered by cumulative penalty.
   // Note: a heap-based priority-queue will not guarantee stable ordering
   // among equal-valued keys.  If first-come-first-serve tie-breaking is
@@ -66,6 +110,10 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
   SearchState seed(std::make_shared<StateNode>(uwline, style));
   worklist.push(seed);
 
+  // The partial solution that has decided the most tokens so far, which is
+  // often the best one to finish if the search is stopped early.
+  std::shared_ptr<const StateNode> most_advanced = seed.state;
+
   bool aborted_search = false;
   std::vector<std::shared_ptr<const StateNode>> winning_paths;
   int state_count = 0;
@@ -100,11 +148,37 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
       // Continue until all equally good solutions have been found.
       continue;
     }
+    if (IsMoreAdvanced(*next.state, *most_advanced)) most_advanced = next.state;
 
-    if (state_count >= max_search_states) {
-      // Search limit exceeded, abandon search.
-      // Greedily finish formatting this partition, and return it.
-      winning_paths.push_back(StateNode::QuickFinish(next.state, style));
+    if (state_count >= limits.max_search_states) {
+      stats->outcome = LineWrapSearchStats::Outcome::kStateLimit;
+    } else if (deadline.Exhausted()) {
+      stats->outcome = LineWrapSearchStats::Outcome::kTimeLimit;
+    } else if (limits.budget != nullptr && limits.budget->Exhausted()) {
+      stats->outcome = LineWrapSearchStats::Outcome::kBudgetExhausted;
+    }
+    if (stats->outcome != LineWrapSearchStats::Outcome::kOptimal) {
+      // Search limit reached, abandon search.
+      // An optimal solution that was already found is still optimal.
+      if (!winning_paths.empty()) {
+        stats->outcome = LineWrapSearchStats::Outcome::kOptimal;
+        break;
+      }
+      // Nothing cheaper than this state remains unexplored, because penalties
+      // only increase along a path.
+      stats->lower_bound = next.state->cumulative_cost;
+      // Greedily finish the most advanced and some of the cheapest partial
+      // solutions, and keep the best result.
+      std::shared_ptr<const StateNode> best =
+          StateNode::QuickFinish(most_advanced, style);
+      for (int i = 0; i < kMaxFinishedCandidates; ++i) {
+        auto finished = StateNode::QuickFinish(next.state, style);
+        if (*finished < *best) best = std::move(finished);
+        if (worklist.empty()) break;
+        next = worklist.top();
+        worklist.pop();
+      }
+      winning_paths.push_back(std::move(best));
       aborted_search = true;
       break;
     }
@@ -148,6 +222,11 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
   }  // while (!worklist.empty())
 
   CHECK_GE(winning_paths.size(), 1);
+  stats->explored_states = state_count;
+  stats->cost = winning_paths.front()->cumulative_cost;
+  if (!aborted_search) stats->lower_bound = stats->cost;
+  VLOG(2) << "search outcome: " << stats->outcome << ", cost: " << stats->cost
+          << ", lower bound: " << stats->lower_bound;
 
   // Reconstruct the unwrapped_line to reflect the decisions made to reach the
   // winning_paths.  Return a modified copy of the original UnwrappedLine.
@@ -165,6 +244,20 @@ std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
   return results;
 }
 
+std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
+                                              const BasicFormatStyle& style,
+                                              int max_search_states,
+                                              int* explored_states,
+                                              ResourceBudget* budget) {
+  LineWrapSearchLimits limits;
+  limits.max_search_states = max_search_states;
+  limits.budget = budget;
+  LineWrapSearchStats stats;
+  auto results = SearchLineWraps(uwline, style, limits, &stats);
+  if (explored_states != nullptr) *explored_states = stats.explored_states;
+  return results;
+}
+
 void DisplayEquallyOptimalWrappings(
     std::ostream& stream, const UnwrappedLine& uwline,
     const std::vector<FormattedExcerpt>& solutions) {
@@ -208,4 +301,46 @@ bool FitsOnLine(const UnwrappedLine& uwline, const BasicFormatStyle& style) {
   return true;
 }
 
+SingleLineWidth::SingleLineWidth(const UnwrappedLine& uwline) {
+  const auto tokens = uwline.TokensRange();
+  if (tokens.empty()) return;
+  first_token_ = &tokens.front();
+  width_ = first_token_->Length();
+  for (auto iter = tokens.begin() + 1; iter != tokens.end(); ++iter) {
+    multiple_tokens_ = true;
+    must_wrap_ |= iter->before.break_decision == SpacingOptions::MustWrap;
+    width_ += iter->before.spaces_required + iter->Length();
+  }
+}
+
+void SingleLineWidth::Append(const SingleLineWidth& next) {
+  if (next.first_token_ == nullptr) return;
+  if (first_token_ == nullptr) {
+    *this = next;
+    return;
+  }
+  const auto& before = next.first_token_->before;
+  multiple_tokens_ = true;
+  must_wrap_ |= before.break_decision == SpacingOptions::MustWrap ||
+                next.must_wrap_;
+  width_ += before.spaces_required + next.width_;
+}
+
+bool SingleLineWidth::Fits(const UnwrappedLine& uwline,
+                           const BasicFormatStyle& style) const {
+  // As in FitsOnLine(), the first token is placed without checking its
+  // break decision or the column limit.
+  if (!multiple_tokens_) return true;
+  if (must_wrap_) return false;
+  // Column positions only increase while appending, so checking the end of
+  // the line is the same as checking after every token.
+  // A first token that preserves its spacing starts at column 0 (see
+  // StateNode).
+  const int start_column =
+      first_token_->before.break_decision == SpacingOptions::Preserve
+          ? 0
+          : uwline.IndentationSpaces();
+  return start_column + width_ <= style.column_limit;
+}
+
 }  // namespace verible
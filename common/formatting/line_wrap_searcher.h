@@ -18,24 +18,80 @@
 #include <iosfwd>
 #include <vector>
 
+#include "absl/time/time.h"
 #include "common/formatting/basic_format_style.h"
+#include "common/formatting/format_token.h"
 #include "common/formatting/unwrapped_line.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 
+// Limits on the effort of one SearchLineWraps() call.
+struct LineWrapSearchLimits {
+  // Maximum number of search states to evaluate.
+  int max_search_states = 100000;
+
+  // Maximum wall-clock time of the search.  The clock is only read
+  // periodically, so the search may run slightly longer.
+  absl::Duration time_limit = absl::InfiniteDuration();
+
+  // If not null, a budget shared with other work (e.g. the rest of a file),
+  // which also stops the search once it is exhausted.
+  ResourceBudget* budget = nullptr;
+};
+
+// Describes the result of one SearchLineWraps() call.
+struct LineWrapSearchStats {
+  enum class Outcome {
+    kOptimal,          // Search completed.
+    kStateLimit,       // Reached max_search_states.
+    kTimeLimit,        // Reached time_limit.
+    kBudgetExhausted,  // The shared budget ran out.
+  };
+  Outcome outcome = Outcome::kOptimal;
+
+  // Number of search states evaluated.
+  int explored_states = 0;
+
+  // Penalty of the returned solution(s).
+  int cost = 0;
+
+  // Proven lower bound on the penalty of an optimal solution: the penalty of
+  // the cheapest unexplored partial solution.  Equals 'cost' when the search
+  // completed.
+  int lower_bound = 0;
+
+  // Returns by how much (at most) the returned penalty exceeds the optimum.
+  int OptimalityGap() const { return cost - lower_bound; }
+};
+
+std::ostream& operator<<(std::ostream&, LineWrapSearchStats::Outcome);
+
 // SearchLineWraps takes an UnwrappedLine with formatting annotations,
 // and a style structure, and returns equally-good FormattedExcerpts with
 // formatting decisions (wraps, spaces) committed.
 // This minimizes the numeric penalty during search to yield optimal results,
 // which can result in multiple optimal formattings.
-// max_search_states limits the size of the optimization search.
-// When the number of states evaluated exceeds this, this will abort by
-// returning a greedily formatted result (which can still be rendered)
-// that will be marked as !CompletedFormatting().
+//
+// This is an anytime search: when any of 'limits' is reached first, the
+// search stops, and returns the best solution it can complete from what it
+// has explored so far: the cheapest, and the most advanced, partial
+// solutions are each completed greedily, and the cheapest result wins.
+// Such a result is marked as !CompletedFormatting(), and 'stats' (if not
+// null) tells how far it may be from optimal.
 // This is guaranteed to return at least one result.
+std::vector<FormattedExcerpt> SearchLineWraps(
+    const UnwrappedLine& uwline, const BasicFormatStyle& style,
+    const LineWrapSearchLimits& limits, LineWrapSearchStats* stats = nullptr);
+
+// Same as above, limited to 'max_search_states' (and 'budget', if not null).
+// If 'explored_states' is non-null, it is set to the number of search states
+// that were evaluated.
 std::vector<FormattedExcerpt> SearchLineWraps(const UnwrappedLine& uwline,
                                               const BasicFormatStyle& style,
-                                              int max_search_states);
+                                              int max_search_states,
+                                              int* explored_states = nullptr,
+                                              ResourceBudget* budget = nullptr);
 
 // Diagnostic helper for displaying when multiple optimal wrappings are found
 // by SearchLineWraps.  This aids in development around wrap penalty tuning.
@@ -48,6 +104,42 @@ void DisplayEquallyOptimalWrappings(
 // true.
 bool FitsOnLine(const UnwrappedLine& uwline, const BasicFormatStyle& style);
 
+// SingleLineWidth measures a range of tokens as if they were all appended
+// onto one line, like FitsOnLine(), but can be composed from the measurements
+// of consecutive sub-ranges.  This lets a whole partition tree be measured
+// bottom-up, visiting each token once, instead of re-measuring every
+// ancestor's tokens with FitsOnLine().
+class SingleLineWidth {
+ public:
+  // Measurement of an empty range of tokens.
+  SingleLineWidth() = default;
+
+  // Measures the tokens of 'uwline' (ignoring its indentation).
+  explicit SingleLineWidth(const UnwrappedLine& uwline);
+
+  // Extends this measurement with that of the range of tokens that
+  // immediately follows this one.
+  void Append(const SingleLineWidth& next);
+
+  // Returns the same result as FitsOnLine(uwline, style), where this
+  // measures the tokens of 'uwline'.
+  bool Fits(const UnwrappedLine& uwline, const BasicFormatStyle& style) const;
+
+ private:
+  // First token of the range, or nullptr if the range is empty.
+  const PreFormatToken* first_token_ = nullptr;
+
+  // True if the range has more than one token.
+  bool multiple_tokens_ = false;
+
+  // True if any token after the first must start a new line.
+  bool must_wrap_ = false;
+
+  // Columns spanned by the tokens, from the start of the first token,
+  // including required spaces between tokens.
+  int width_ = 0;
+};
+
 }  // namespace verible
 
 #endif  // VERIBLE_COMMON_FORMATTING_LINE_WRAP_SEARCHER_H_
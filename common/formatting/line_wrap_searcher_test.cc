@@ -19,10 +19,13 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/match.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/formatting/basic_format_style.h"
 #include "common/formatting/format_token.h"
 #include "common/formatting/unwrapped_line.h"
 #include "common/formatting/unwrapped_line_test_utils.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 namespace {
@@ -392,6 +395,86 @@ TEST_F(SearchLineWrapsTestFixture, FitsOnLine) {
   EXPECT_FALSE(FitsOnLine(uwline_in, style_));
 }
 
+// Returns the measurement of the tokens of 'uwline', composed from the
+// measurements of the sub-ranges that start at each of 'splits'.
+SingleLineWidth ComposedWidth(const UnwrappedLine& uwline,
+                              const std::vector<int>& splits) {
+  const auto range = uwline.TokensRange();
+  SingleLineWidth width;
+  auto begin = range.begin();
+  for (const int split : splits) {
+    const auto end = range.begin() + split;
+    UnwrappedLine piece(uwline.IndentationSpaces(), begin);
+    piece.SpanUpToToken(end);
+    width.Append(SingleLineWidth(piece));
+    begin = end;
+  }
+  UnwrappedLine last_piece(uwline.IndentationSpaces(), begin);
+  last_piece.SpanUpToToken(range.end());
+  width.Append(SingleLineWidth(last_piece));
+  return width;
+}
+
+// Test that SingleLineWidth agrees with FitsOnLine, however it is composed.
+TEST_F(SearchLineWrapsTestFixture, SingleLineWidthSameAsFitsOnLine) {
+  const std::vector<TokenInfo> tokens = {
+      {0, "aaaaaa"},
+      {0, "bbbbb"},
+      {0, "ccccc"},
+      {0, "d"},
+  };
+  CreateTokenInfos(tokens);
+  UnwrappedLine uwline_in(LevelsToSpaces(0), pre_format_tokens_.begin());
+  AddFormatTokens(&uwline_in);
+  auto& ftokens_in = pre_format_tokens_;
+  const std::vector<std::vector<int>> splits = {
+      {}, {1}, {2}, {0, 2}, {1, 2, 3}, {2, 2, 4},
+  };
+  for (const int first_spaces : {1, 99}) {
+    ftokens_in[0].before.spaces_required = first_spaces;
+    for (int indentation = 0; indentation <= 6; ++indentation) {
+      uwline_in.SetIndentationSpaces(indentation);
+      for (int spaces = 0; spaces <= 2; ++spaces) {
+        ftokens_in[1].before.spaces_required = spaces;
+        ftokens_in[2].before.spaces_required = 1;
+        ftokens_in[3].before.spaces_required = spaces;
+        for (const auto first_decision :
+             {SpacingOptions::Undecided, SpacingOptions::MustWrap,
+              SpacingOptions::Preserve}) {
+          ftokens_in[0].before.break_decision = first_decision;
+          for (int must_wrap = 0; must_wrap <= 4; ++must_wrap) {
+            for (int i = 1; i < 4; ++i) {
+              ftokens_in[i].before.break_decision =
+                  (i == must_wrap) ? SpacingOptions::MustWrap
+                                   : SpacingOptions::Undecided;
+            }
+            const bool expected = FitsOnLine(uwline_in, style_);
+            for (const auto& split : splits) {
+              EXPECT_EQ(ComposedWidth(uwline_in, split).Fits(uwline_in, style_),
+                        expected)
+                  << "indentation: " << indentation << ", spaces: " << spaces
+                  << ", must_wrap: " << must_wrap
+                  << ", splits: " << split.size();
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Test that one-token and empty ranges always fit, like FitsOnLine.
+TEST_F(SearchLineWrapsTestFixture, SingleLineWidthOneToken) {
+  const std::vector<TokenInfo> tokens = {{0, "aaaaaaaaaaaaaaaaaaaaaaaaa"}};
+  CreateTokenInfos(tokens);
+  UnwrappedLine uwline_in(LevelsToSpaces(2), pre_format_tokens_.begin());
+  EXPECT_TRUE(SingleLineWidth().Fits(uwline_in, style_));
+  EXPECT_TRUE(FitsOnLine(uwline_in, style_));
+  AddFormatTokens(&uwline_in);
+  EXPECT_TRUE(SingleLineWidth(uwline_in).Fits(uwline_in, style_));
+  EXPECT_TRUE(FitsOnLine(uwline_in, style_));
+}
+
 // Test that aborted wrap search works returns a result marked as incomplete.
 TEST_F(SearchLineWrapsTestFixture, AbortedSearch) {
   const std::vector<TokenInfo> tokens = {
@@ -411,13 +494,113 @@ TEST_F(SearchLineWrapsTestFixture, AbortedSearch) {
   ftokens_in[2].before.break_penalty = 1;
   ftokens_in[2].before.spaces_required = 1;
   // Intentionally limit search space to a small count to force early abort.
-  const auto formatted_lines = verible::SearchLineWraps(uwline_in, style_, 2);
+  int explored_states = 0;
+  const auto formatted_lines =
+      verible::SearchLineWraps(uwline_in, style_, 2, &explored_states);
   const FormattedExcerpt& formatted_line = formatted_lines.front();
   EXPECT_EQ(formatted_line.Tokens().size(), tokens.size());
   EXPECT_FALSE(formatted_line.CompletedFormatting());
+  EXPECT_EQ(explored_states, 2);
   // The resulting state is unpredictable, because the search terminated early.
   // So we don't check any other properties of the formatted_line.
 }
 
+TEST_F(SearchLineWrapsTestFixture, ExhaustedBudget) {
+  const std::vector<TokenInfo> tokens = {
+      {0, "zz"},
+      {0, "yyy"},
+      {0, "xxxx"},
+  };
+  CreateTokenInfos(tokens);
+  UnwrappedLine uwline_in(LevelsToSpaces(1), pre_format_tokens_.begin());
+  AddFormatTokens(&uwline_in);
+  for (auto& ftoken : pre_format_tokens_) {
+    ftoken.before.break_penalty = 1;
+    ftoken.before.spaces_required = 1;
+  }
+  ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  int explored_states = 0;
+  const auto formatted_lines = verible::SearchLineWraps(
+      uwline_in, style_, 1000, &explored_states, &budget);
+  const FormattedExcerpt& formatted_line = formatted_lines.front();
+  EXPECT_EQ(formatted_line.Tokens().size(), tokens.size());
+  EXPECT_FALSE(formatted_line.CompletedFormatting());
+  EXPECT_EQ(explored_states, 1);
+}
+
+// Every stopped search must bracket the optimal penalty between its proven
+// lower bound and the penalty of the solution it returns.
+TEST_F(SearchLineWrapsTestFixture, AnytimeResultBracketsOptimum) {
+  const std::vector<TokenInfo> tokens = {
+      {0, "aaaa"}, {0, "bbbbbb"}, {0, "cc"},  {0, "ddddddd"},
+      {0, "eee"},  {0, "ffff"},   {0, "ggg"}, {0, "hhhhhhhh"},
+  };
+  CreateTokenInfos(tokens);
+  UnwrappedLine uwline_in(LevelsToSpaces(1), pre_format_tokens_.begin());
+  AddFormatTokens(&uwline_in);
+  for (auto& ftoken : pre_format_tokens_) {
+    ftoken.before.break_penalty = 2;
+    ftoken.before.spaces_required = 1;
+  }
+  LineWrapSearchLimits limits;
+  LineWrapSearchStats optimal;
+  const auto optimal_lines = verible::SearchLineWraps(
+      uwline_in, style_, limits, &optimal);
+  ASSERT_TRUE(optimal_lines.front().CompletedFormatting());
+  EXPECT_EQ(optimal.outcome, LineWrapSearchStats::Outcome::kOptimal);
+  EXPECT_EQ(optimal.OptimalityGap(), 0);
+
+  for (int max_states = 1; max_states < optimal.explored_states;
+       ++max_states) {
+    limits.max_search_states = max_states;
+    LineWrapSearchStats stats;
+    const auto lines =
+        verible::SearchLineWraps(uwline_in, style_, limits, &stats);
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines.front().Tokens().size(), tokens.size());
+    if (stats.outcome == LineWrapSearchStats::Outcome::kOptimal) {
+      // An optimal solution was found before the limit.
+      EXPECT_EQ(stats.cost, optimal.cost) << max_states;
+      continue;
+    }
+    EXPECT_EQ(stats.outcome, LineWrapSearchStats::Outcome::kStateLimit);
+    EXPECT_EQ(stats.explored_states, max_states);
+    EXPECT_FALSE(lines.front().CompletedFormatting());
+    EXPECT_LE(stats.lower_bound, optimal.cost) << max_states;
+    EXPECT_GE(stats.cost, optimal.cost) << max_states;
+    EXPECT_GE(stats.OptimalityGap(), 0);
+  }
+}
+
+TEST_F(SearchLineWrapsTestFixture, TimeLimit) {
+  const std::vector<TokenInfo> tokens = {
+      {0, "zz"},
+      {0, "yyy"},
+      {0, "xxxx"},
+  };
+  CreateTokenInfos(tokens);
+  UnwrappedLine uwline_in(LevelsToSpaces(1), pre_format_tokens_.begin());
+  AddFormatTokens(&uwline_in);
+  for (auto& ftoken : pre_format_tokens_) {
+    ftoken.before.break_penalty = 1;
+    ftoken.before.spaces_required = 1;
+  }
+  LineWrapSearchLimits limits;
+  limits.time_limit = absl::Nanoseconds(1);
+  LineWrapSearchStats stats;
+  const auto formatted_lines =
+      verible::SearchLineWraps(uwline_in, style_, limits, &stats);
+  const FormattedExcerpt& formatted_line = formatted_lines.front();
+  EXPECT_EQ(formatted_line.Tokens().size(), tokens.size());
+  EXPECT_FALSE(formatted_line.CompletedFormatting());
+  EXPECT_EQ(stats.outcome, LineWrapSearchStats::Outcome::kTimeLimit);
+  EXPECT_EQ(stats.explored_states, 1);
+  EXPECT_EQ(stats.lower_bound, 0);
+  // Everything fits on one line, which greedy completion finds.
+  EXPECT_EQ(stats.cost, 0);
+  EXPECT_EQ(formatted_line.Render(), "   zz yyy xxxx");
+}
+
 }  // namespace
 }  // namespace verible
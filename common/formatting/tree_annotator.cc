@@ -82,7 +82,7 @@ void TreeAnnotator::Annotate() {
   // Visit the tokens from the beginning of the token stream through
   // the last syntax tree node.
   if (syntax_tree_root_ != nullptr) {
-    syntax_tree_root_->Accept(this);
+    Traverse(*syntax_tree_root_);
   }
   // Else without a syntax tree, the following code will still annotate
   // over the sequence of format tokens with an empty context, which is
@@ -68,6 +68,9 @@ const TokenPartitionTree* TreeUnwrapper::Unwrap() {
   // Traverse the concrete syntax tree to build up token partitions.
   ABSL_DIE_IF_NULL(text_structure_view_.SyntaxTree())->Accept(this);
 
+  // Partitions are incomplete if the budget ran out during traversal.
+  if (budget_ != nullptr && !budget_->status().ok()) return nullptr;
+
   // After traversing the ConcreteSyntaxTree, collect possible tokens filtered
   // after the right-most leaf until the end-of-file.
   CollectTrailingFilteredTokens();
@@ -273,6 +276,7 @@ void TreeUnwrapper::TraverseChildren(const verible::SyntaxTreeNode& node) {
   const verible::SyntaxTreeContext::AutoPop p(&current_context_, node);
   InterChildNodeHook(node);
   for (const auto& child : node.children()) {
+    if (budget_ != nullptr && budget_->Exhausted()) return;
     if (child) {
       child->Accept(this);
       InterChildNodeHook(node);
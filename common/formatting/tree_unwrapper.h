@@ -28,6 +28,7 @@
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
 #include "common/text/tree_context_visitor.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 // Base class for building unwrapped lines. TreeUnwrapper is a concrete syntax
@@ -58,6 +59,12 @@ class TreeUnwrapper : public TreeContextVisitor {
   // TODO(fangism): rename this Partition.
   const TokenPartitionTree* Unwrap();
 
+  // Limits the time and memory spent in Unwrap().  Once 'budget' is
+  // exhausted, the remaining subtrees are skipped, and Unwrap() returns
+  // nullptr.  'budget' (not owned) must outlive Unwrap(); nullptr means
+  // unlimited.
+  void SetBudget(ResourceBudget* budget) { budget_ = budget; }
+
   // Returns a flattened copy of all of the deepest nodes in the tree of
   // unwrapped lines, which represents maximal partitioning into the smallest
   // partitions of format token ranges one might work with.
@@ -214,6 +221,9 @@ class TreeUnwrapper : public TreeContextVisitor {
   // No container is actually needed because popping the stack is a matter
   // of replacing this pointer with its Parent().
   TokenPartitionTree* active_unwrapped_lines_ = nullptr;
+
+  // Limits traversal, if not null.
+  ResourceBudget* budget_ = nullptr;
 };
 
 // Prints all of the unwrapped_lines_.  Used for diagnostics only.
@@ -22,6 +22,8 @@
 #include "gtest/gtest.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/formatting/format_token.h"
 #include "common/formatting/unwrapped_line.h"
 #include "common/text/concrete_syntax_leaf.h"
@@ -32,6 +34,7 @@
 #include "common/text/token_stream_view.h"
 #include "common/util/container_iterator_range.h"
 #include "common/util/range.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 
@@ -147,4 +150,16 @@ TEST(TreeUnwrapperTest, UnwrapNoLeaves) {
   EXPECT_TRUE(unwrapped_lines.empty());  // Blank line removed.
 }
 
+// Test that an exhausted budget stops TreeUnwrapper from descending into the
+// tree.
+TEST(TreeUnwrapperTest, ExhaustedBudgetSkipsSubtrees) {
+  std::unique_ptr<TextStructureView> view = MakeTextStructureViewHelloWorld();
+  FakeTreeUnwrapper tree_unwrapper(*view);
+  ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  tree_unwrapper.SetBudget(&budget);
+  EXPECT_EQ(tree_unwrapper.Unwrap(), nullptr);
+  EXPECT_TRUE(budget.Exhausted());
+}
+
 }  // namespace verible
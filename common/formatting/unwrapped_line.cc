@@ -139,15 +139,41 @@ std::ostream& FormattedExcerpt::FormattedText(std::ostream& stream) const {
   return stream;
 }
 
+void FormattedExcerpt::AppendFormattedText(std::string* output) const {
+  for (const auto& ftoken : tokens_) {
+    ftoken.AppendFormattedText(output);
+  }
+}
+
+void FormattedExcerpt::AppendLinePreserveLeadingNewlines(
+    std::string* output, bool is_first_line) const {
+  if (tokens_.empty()) return;
+
+  // Explicitly preserve newlines before first token in each line.
+  {
+    auto replaced_first_token(tokens_.front());  // copy, then modify
+    const auto original_spacing = replaced_first_token.OriginalLeadingSpaces();
+    replaced_first_token.before.action = SpacingDecision::Append;
+    output->append(PreservedNewlinesCount(original_spacing, is_first_line),
+                   '\n');
+    replaced_first_token.AppendFormattedText(output);
+  }
+
+  const auto remaining_tokens = make_range(tokens_.begin() + 1, tokens_.end());
+  for (const auto& ftoken : remaining_tokens) {
+    ftoken.AppendFormattedText(output);
+  }
+}
+
 std::ostream& operator<<(std::ostream& stream,
                          const FormattedExcerpt& excerpt) {
   return excerpt.FormattedText(stream);
 }
 
 std::string FormattedExcerpt::Render() const {
-  std::ostringstream stream;
-  FormattedText(stream);
-  return stream.str();
+  std::string output;
+  AppendFormattedText(&output);
+  return output;
 }
 
 }  // namespace verible
@@ -157,6 +157,13 @@ class FormattedExcerpt {
   // Prints formatted text.
   std::ostream& FormattedText(std::ostream&) const;
 
+  // String-buffer equivalents of FormattedText() and
+  // FormatLinePreserveLeadingNewlines(), for assembling large outputs
+  // in a single pre-sized buffer.
+  void AppendFormattedText(std::string* output) const;
+  void AppendLinePreserveLeadingNewlines(std::string* output,
+                                         bool is_first_line) const;
+
   // Returns formatted code as a string.
   std::string Render() const;
 
@@ -357,6 +357,39 @@ TEST_F(UnwrappedLineTest, FormattedTextPreserveNewlinesDropSpaces) {
   }
 }
 
+// Test that string-buffer rendering matches stream rendering.
+TEST_F(UnwrappedLineTest, AppendFormattedTextMatchesStream) {
+  const absl::string_view text("\n\naaa\n\nbbb   cc");
+  const std::vector<TokenInfo> tokens = {
+      {0, text.substr(2, 3)}, {1, text.substr(7, 3)}, {2, text.substr(13, 2)}};
+  CreateTokenInfosExternalStringBuffer(tokens);  // use 'text' buffer
+  UnwrappedLine uwline(2, pre_format_tokens_.begin());
+  AddFormatTokens(&uwline);
+  auto& ftokens = pre_format_tokens_;
+  ftokens[0].before.preserved_space_start = text.begin() + 0;
+  ftokens[0].before.break_decision = SpacingOptions::Preserve;
+  ftokens[1].before.preserved_space_start = text.begin() + 5;
+  ftokens[1].before.break_decision = SpacingOptions::Preserve;
+  FormattedExcerpt output(uwline);
+  output.MutableTokens()[2].before.action = SpacingDecision::Append;
+  output.MutableTokens()[2].before.spaces = 1;
+  {
+    std::ostringstream stream;
+    stream << output;
+    std::string buffer;
+    output.AppendFormattedText(&buffer);
+    EXPECT_EQ(buffer, stream.str());
+    EXPECT_EQ(buffer, output.Render());
+  }
+  for (bool is_first_line : {true, false}) {
+    std::ostringstream stream;
+    output.FormatLinePreserveLeadingNewlines(stream, is_first_line);
+    std::string buffer("prefix:");
+    output.AppendLinePreserveLeadingNewlines(&buffer, is_first_line);
+    EXPECT_EQ(buffer, "prefix:" + stream.str());
+  }
+}
+
 // Testing AsCode() with no tokens and no indentation
 TEST_F(UnwrappedLineTest, AsCodeEmptyNoIndent) {
   const std::vector<TokenInfo> tokens;
@@ -32,6 +32,7 @@
 #include "common/parser/parser_param.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/token_info.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 
 namespace verible {
@@ -40,13 +41,20 @@ namespace verible {
 template <int (*ParseFunc)(ParserParam*)>
 class BisonParserAdapter : public Parser {
  public:
-  explicit BisonParserAdapter(TokenGenerator* token_generator)
-      : Parser(), param_(token_generator) {}
+  // If 'budget' is not null, Parse() stops early once it is exhausted.
+  explicit BisonParserAdapter(TokenGenerator* token_generator,
+                              ResourceBudget* budget = nullptr)
+      : Parser(), param_(token_generator, budget) {}
 
   util::Status Parse() override {
     int result = ParseFunc(&param_);
     // Results of parsing are stored in param_.
     VLOG(3) << "max_used_stack_size : " << MaxUsedStackSize();
+    if (param_.BudgetExhausted()) {
+      // The tree is incomplete, and any syntax errors are artifacts of
+      // stopping early.
+      return param_.BudgetStatus();
+    }
     if (result == 0 && param_.RecoveredSyntaxErrors().empty()) {
       return util::OkStatus();
     } else {
@@ -20,6 +20,8 @@
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/lexer/lexer.h"
 #include "common/lexer/token_stream_adapter.h"
 #include "common/parser/parser_param.h"
@@ -27,6 +29,8 @@
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/token_info.h"
+#include "common/util/resource_budget.h"
+#include "common/util/status.h"
 
 namespace verible {
 namespace {
@@ -67,5 +71,31 @@ TEST(BisonParserCommonTest, LexTest) {
   EXPECT_EQ(tref.text, "foo");
 }
 
+// Test that Lex ends the token stream once the budget is exhausted.
+TEST(BisonParserCommonTest, LexStopsWhenBudgetExhausted) {
+  MockLexer lexer;
+  auto generator = MakeTokenGenerator(&lexer);
+  ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  ParserParam parser_param(&generator, &budget);
+  SymbolPtr value;
+  EXPECT_EQ(verible::LexAdapter(&value, &parser_param), TK_EOF);
+  EXPECT_TRUE(parser_param.GetLastToken().isEOF());
+  EXPECT_TRUE(parser_param.BudgetExhausted());
+  EXPECT_EQ(parser_param.BudgetStatus().code(),
+            util::StatusCode::kDeadlineExceeded);
+}
+
+TEST(BisonParserCommonTest, LexWithinBudget) {
+  MockLexer lexer;
+  auto generator = MakeTokenGenerator(&lexer);
+  ResourceBudget budget;
+  ParserParam parser_param(&generator, &budget);
+  SymbolPtr value;
+  EXPECT_EQ(verible::LexAdapter(&value, &parser_param), 13);
+  EXPECT_FALSE(parser_param.BudgetExhausted());
+  EXPECT_TRUE(parser_param.BudgetStatus().ok());
+}
+
 }  // namespace
 }  // namespace verible
@@ -26,11 +26,14 @@
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/token_info.h"
 #include "common/util/logging.h"
+#include "common/util/resource_budget.h"
 
 namespace verible {
 
-ParserParam::ParserParam(TokenGenerator* token_stream)
+ParserParam::ParserParam(TokenGenerator* token_stream,
+                         ResourceBudget* budget)
     : token_stream_(token_stream),
+      budget_(budget),
       last_token_(TokenInfo::EOFToken()),
       root_(),
       state_stack_(),
@@ -40,7 +43,11 @@ ParserParam::ParserParam(TokenGenerator* token_stream)
 ParserParam::~ParserParam() {}
 
 const TokenInfo& ParserParam::FetchToken() {
-  last_token_ = (*token_stream_)();
+  if (!budget_exhausted_ && budget_ != nullptr && budget_->Exhausted()) {
+    VLOG(1) << "parsing stopped: " << budget_->status();
+    budget_exhausted_ = true;
+  }
+  last_token_ = budget_exhausted_ ? TokenInfo::EOFToken() : (*token_stream_)();
   return last_token_;
 }
 
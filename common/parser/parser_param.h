@@ -27,6 +27,8 @@
 #include "common/lexer/token_generator.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/token_info.h"
+#include "common/util/resource_budget.h"
+#include "common/util/status.h"
 
 namespace verible {
 
@@ -40,12 +42,24 @@ class ParserParam {
   using ValueStack = std::vector<SymbolPtr>;
 
  public:
-  explicit ParserParam(TokenGenerator* token_stream);
+  // If 'budget' is not null, parsing stops once it is exhausted.
+  explicit ParserParam(TokenGenerator* token_stream,
+                       ResourceBudget* budget = nullptr);
 
   ~ParserParam();
 
+  // Returns the next token from the stream, or EOF once the budget is
+  // exhausted, which ends parsing (even during error recovery).
   const TokenInfo& FetchToken();
 
+  // Returns true if parsing was cut short by the budget.
+  bool BudgetExhausted() const { return budget_exhausted_; }
+
+  // Status of the budget (OK if there is none).
+  util::Status BudgetStatus() const {
+    return budget_ != nullptr ? budget_->status() : util::OkStatus();
+  }
+
   const TokenInfo& GetLastToken() const { return last_token_; }
 
   // Save a copy of the offending token before bison error-recovery
@@ -82,6 +96,8 @@ class ParserParam {
   std::vector<TokenInfo> recovered_syntax_errors_;
 
   TokenGenerator* token_stream_;
+  ResourceBudget* const budget_;
+  bool budget_exhausted_ = false;
   TokenInfo last_token_;
   ConcreteSyntaxTree root_;
 
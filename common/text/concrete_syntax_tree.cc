@@ -64,11 +64,45 @@ const SymbolPtr& SyntaxTreeNode::operator[](const size_t i) const {
   return children_[i];
 }
 
-// visits self, then forwards visitor to every child
+SyntaxTreeNode::~SyntaxTreeNode() {
+  // Detach descendants into a worklist, so that each node is destroyed
+  // without children, instead of recursively destroying its subtree.
+  std::vector<SymbolPtr> worklist;
+  for (auto& child : children_) {
+    if (child != nullptr) worklist.push_back(std::move(child));
+  }
+  while (!worklist.empty()) {
+    SymbolPtr symbol(std::move(worklist.back()));
+    worklist.pop_back();
+    if (symbol->Kind() != SymbolKind::kNode) continue;  // destroys leaf
+    auto& children = down_cast<SyntaxTreeNode*>(symbol.get())->children_;
+    for (auto& child : children) {
+      if (child != nullptr) worklist.push_back(std::move(child));
+    }
+  }  // each detached node is destroyed with only null children
+}
+
+// visits self, then every descendant, in preorder
 void SyntaxTreeNode::Accept(TreeVisitorRecursive* visitor) const {
   visitor->Visit(*this);
-  for (auto& child : children_) {
-    if (child != nullptr) child->Accept(visitor);
+  // Symbols yet to be visited, with the next one at the back.
+  std::vector<const Symbol*> pending;
+  for (auto iter = children_.rbegin(); iter != children_.rend(); ++iter) {
+    if (*iter != nullptr) pending.push_back(iter->get());
+  }
+  while (!pending.empty()) {
+    const Symbol* symbol = pending.back();
+    pending.pop_back();
+    if (symbol->Kind() != SymbolKind::kNode) {
+      symbol->Accept(visitor);  // leaf
+      continue;
+    }
+    const auto& node = *down_cast<const SyntaxTreeNode*>(symbol);
+    visitor->Visit(node);
+    const auto& children = node.children_;
+    for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+      if (*iter != nullptr) pending.push_back(iter->get());
+    }
   }
 }
 
@@ -76,8 +110,26 @@ void SyntaxTreeNode::Accept(MutableTreeVisitorRecursive* visitor,
                             SymbolPtr* this_owned) {
   CHECK_EQ(ABSL_DIE_IF_NULL(this_owned)->get(), this);
   visitor->Visit(*this, this_owned);
-  for (auto& child : children_) {
-    if (child != nullptr) child->Accept(visitor, &child);
+  // Owners of the symbols yet to be visited, with the next one at the back.
+  // A visit may replace the symbol in its owner, but not its siblings.
+  std::vector<SymbolPtr*> pending;
+  for (auto iter = children_.rbegin(); iter != children_.rend(); ++iter) {
+    if (*iter != nullptr) pending.push_back(&*iter);
+  }
+  while (!pending.empty()) {
+    SymbolPtr* owner = pending.back();
+    pending.pop_back();
+    if (*owner == nullptr) continue;
+    if ((*owner)->Kind() != SymbolKind::kNode) {
+      (*owner)->Accept(visitor, owner);  // leaf
+      continue;
+    }
+    visitor->Visit(*down_cast<const SyntaxTreeNode*>(owner->get()), owner);
+    if (*owner == nullptr || (*owner)->Kind() != SymbolKind::kNode) continue;
+    auto& children = down_cast<SyntaxTreeNode*>(owner->get())->children_;
+    for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+      if (*iter != nullptr) pending.push_back(&*iter);
+    }
   }
 }
 
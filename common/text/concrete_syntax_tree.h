@@ -74,6 +74,10 @@ class SyntaxTreeNode : public Symbol {
  public:
   explicit SyntaxTreeNode(const int tag = kUntagged) : tag_(tag), children_() {}
 
+  // Destroys the subtree without recursion, so that very deep trees do not
+  // overflow the call stack.
+  ~SyntaxTreeNode() override;
+
   const std::vector<SymbolPtr>& children() const { return children_; }
   std::vector<SymbolPtr>& mutable_children() { return children_; }
 
@@ -128,8 +132,9 @@ class SyntaxTreeNode : public Symbol {
   bool equals(const SyntaxTreeNode* node,
               const TokenComparator& compare_tokens) const;
 
-  // Uses passed TreeVisitorRecursive to visit all children recursively,
-  // then visit itself.
+  // Uses passed TreeVisitorRecursive to visit itself, then all of its
+  // descendants in preorder.  Traversal uses an explicit stack instead of
+  // recursion, so it is not limited by the depth of the tree.
   void Accept(TreeVisitorRecursive* visitor) const override;
   void Accept(MutableTreeVisitorRecursive* visitor,
               SymbolPtr* this_owned) override;
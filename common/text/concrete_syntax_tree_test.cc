@@ -16,8 +16,10 @@
 
 #include "common/text/concrete_syntax_tree.h"
 
+#include <cstddef>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -25,12 +27,14 @@
 #include "common/text/symbol.h"
 #include "common/text/tree_builder_test_util.h"
 #include "common/text/tree_compare.h"
+#include "common/text/visitors.h"
 #include "common/util/logging.h"
 
 namespace verible {
 
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::IsNull;
 using ::testing::NotNull;
@@ -390,5 +394,72 @@ TEST(NodeSubscriptTest, ConstReference) {
   EXPECT_EQ(example_node[1]->Tag().tag, 9);
 }
 
+// Records the tags of visited symbols.
+class TagRecorder : public TreeVisitorRecursive {
+ public:
+  void Visit(const SyntaxTreeLeaf& leaf) override {
+    tags.push_back(leaf.Tag().tag);
+  }
+  void Visit(const SyntaxTreeNode& node) override {
+    tags.push_back(node.Tag().tag);
+  }
+
+  std::vector<int> tags;
+};
+
+TEST(SyntaxTreeNodeAcceptTest, Preorder) {
+  const auto tree = TNode(1, TNode(2, XLeaf(3), nullptr, TNode(4)), XLeaf(5));
+  TagRecorder recorder;
+  tree->Accept(&recorder);
+  EXPECT_THAT(recorder.tags, ElementsAre(1, 2, 3, 4, 5));
+}
+
+// Replaces every leaf with a leaf of a different enum.
+class LeafReplacer : public MutableTreeVisitorRecursive {
+ public:
+  void Visit(const SyntaxTreeLeaf& leaf, SymbolPtr* owner) override {
+    *owner = XLeaf(leaf.Tag().tag + 100);
+  }
+  void Visit(const SyntaxTreeNode&, SymbolPtr*) override {}
+};
+
+TEST(SyntaxTreeNodeAcceptTest, MutableVisitorReplacesLeaves) {
+  auto tree = TNode(1, TNode(2, XLeaf(3), nullptr), XLeaf(5));
+  LeafReplacer replacer;
+  tree->Accept(&replacer, &tree);
+  const auto expected = TNode(1, TNode(2, XLeaf(103), nullptr), XLeaf(105));
+  EXPECT_TRUE(EqualTreesByEnum(expected.get(), tree.get()));
+}
+
+// Depth at which recursive traversal or destruction would overflow the
+// stack.
+constexpr size_t kDeepTreeDepth = 100000;
+
+TEST(DeepTreeTest, Destroy) {
+  auto tree = NestedNodes(kDeepTreeDepth, XLeaf(1));
+  tree = nullptr;  // must not overflow the stack
+  EXPECT_THAT(tree, IsNull());
+}
+
+TEST(DeepTreeTest, Accept) {
+  const auto tree = NestedNodes(kDeepTreeDepth, XLeaf(-1));
+  TagRecorder recorder;
+  tree->Accept(&recorder);
+  ASSERT_THAT(recorder.tags, SizeIs(kDeepTreeDepth + 1));
+  EXPECT_EQ(recorder.tags.front(), 0);
+  EXPECT_EQ(recorder.tags[kDeepTreeDepth - 1],
+            static_cast<int>(kDeepTreeDepth - 1));
+  EXPECT_EQ(recorder.tags.back(), -1);
+}
+
+TEST(DeepTreeTest, AcceptMutable) {
+  auto tree = NestedNodes(kDeepTreeDepth, XLeaf(1));
+  LeafReplacer replacer;
+  tree->Accept(&replacer, &tree);
+  TagRecorder recorder;
+  tree->Accept(&recorder);
+  EXPECT_EQ(recorder.tags.back(), 101);
+}
+
 }  // namespace
 }  // namespace verible
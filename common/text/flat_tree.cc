@@ -0,0 +1,123 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/flat_tree.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/util/casts.h"
+#include "common/util/logging.h"
+
+namespace verible {
+
+constexpr FlatSyntaxTree::index_type FlatSyntaxTree::kNone;
+
+FlatSyntaxTree::FlatSyntaxTree(const Symbol* root) {
+  if (root == nullptr) return;
+
+  // Symbols yet to be numbered, with their parent index and child position.
+  // Children are pushed in reverse, so that they are popped in order.
+  struct PendingSymbol {
+    const Symbol* symbol;
+    index_type parent;
+    index_type child_position;
+  };
+  std::vector<PendingSymbol> pending{{root, kNone, 0}};
+  // Nodes whose subtrees have not been completely numbered yet.
+  std::vector<index_type> open_nodes;
+
+  while (!pending.empty()) {
+    const PendingSymbol current = pending.back();
+    pending.pop_back();
+    const index_type index = size();
+    CHECK_LT(index, kNone) << "Tree is too large to flatten.";
+
+    // Symbols are numbered in preorder, so every open node that is not the
+    // parent (or an ancestor of it) has ended.
+    while (!open_nodes.empty() && open_nodes.back() != current.parent) {
+      subtree_ends_[open_nodes.back()] = index;
+      open_nodes.pop_back();
+    }
+
+    parents_.push_back(current.parent);
+    subtree_ends_.push_back(index + 1);
+    child_positions_.push_back(current.child_position);
+    symbols_.push_back(current.symbol);
+    if (current.symbol->Kind() == SymbolKind::kLeaf) {
+      const auto& leaf = *down_cast<const SyntaxTreeLeaf*>(current.symbol);
+      tags_.push_back(leaf.get().token_enum);
+      token_indices_.push_back(num_leaves_++);
+    } else {
+      const auto& node = *down_cast<const SyntaxTreeNode*>(current.symbol);
+      tags_.push_back(node.Tag().tag);
+      token_indices_.push_back(kNone);
+      open_nodes.push_back(index);
+      const auto& children = node.children();
+      for (size_t position = children.size(); position-- > 0;) {
+        if (children[position] == nullptr) continue;
+        pending.push_back({children[position].get(), index,
+                           static_cast<index_type>(position)});
+      }
+    }
+  }
+  for (const index_type node : open_nodes) {
+    subtree_ends_[node] = size();
+  }
+}
+
+size_t FlatSyntaxTree::Depth(index_type i) const {
+  size_t depth = 0;
+  for (index_type parent = parents_[i]; parent != kNone;
+       parent = parents_[parent]) {
+    ++depth;
+  }
+  return depth;
+}
+
+std::vector<FlatSyntaxTree::index_type> FlatSyntaxTree::FindNodesWithTag(
+    int tag) const {
+  std::vector<index_type> matches;
+  for (index_type i = 0; i < size(); ++i) {
+    if (tags_[i] == tag && !IsLeaf(i)) matches.push_back(i);
+  }
+  return matches;
+}
+
+void FlatSyntaxTree::Accept(FlatTreeVisitor* visitor) const {
+  std::vector<index_type> ancestors;
+  for (index_type i = 0; i < size(); ++i) {
+    while (!ancestors.empty() && subtree_ends_[ancestors.back()] <= i) {
+      const index_type node = ancestors.back();
+      ancestors.pop_back();
+      visitor->LeaveNode(*this, node, ancestors);
+    }
+    if (IsLeaf(i)) {
+      visitor->VisitLeaf(*this, i, ancestors);
+    } else {
+      visitor->VisitNode(*this, i, ancestors);
+      ancestors.push_back(i);
+    }
+  }
+  while (!ancestors.empty()) {
+    const index_type node = ancestors.back();
+    ancestors.pop_back();
+    visitor->LeaveNode(*this, node, ancestors);
+  }
+}
+
+}  // namespace verible
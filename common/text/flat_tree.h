@@ -0,0 +1,155 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// FlatSyntaxTree is an immutable, flattened copy of the structure of a
+// ConcreteSyntaxTree, for read-only analyses.
+//
+// Symbols are numbered in preorder, and the tags and tree structure (parents,
+// subtree ranges) are stored in arrays indexed by symbol.  Subtrees are
+// contiguous ranges of indices, so traversals are plain loops, without
+// recursion.  Symbols and tokens are not copied: they are accessed through
+// the original nodes and leaves.
+//
+// Null children of the original tree are omitted.  The original tree must
+// outlive the FlatSyntaxTree and must not be modified while it is in use.
+
+#ifndef VERIBLE_COMMON_TEXT_FLAT_TREE_H_
+#define VERIBLE_COMMON_TEXT_FLAT_TREE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/token_info.h"
+#include "common/util/casts.h"
+
+namespace verible {
+
+class FlatTreeVisitor;
+
+class FlatSyntaxTree {
+ public:
+  // Preorder index of a symbol.
+  using index_type = uint32_t;
+
+  // Parent of the root, and result of FirstChild()/NextSibling() when there
+  // is no such symbol.
+  static constexpr index_type kNone = ~index_type(0);
+
+  // Flattens the tree rooted at 'root' (which may be null, for an empty tree).
+  explicit FlatSyntaxTree(const Symbol* root);
+
+  FlatSyntaxTree(const FlatSyntaxTree&) = delete;
+  FlatSyntaxTree& operator=(const FlatSyntaxTree&) = delete;
+
+  // Number of symbols (nodes and leaves) in the tree.
+  index_type size() const { return tags_.size(); }
+  bool empty() const { return tags_.empty(); }
+
+  bool IsLeaf(index_type i) const { return token_indices_[i] != kNone; }
+
+  // Node enum of a node, or token enum of a leaf.
+  int Tag(index_type i) const { return tags_[i]; }
+
+  SymbolTag FullTag(index_type i) const {
+    return {IsLeaf(i) ? SymbolKind::kLeaf : SymbolKind::kNode, tags_[i]};
+  }
+
+  // Index of the parent node, or kNone for the root.
+  index_type Parent(index_type i) const { return parents_[i]; }
+
+  // One past the index of the last symbol in the subtree rooted at 'i'.
+  // The subtree occupies indices [i, SubtreeEnd(i)).
+  index_type SubtreeEnd(index_type i) const { return subtree_ends_[i]; }
+
+  // Position of this symbol among its parent's children in the original tree
+  // (counting null children).
+  index_type ChildPosition(index_type i) const { return child_positions_[i]; }
+
+  // Index of the first (non-null) child, or kNone.
+  index_type FirstChild(index_type i) const {
+    return (i + 1 < subtree_ends_[i]) ? i + 1 : kNone;
+  }
+
+  // Index of the next (non-null) sibling, or kNone.
+  index_type NextSibling(index_type i) const {
+    const index_type parent = parents_[i];
+    if (parent == kNone) return kNone;
+    const index_type next = subtree_ends_[i];
+    return next < subtree_ends_[parent] ? next : kNone;
+  }
+
+  // Number of ancestors of this symbol (0 for the root).
+  size_t Depth(index_type i) const;
+
+  // Position of a leaf among all leaves, left to right, or kNone for a node.
+  index_type TokenIndex(index_type i) const { return token_indices_[i]; }
+
+  // Number of leaves in the tree.
+  index_type NumLeaves() const { return num_leaves_; }
+
+  // Token of a leaf.
+  const TokenInfo& Token(index_type i) const { return Leaf(i).get(); }
+
+  // The original symbol, node, or leaf at index 'i'.
+  const Symbol& GetSymbol(index_type i) const { return *symbols_[i]; }
+  const SyntaxTreeNode& Node(index_type i) const {
+    return *down_cast<const SyntaxTreeNode*>(symbols_[i]);
+  }
+  const SyntaxTreeLeaf& Leaf(index_type i) const {
+    return *down_cast<const SyntaxTreeLeaf*>(symbols_[i]);
+  }
+
+  // Returns the indices of all nodes with the given tag, in preorder.
+  std::vector<index_type> FindNodesWithTag(int tag) const;
+
+  // Traverses the tree in preorder, without recursion.
+  void Accept(FlatTreeVisitor* visitor) const;
+
+ private:
+  std::vector<int> tags_;
+  std::vector<index_type> parents_;
+  std::vector<index_type> subtree_ends_;
+  std::vector<index_type> child_positions_;
+  std::vector<index_type> token_indices_;
+  std::vector<const Symbol*> symbols_;
+  index_type num_leaves_ = 0;
+};
+
+// FlatTreeVisitor receives the symbols of a FlatSyntaxTree in preorder.
+// 'ancestors' holds the indices of the nodes that enclose the current symbol,
+// root first, and is only valid for the duration of the call.
+class FlatTreeVisitor {
+ public:
+  using index_type = FlatSyntaxTree::index_type;
+
+  virtual ~FlatTreeVisitor() = default;
+
+  virtual void VisitNode(const FlatSyntaxTree& tree, index_type node,
+                         const std::vector<index_type>& ancestors) {}
+
+  virtual void VisitLeaf(const FlatSyntaxTree& tree, index_type leaf,
+                         const std::vector<index_type>& ancestors) {}
+
+  // Called after all descendants of 'node' have been visited.
+  virtual void LeaveNode(const FlatSyntaxTree& tree, index_type node,
+                         const std::vector<index_type>& ancestors) {}
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_TEXT_FLAT_TREE_H_
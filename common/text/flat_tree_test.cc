@@ -0,0 +1,181 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/flat_tree.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/tree_builder_test_util.h"
+#include "common/util/casts.h"
+
+namespace verible {
+namespace {
+
+using index_type = FlatSyntaxTree::index_type;
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+constexpr index_type kNone = FlatSyntaxTree::kNone;
+
+TEST(FlatSyntaxTreeTest, Null) {
+  const FlatSyntaxTree tree(nullptr);
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.size(), 0);
+  EXPECT_EQ(tree.NumLeaves(), 0);
+}
+
+TEST(FlatSyntaxTreeTest, SingleLeaf) {
+  const SymbolPtr root = Leaf(5, "x");
+  const FlatSyntaxTree tree(root.get());
+  ASSERT_EQ(tree.size(), 1);
+  EXPECT_TRUE(tree.IsLeaf(0));
+  EXPECT_EQ(tree.Tag(0), 5);
+  EXPECT_EQ(tree.Parent(0), kNone);
+  EXPECT_EQ(tree.SubtreeEnd(0), 1);
+  EXPECT_EQ(tree.FirstChild(0), kNone);
+  EXPECT_EQ(tree.NextSibling(0), kNone);
+  EXPECT_EQ(tree.Token(0).text, "x");
+  EXPECT_EQ(&tree.GetSymbol(0), root.get());
+}
+
+TEST(FlatSyntaxTreeTest, Structure) {
+  constexpr absl::string_view text("abcd");
+  // Preorder indices:
+  //   0: node 1
+  //     1: leaf a
+  //     2: node 2 (first child is null)
+  //       3: leaf b
+  //       4: leaf c
+  //     (null)
+  //     5: leaf d
+  const SymbolPtr root =
+      TNode(1, Leaf(10, text.substr(0, 1)),
+            TNode(2, nullptr, Leaf(11, text.substr(1, 1)),
+                  Leaf(12, text.substr(2, 1))),
+            nullptr, Leaf(13, text.substr(3, 1)));
+  const FlatSyntaxTree tree(root.get());
+  ASSERT_EQ(tree.size(), 6);
+
+  const std::vector<int> expected_tags{1, 10, 2, 11, 12, 13};
+  const std::vector<bool> expected_leaves{false, true, false,
+                                          true,  true, true};
+  const std::vector<index_type> expected_parents{kNone, 0, 0, 2, 2, 0};
+  const std::vector<index_type> expected_ends{6, 2, 5, 4, 5, 6};
+  const std::vector<index_type> expected_positions{0, 0, 1, 1, 2, 3};
+  for (index_type i = 0; i < tree.size(); ++i) {
+    EXPECT_EQ(tree.Tag(i), expected_tags[i]) << i;
+    EXPECT_EQ(tree.IsLeaf(i), expected_leaves[i]) << i;
+    EXPECT_EQ(tree.Parent(i), expected_parents[i]) << i;
+    EXPECT_EQ(tree.SubtreeEnd(i), expected_ends[i]) << i;
+    EXPECT_EQ(tree.ChildPosition(i), expected_positions[i]) << i;
+  }
+
+  EXPECT_EQ(tree.FirstChild(0), 1);
+  EXPECT_EQ(tree.NextSibling(1), 2);
+  EXPECT_EQ(tree.NextSibling(2), 5);
+  EXPECT_EQ(tree.NextSibling(5), kNone);
+  EXPECT_EQ(tree.FirstChild(2), 3);
+  EXPECT_EQ(tree.NextSibling(4), kNone);
+  EXPECT_EQ(tree.FirstChild(3), kNone);
+
+  EXPECT_EQ(tree.Depth(0), 0);
+  EXPECT_EQ(tree.Depth(2), 1);
+  EXPECT_EQ(tree.Depth(4), 2);
+
+  ASSERT_EQ(tree.NumLeaves(), 4);
+  EXPECT_EQ(tree.Token(1).text, "a");
+  EXPECT_EQ(tree.Token(3).text, "b");
+  EXPECT_EQ(tree.Token(4).text, "c");
+  EXPECT_EQ(tree.Token(5).text, "d");
+  EXPECT_EQ(tree.TokenIndex(5), 3);
+  EXPECT_EQ(tree.TokenIndex(2), kNone);
+
+  const auto& root_node = *down_cast<const SyntaxTreeNode*>(root.get());
+  EXPECT_EQ(&tree.Node(0), &root_node);
+  EXPECT_EQ(&tree.Node(2), root_node.children()[1].get());
+  EXPECT_EQ(&tree.Leaf(5), root_node.children()[3].get());
+  EXPECT_THAT(tree.FindNodesWithTag(2), ElementsAre(2));
+  EXPECT_THAT(tree.FindNodesWithTag(10), IsEmpty());  // leaves don't count
+}
+
+// Records the sequence of visitor calls.
+class RecordingVisitor : public FlatTreeVisitor {
+ public:
+  void VisitNode(const FlatSyntaxTree& tree, index_type node,
+                 const std::vector<index_type>& ancestors) override {
+    events.push_back(absl::StrCat("node", tree.Tag(node), "@",
+                                  ancestors.size()));
+  }
+  void VisitLeaf(const FlatSyntaxTree& tree, index_type leaf,
+                 const std::vector<index_type>& ancestors) override {
+    events.push_back(absl::StrCat(tree.Token(leaf).text, "@",
+                                  ancestors.size()));
+  }
+  void LeaveNode(const FlatSyntaxTree& tree, index_type node,
+                 const std::vector<index_type>& ancestors) override {
+    events.push_back(absl::StrCat("/node", tree.Tag(node)));
+  }
+
+  std::vector<std::string> events;
+};
+
+TEST(FlatSyntaxTreeTest, Visitor) {
+  constexpr absl::string_view text("abcd");
+  const SymbolPtr root = TNode(
+      1, Leaf(10, text.substr(0, 1)),
+      TNode(2, TNode(3, Leaf(11, text.substr(1, 1))),
+            Leaf(12, text.substr(2, 1))),
+      TNode(4), Leaf(13, text.substr(3, 1)));
+  const FlatSyntaxTree tree(root.get());
+  RecordingVisitor visitor;
+  tree.Accept(&visitor);
+  EXPECT_THAT(visitor.events,
+              ElementsAre("node1@0", "a@1", "node2@1", "node3@2", "b@3",
+                          "/node3", "c@2", "/node2", "node4@1", "/node4",
+                          "d@1", "/node1"));
+}
+
+// Tests that very deep trees are flattened and traversed without recursion.
+TEST(FlatSyntaxTreeTest, DeepTree) {
+  constexpr int kDepth = 100000;
+  SymbolPtr root = Leaf(1, "x");
+  for (int i = 0; i < kDepth; ++i) root = TNode(2, std::move(root));
+  const FlatSyntaxTree tree(root.get());
+  ASSERT_EQ(tree.size(), kDepth + 1);
+  EXPECT_TRUE(tree.IsLeaf(kDepth));
+  EXPECT_EQ(tree.Depth(kDepth), kDepth);
+  EXPECT_EQ(tree.SubtreeEnd(0), kDepth + 1);
+  RecordingVisitor visitor;
+  tree.Accept(&visitor);
+  EXPECT_EQ(visitor.events.size(), 2 * kDepth + 1);
+
+  // Tear down iteratively, to avoid deep recursion in destructors.
+  while (root->Kind() == SymbolKind::kNode) {
+    auto* node = down_cast<SyntaxTreeNode*>(root.get());
+    SymbolPtr child = std::move(node->mutable_children().front());
+    root = std::move(child);
+  }
+}
+
+}  // namespace
+}  // namespace verible
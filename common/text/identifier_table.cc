@@ -0,0 +1,88 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/identifier_table.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "common/strings/naming_utils.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/logging.h"
+
+namespace verible {
+
+constexpr IdentifierTable::id_type IdentifierTable::kNotFound;
+
+IdentifierTable::IdentifierTable(
+    const TokenSequence& tokens,
+    const std::function<bool(const TokenInfo&)>& is_identifier) {
+  for (const auto& token : tokens) {
+    if (!is_identifier(token)) continue;
+    const auto inserted = ids_by_text_.emplace(token.text, texts_.size());
+    if (inserted.second) {
+      CHECK_LT(texts_.size(), kNotFound) << "Too many identifiers.";
+      texts_.push_back(token.text);
+      naming_styles_.push_back(ClassifyNamingStyles(token.text));
+    }
+    ids_by_location_.emplace(token.text.begin(), inserted.first->second);
+  }
+}
+
+const IdentifierTable& IdentifierTable::Empty() {
+  static const auto* empty = new IdentifierTable();
+  return *empty;
+}
+
+IdentifierTable::id_type IdentifierTable::Find(const TokenInfo& token) const {
+  const auto found = ids_by_location_.find(token.text.begin());
+  if (found != ids_by_location_.end() &&
+      texts_[found->second].length() == token.text.length()) {
+    return found->second;
+  }
+  return Find(token.text);
+}
+
+IdentifierTable::id_type IdentifierTable::Find(absl::string_view text) const {
+  const auto found = ids_by_text_.find(text);
+  return found != ids_by_text_.end() ? found->second : kNotFound;
+}
+
+uint8_t IdentifierTable::NamingStylesOf(const TokenInfo& token) const {
+  const id_type id = Find(token);
+  return id != kNotFound ? naming_styles_[id]
+                         : ClassifyNamingStyles(token.text);
+}
+
+uint8_t IdentifierTable::ClassifyNamingStyles(absl::string_view text) {
+  uint8_t styles = 0;
+  if (IsLowerSnakeCaseWithDigits(text)) styles |= kLowerSnakeCase;
+  if (IsUpperCamelCaseWithDigits(text)) styles |= kUpperCamelCase;
+  if (IsNameAllCapsUnderscoresDigits(text)) styles |= kAllCaps;
+  return styles;
+}
+
+const IdentifierTable& LazyIdentifierTable::Get() const {
+  std::call_once(once_, [this]() {
+    table_ = absl::make_unique<IdentifierTable>(tokens_, is_identifier_);
+  });
+  return *table_;
+}
+
+}  // namespace verible
@@ -0,0 +1,139 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// IdentifierTable interns the distinct identifier texts of one file, so that
+// properties of a name are computed once per name, instead of once per
+// occurrence.  Analyses that look at the same names over and over (such as
+// naming convention lint rules) query the table by identifier id.
+
+#ifndef VERIBLE_COMMON_TEXT_IDENTIFIER_TABLE_H_
+#define VERIBLE_COMMON_TEXT_IDENTIFIER_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+
+namespace verible {
+
+class IdentifierTable {
+ public:
+  using id_type = uint32_t;
+
+  // Result of Find() for texts that are not in the table.
+  static constexpr id_type kNotFound = ~id_type(0);
+
+  // Naming conventions, as a set of bits.  A name may follow several of them
+  // (e.g. "A1" is both UpperCamelCase and ALL_CAPS).
+  enum NamingStyle : uint8_t {
+    kLowerSnakeCase = 1 << 0,  // IsLowerSnakeCaseWithDigits()
+    kUpperCamelCase = 1 << 1,  // IsUpperCamelCaseWithDigits()
+    kAllCaps = 1 << 2,         // IsNameAllCapsUnderscoresDigits()
+  };
+
+  // An empty table, in which every lookup falls back to computing properties
+  // directly.
+  IdentifierTable() = default;
+
+  // Interns the text of every token for which 'is_identifier' is true.
+  // 'tokens' must outlive the table, which refers to their text.
+  IdentifierTable(const TokenSequence& tokens,
+                  const std::function<bool(const TokenInfo&)>& is_identifier);
+
+  IdentifierTable(const IdentifierTable&) = delete;
+  IdentifierTable& operator=(const IdentifierTable&) = delete;
+
+  // Shared empty table.
+  static const IdentifierTable& Empty();
+
+  // Number of distinct identifier texts.
+  size_t size() const { return texts_.size(); }
+
+  // Returns the id of a token's text, or kNotFound.  Tokens from the interned
+  // sequence (and copies of them, such as syntax tree leaves) are found by
+  // their location in the text, without hashing the text itself.
+  id_type Find(const TokenInfo& token) const;
+
+  // Returns the id of 'text', or kNotFound.
+  id_type Find(absl::string_view text) const;
+
+  absl::string_view Text(id_type id) const { return texts_[id]; }
+
+  // Returns the set of NamingStyle bits of an interned identifier.
+  uint8_t NamingStyles(id_type id) const { return naming_styles_[id]; }
+
+  // Returns the set of NamingStyle bits of a token's text, from the table if
+  // it is interned, otherwise computed directly.
+  uint8_t NamingStylesOf(const TokenInfo& token) const;
+
+  // Returns true if a token's text follows the given naming convention.
+  bool HasNamingStyle(const TokenInfo& token, NamingStyle style) const {
+    return (NamingStylesOf(token) & style) != 0;
+  }
+
+  // Classifies 'text' without the table.
+  static uint8_t ClassifyNamingStyles(absl::string_view text);
+
+ private:
+  // Distinct texts, indexed by id.
+  std::vector<absl::string_view> texts_;
+
+  // Properties, indexed by id.
+  std::vector<uint8_t> naming_styles_;
+
+  // Maps the start of every interned token's text to its id.
+  absl::flat_hash_map<const char*, id_type> ids_by_location_;
+
+  // Maps every distinct text to its id.
+  absl::flat_hash_map<absl::string_view, id_type> ids_by_text_;
+};
+
+// LazyIdentifierTable builds the IdentifierTable of a token sequence the first
+// time it is needed, so that analyses that never look up identifiers do not
+// pay for interning them.  Get() may be called from several threads.
+class LazyIdentifierTable {
+ public:
+  // 'tokens' must outlive this object.
+  LazyIdentifierTable(const TokenSequence& tokens,
+                      std::function<bool(const TokenInfo&)> is_identifier)
+      : tokens_(tokens), is_identifier_(std::move(is_identifier)) {}
+
+  LazyIdentifierTable(const LazyIdentifierTable&) = delete;
+  LazyIdentifierTable& operator=(const LazyIdentifierTable&) = delete;
+
+  // Returns the table, building it on the first call.
+  const IdentifierTable& Get() const;
+
+  // Returns true if the table has been built.  Not synchronized with Get().
+  bool built() const { return table_ != nullptr; }
+
+ private:
+  const TokenSequence& tokens_;
+  const std::function<bool(const TokenInfo&)> is_identifier_;
+
+  mutable std::once_flag once_;
+  mutable std::unique_ptr<IdentifierTable> table_;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_TEXT_IDENTIFIER_TABLE_H_
@@ -0,0 +1,118 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/identifier_table.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+
+namespace verible {
+namespace {
+
+constexpr int kIdentifier = 1;
+constexpr int kOther = 2;
+
+bool IsIdentifier(const TokenInfo& token) {
+  return token.token_enum == kIdentifier;
+}
+
+TEST(IdentifierTableTest, Empty) {
+  const IdentifierTable& table = IdentifierTable::Empty();
+  EXPECT_EQ(table.size(), 0);
+  EXPECT_EQ(table.Find("foo"), IdentifierTable::kNotFound);
+  const TokenInfo token(kIdentifier, "foo_bar");
+  EXPECT_EQ(table.NamingStylesOf(token), IdentifierTable::kLowerSnakeCase);
+}
+
+TEST(IdentifierTableTest, InternsDistinctIdentifiers) {
+  const absl::string_view text("foo + Bar * foo");
+  const TokenSequence tokens{
+      {kIdentifier, text.substr(0, 3)},   {kOther, text.substr(4, 1)},
+      {kIdentifier, text.substr(6, 3)},   {kOther, text.substr(10, 1)},
+      {kIdentifier, text.substr(12, 3)},
+  };
+  const IdentifierTable table(tokens, IsIdentifier);
+  ASSERT_EQ(table.size(), 2);
+  const auto foo = table.Find("foo");
+  const auto bar = table.Find("Bar");
+  ASSERT_NE(foo, IdentifierTable::kNotFound);
+  ASSERT_NE(bar, IdentifierTable::kNotFound);
+  EXPECT_NE(foo, bar);
+  EXPECT_EQ(table.Text(foo), "foo");
+  EXPECT_EQ(table.Text(bar), "Bar");
+  EXPECT_EQ(table.Find("+"), IdentifierTable::kNotFound);
+
+  // Every occurrence maps to the same id, found by location.
+  EXPECT_EQ(table.Find(tokens[0]), foo);
+  EXPECT_EQ(table.Find(tokens[4]), foo);
+  EXPECT_EQ(table.Find(tokens[2]), bar);
+}
+
+TEST(IdentifierTableTest, FindsCopiesByText) {
+  const absl::string_view text("foo");
+  const TokenSequence tokens{{kIdentifier, text}};
+  const IdentifierTable table(tokens, IsIdentifier);
+
+  // Same text at a different location.
+  const std::string other_text("foo");
+  EXPECT_EQ(table.Find(TokenInfo(kIdentifier, other_text)), 0);
+  // Shorter text at the same location.
+  EXPECT_EQ(table.Find(TokenInfo(kIdentifier, text.substr(0, 2))),
+            IdentifierTable::kNotFound);
+}
+
+TEST(IdentifierTableTest, NamingStyles) {
+  const absl::string_view text("lower_1 UpperCamel ALL_CAPS A1 _x");
+  const TokenSequence tokens{
+      {kIdentifier, text.substr(0, 7)},  {kIdentifier, text.substr(8, 10)},
+      {kIdentifier, text.substr(19, 8)}, {kIdentifier, text.substr(28, 2)},
+      {kIdentifier, text.substr(31, 2)},
+  };
+  const IdentifierTable table(tokens, IsIdentifier);
+  EXPECT_EQ(table.NamingStyles(table.Find("lower_1")),
+            IdentifierTable::kLowerSnakeCase);
+  EXPECT_EQ(table.NamingStyles(table.Find("UpperCamel")),
+            IdentifierTable::kUpperCamelCase);
+  EXPECT_EQ(table.NamingStyles(table.Find("ALL_CAPS")),
+            IdentifierTable::kAllCaps);
+  EXPECT_EQ(table.NamingStyles(table.Find("A1")),
+            IdentifierTable::kUpperCamelCase | IdentifierTable::kAllCaps);
+  EXPECT_EQ(table.NamingStyles(table.Find("_x")), 0);
+  for (const auto& token : tokens) {
+    EXPECT_EQ(table.NamingStylesOf(token),
+              IdentifierTable::ClassifyNamingStyles(token.text))
+        << token.text;
+  }
+}
+
+TEST(LazyIdentifierTableTest, BuiltOnFirstUse) {
+  const absl::string_view text("foo Bar foo");
+  const TokenSequence tokens = {TokenInfo(kIdentifier, text.substr(0, 3)),
+                                TokenInfo(kOther, text.substr(4, 3)),
+                                TokenInfo(kIdentifier, text.substr(8, 3))};
+  const LazyIdentifierTable lazy(tokens, IsIdentifier);
+  EXPECT_FALSE(lazy.built());
+  const IdentifierTable& table = lazy.Get();
+  EXPECT_TRUE(lazy.built());
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_EQ(table.Find(tokens[2]), table.Find("foo"));
+  EXPECT_EQ(&lazy.Get(), &table);
+}
+
+}  // namespace
+}  // namespace verible
@@ -17,12 +17,18 @@
 
 #include <algorithm>  // for binary search
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <vector>
 
 #include "absl/strings/string_view.h"
 
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace verible {
 
 // Print to the user as 1-based index because that is how lines
@@ -32,6 +38,51 @@ std::ostream& operator<<(std::ostream& output_stream,
   return output_stream << line_column.line + 1 << ':' << line_column.column + 1;
 }
 
+// Appends the offset that follows every '\n' in 'text', in increasing order.
+// This compares a whole vector register of bytes at a time, and visits only
+// the positions of matches, which is considerably faster than one memchr()
+// call per line on typical source code with short lines.
+static void AppendLineBreakOffsets(absl::string_view text,
+                                   std::vector<int>* offsets) {
+  const char* const data = text.data();
+  const size_t size = text.size();
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i newlines32 = _mm256_set1_epi8('\n');
+  for (; i + 32 <= size; i += 32) {
+    const __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newlines32)));
+    while (mask != 0) {
+      offsets->push_back(i + __builtin_ctz(mask) + 1);
+      mask &= mask - 1;  // clear lowest set bit
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i newlines16 = _mm_set1_epi8('\n');
+  for (; i + 16 <= size; i += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newlines16)));
+    while (mask != 0) {
+      offsets->push_back(i + __builtin_ctz(mask) + 1);
+      mask &= mask - 1;  // clear lowest set bit
+    }
+  }
+#endif
+  // Without vector instructions, and for the remaining bytes at the end,
+  // memchr() is the fastest portable search.
+  while (i < size) {
+    const void* found = std::memchr(data + i, '\n', size - i);
+    if (found == nullptr) break;
+    i = static_cast<const char*>(found) - data + 1;
+    offsets->push_back(i);
+  }
+}
+
 // Records locations of line breaks, which can then be used to translate
 // offsets into line:column numbers.
 // Offsets are guaranteed to be monotonically increasing (sorted), and
@@ -40,11 +91,7 @@ LineColumnMap::LineColumnMap(absl::string_view text) {
   // The column number after every line break is 0.
   // The first line always starts at offset 0.
   beginning_of_line_offsets_.push_back(0);
-  auto offset = text.find('\n');
-  while (offset != absl::string_view::npos) {
-    beginning_of_line_offsets_.push_back(offset + 1);
-    offset = text.find('\n', offset + 1);
-  }
+  AppendLineBreakOffsets(text, &beginning_of_line_offsets_);
   // If the text does not end with a \n (POSIX), don't implicitly behave as if
   // there were one.
 }
@@ -59,6 +106,20 @@ LineColumnMap::LineColumnMap(const std::vector<absl::string_view>& lines) {
   }
 }
 
+std::vector<absl::string_view> LineColumnMap::SplitLines(
+    absl::string_view text) const {
+  std::vector<absl::string_view> lines;
+  if (beginning_of_line_offsets_.empty()) return lines;
+  lines.reserve(beginning_of_line_offsets_.size());
+  const auto last = beginning_of_line_offsets_.end() - 1;
+  for (auto iter = beginning_of_line_offsets_.begin(); iter != last; ++iter) {
+    // Exclude the '\n' that ends each line.
+    lines.push_back(text.substr(*iter, *(iter + 1) - *iter - 1));
+  }
+  lines.push_back(text.substr(*last));
+  return lines;
+}
+
 // Translate byte-offset into line-column.
 // Byte offsets beyond the end-of-file will return an unspecified result.
 LineColumn LineColumnMap::operator()(int offset) const {
@@ -47,6 +47,7 @@ std::ostream& operator<<(std::ostream&, const LineColumn&);
 
 class LineColumnMap {
  public:
+  // Finds the beginning of every line in a single (vectorized) pass.
   explicit LineColumnMap(absl::string_view);
 
   explicit LineColumnMap(const std::vector<absl::string_view>& lines);
@@ -66,6 +67,11 @@ class LineColumnMap {
   // Translate byte-offset into line and column.
   LineColumn operator()(int bytes_offset) const;
 
+  // Returns the lines of 'text', excluding '\n's, which is equivalent to
+  // absl::StrSplit(text, '\n'), without scanning 'text' again.
+  // 'text' must be the same text from which this map was constructed.
+  std::vector<absl::string_view> SplitLines(absl::string_view text) const;
+
   const std::vector<int>& GetBeginningOfLineOffsets() const {
     return beginning_of_line_offsets_;
   }
@@ -17,6 +17,7 @@
 #include "common/text/line_column_map.h"
 
 #include <sstream>  // IWYU pragma: keep  // for ostringstream
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -113,6 +114,43 @@ TEST(LineColumnMapTest, OffsetsFromLines) {
   }
 }
 
+// This tests that splitting lines using the map is consistent with
+// absl::StrSplit.
+TEST(LineColumnMapTest, SplitLines) {
+  for (const auto& test_case : map_test_data) {
+    const LineColumnMap line_map(test_case.text);
+    const std::vector<absl::string_view> expected_lines =
+        absl::StrSplit(test_case.text, '\n');
+    const std::vector<absl::string_view> lines =
+        line_map.SplitLines(test_case.text);
+    ASSERT_EQ(lines.size(), expected_lines.size())
+        << "Text: \"" << test_case.text << "\"";
+    for (size_t i = 0; i < lines.size(); ++i) {
+      // Compare positions, not just contents.
+      EXPECT_EQ(lines[i].begin(), expected_lines[i].begin());
+      EXPECT_EQ(lines[i].end(), expected_lines[i].end());
+    }
+  }
+}
+
+// Texts longer than a vector register are scanned in chunks.  This tests
+// newlines at every position relative to chunk boundaries.
+TEST(LineColumnMapTest, OffsetsLongText) {
+  for (int length = 0; length < 100; ++length) {
+    for (int stride = 1; stride < 40; ++stride) {
+      std::string text(length, 'x');
+      std::vector<int> expected_offsets = {0};
+      for (int i = stride - 1; i < length; i += stride) {
+        text[i] = '\n';
+        expected_offsets.push_back(i + 1);
+      }
+      const LineColumnMap line_map(text);
+      EXPECT_EQ(line_map.GetBeginningOfLineOffsets(), expected_offsets)
+          << "length: " << length << ", stride: " << stride;
+    }
+  }
+}
+
 TEST(LineColumnMapTest, EndOffsetNoLines) {
   const std::vector<absl::string_view> lines;
   const LineColumnMap map(lines);
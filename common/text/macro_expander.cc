@@ -0,0 +1,381 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/macro_expander.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "common/text/macro_definition.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/status.h"
+
+namespace verible {
+
+constexpr int MacroExpander::kMaxNestingDepth;
+
+static bool Contains(const std::vector<int>& enums, int token_enum) {
+  return std::find(enums.begin(), enums.end(), token_enum) != enums.end();
+}
+
+bool MacroExpander::IsMacroToken(const TokenInfo& token) const {
+  return token.token_enum == language_.macro_call_enum ||
+         Contains(language_.macro_reference_enums, token.token_enum);
+}
+
+absl::string_view MacroExpander::MacroName(const TokenInfo& token) const {
+  return absl::StripPrefix(token.text, language_.reference_prefix);
+}
+
+util::Status MacroExpander::ParseMacroCall(TokenSequence::const_iterator* iter,
+                                           TokenSequence::const_iterator end,
+                                           MacroCall* call) const {
+  const TokenInfo& name = **iter;
+  call->macro_name = name;
+  ++*iter;
+  if (name.token_enum != language_.macro_call_enum) {
+    call->has_parameters = false;
+    return util::OkStatus();
+  }
+  call->has_parameters = true;
+  if (*iter == end || (*iter)->token_enum != '(') {
+    return util::InvalidArgumentError(
+        absl::StrCat("Expected '(' after macro call ", name.text));
+  }
+  ++*iter;
+  // An empty argument refers to the end of the preceding token.
+  const auto empty_argument = [this](const TokenInfo& previous) {
+    return TokenInfo(language_.macro_arg_enum,
+                     absl::string_view(previous.text.end(), 0));
+  };
+  TokenInfo argument = empty_argument(*std::prev(*iter));
+  bool any_arguments = false;
+  for (; *iter != end; ++*iter) {
+    const TokenInfo& token = **iter;
+    if (token.token_enum == language_.macro_arg_enum) {
+      argument = token;
+      any_arguments = true;
+    } else if (token.token_enum == ',') {
+      call->positional_arguments.emplace_back(argument);
+      argument = empty_argument(token);
+      any_arguments = true;
+    } else if (Contains(language_.call_close_enums, token.token_enum)) {
+      if (any_arguments) call->positional_arguments.emplace_back(argument);
+      ++*iter;
+      return util::OkStatus();
+    } else {
+      return util::InvalidArgumentError(
+          absl::StrCat("Unexpected token in arguments of macro call ",
+                       name.text, ": ", token.text));
+    }
+  }
+  return util::InvalidArgumentError(
+      absl::StrCat("Unterminated arguments of macro call ", name.text));
+}
+
+util::Status MacroExpander::Lex(absl::string_view text,
+                                TokenSequence* tokens) const {
+  TokenSequence lexed;
+  const auto status = language_.tokenize(text, &lexed);
+  if (!status.ok()) return status;
+  for (const auto& token : lexed) {
+    if (token.token_enum == language_.macro_arg_enum) {
+      const auto status = Lex(token.text, tokens);
+      if (!status.ok()) return status;
+    } else {
+      tokens->push_back(token);
+    }
+  }
+  return util::OkStatus();
+}
+
+util::Status MacroExpander::ParseLexedCall(TokenSequence::const_iterator* iter,
+                                           TokenSequence::const_iterator end,
+                                           LexedCall* call) const {
+  const TokenInfo& name = **iter;
+  call->macro_name = name;
+  ++*iter;
+  if (name.token_enum != language_.macro_call_enum) {
+    call->has_parameters = false;
+    return util::OkStatus();
+  }
+  call->has_parameters = true;
+  if (*iter == end || (*iter)->token_enum != '(') {
+    return util::InvalidArgumentError(
+        absl::StrCat("Expected '(' after macro call ", name.text));
+  }
+  ++*iter;
+  // Separators only count outside of nested parentheses and braces.
+  int balance = 0;
+  call->arguments.emplace_back();
+  for (; *iter != end; ++*iter) {
+    const TokenInfo& token = **iter;
+    if (balance == 0) {
+      if (Contains(language_.call_close_enums, token.token_enum)) {
+        // "()" has no arguments.
+        if (call->arguments.size() == 1 && call->arguments.front().empty()) {
+          call->arguments.clear();
+        }
+        ++*iter;
+        return util::OkStatus();
+      }
+      if (token.token_enum == ',') {
+        call->arguments.emplace_back();
+        continue;
+      }
+    }
+    if (token.token_enum == '(' || token.token_enum == '{') ++balance;
+    if (token.token_enum == ')' || token.token_enum == '}') --balance;
+    if (token.token_enum == language_.macro_arg_enum) {
+      const auto status = Lex(token.text, &call->arguments.back());
+      if (!status.ok()) return status;
+    } else {
+      call->arguments.back().push_back(token);
+    }
+  }
+  return util::InvalidArgumentError(
+      absl::StrCat("Unterminated arguments of macro call ", name.text));
+}
+
+util::Status MacroExpander::BodyTokens(const MacroDefinition& definition,
+                                       const TokenSequence** body) {
+  const auto found = bodies_.find(definition.Name());
+  if (found != bodies_.end()) {
+    *body = &found->second;
+    return util::OkStatus();
+  }
+  TokenSequence tokens;
+  const auto status = Lex(definition.DefinitionText().text, &tokens);
+  if (!status.ok()) return status;
+  *body = &bodies_.emplace(definition.Name(), std::move(tokens)).first->second;
+  return util::OkStatus();
+}
+
+util::Status MacroExpander::Expand(const MacroCall& call,
+                                   const TokenSequence** expansion) {
+  LexedCall lexed_call;
+  lexed_call.macro_name = call.macro_name;
+  lexed_call.has_parameters = call.has_parameters;
+  for (const auto& argument : call.positional_arguments) {
+    lexed_call.arguments.emplace_back();
+    const auto status = Lex(argument.text, &lexed_call.arguments.back());
+    if (!status.ok()) return status;
+  }
+  MemoKey key;
+  const MemoTable::value_type* memoized;
+  const auto status = ExpandCall(lexed_call, 0, &key, &memoized);
+  if (!status.ok()) return status;
+  if (IsSameCall(*memoized, key)) {
+    *expansion = &memoized->second.expansion;
+  } else {
+    rebased_.emplace_back();
+    AppendRebased(*memoized, key, &rebased_.back());
+    *expansion = &rebased_.back();
+  }
+  return util::OkStatus();
+}
+
+util::Status MacroExpander::Substitute(
+    const MacroDefinition& definition,
+    const std::vector<TokenSequence>& arguments, TokenSequence* substituted) {
+  const TokenSequence* body;
+  auto status = BodyTokens(definition, &body);
+  if (!status.ok()) return status;
+  const auto& formals = definition.Parameters();
+  if (formals.empty()) {
+    substituted->insert(substituted->end(), body->begin(), body->end());
+    return util::OkStatus();
+  }
+
+  // Map every formal parameter to its actual tokens, or to its default.
+  // A call with empty parentheses passes one empty argument.
+  const std::vector<TokenSequence> one_empty_argument(1);
+  const std::vector<TokenSequence>& actuals =
+      arguments.empty() && formals.size() == 1 ? one_empty_argument
+                                               : arguments;
+  if (actuals.size() != formals.size()) {
+    return util::InvalidArgumentError(absl::StrCat(
+        "Error calling macro ", definition.Name(), " with ", actuals.size(),
+        " arguments, but definition has ", formals.size(),
+        " formal parameters."));
+  }
+  absl::flat_hash_map<absl::string_view, TokenSequence> replacements;
+  for (size_t i = 0; i < formals.size(); ++i) {
+    TokenSequence& replacement = replacements[formals[i].name.text];
+    if (!actuals[i].empty()) {
+      replacement = actuals[i];
+    } else if (formals[i].HasDefaultText()) {
+      status = Lex(formals[i].default_value.text, &replacement);
+      if (!status.ok()) return status;
+    }
+  }
+  for (const auto& token : *body) {
+    const auto found = token.token_enum == language_.identifier_enum
+                           ? replacements.find(token.text)
+                           : replacements.end();
+    if (found == replacements.end()) {
+      substituted->push_back(token);
+    } else {
+      substituted->insert(substituted->end(), found->second.begin(),
+                          found->second.end());
+    }
+  }
+  return util::OkStatus();
+}
+
+util::Status MacroExpander::ExpandCall(const LexedCall& call, int depth,
+                                       MemoKey* key,
+                                       const MemoTable::value_type** memoized) {
+  const absl::string_view name = MacroName(call.macro_name);
+  const MacroDefinition* definition = lookup_(name);
+  if (definition == nullptr) {
+    return util::InvalidArgumentError(
+        absl::StrCat("Undefined macro ", call.macro_name.text));
+  }
+  if (call.has_parameters && !definition->IsCallable()) {
+    return util::InvalidArgumentError(absl::StrCat(
+        "Macro ", name, " does not take arguments, but was called with some."));
+  }
+  ++stats_.calls;
+
+  key->first = name;
+  key->second.clear();
+  for (const auto& argument : call.arguments) {
+    for (const auto& token : argument) key->second.push_back(token.text);
+    key->second.emplace_back();
+  }
+  const auto found = memo_.find(*key);
+  if (found != memo_.end()) {
+    ++stats_.memo_hits;
+    *memoized = &*found;
+    return util::OkStatus();
+  }
+
+  if (depth >= kMaxNestingDepth) {
+    return util::ResourceExhaustedError(absl::StrCat(
+        "Macro expansions nested more than ", kMaxNestingDepth, " deep"));
+  }
+  // Like in C, arguments are expanded before they are substituted.
+  std::vector<TokenSequence> arguments(call.arguments.size());
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    const auto status =
+        ExpandRange(call.arguments[i], depth + 1, &arguments[i]);
+    if (!status.ok()) return status;
+  }
+  if (!expanding_.insert(name).second) {
+    return util::InvalidArgumentError(
+        absl::StrCat("Recursive expansion of macro ", name));
+  }
+  TokenSequence substituted;
+  TokenSequence result;
+  auto status = Substitute(*definition, arguments, &substituted);
+  if (status.ok()) status = ExpandRange(substituted, depth + 1, &result);
+  expanding_.erase(name);
+  if (!status.ok()) return status;
+
+  stats_.expanded_tokens += result.size();
+  Memo memo;
+  memo.expansion = std::move(result);
+  const auto& texts = key->second;
+  for (size_t i = 0; i < texts.size(); ++i) {
+    if (!texts[i].empty()) memo.arguments_by_address.push_back(i);
+  }
+  std::sort(memo.arguments_by_address.begin(),
+            memo.arguments_by_address.end(), [&texts](size_t a, size_t b) {
+              return std::less<const char*>()(texts[a].data(),
+                                              texts[b].data());
+            });
+  *memoized = &*memo_.emplace(*key, std::move(memo)).first;
+  return util::OkStatus();
+}
+
+bool MacroExpander::IsSameCall(const MemoTable::value_type& memoized,
+                               const MemoKey& key) {
+  const auto& texts = memoized.first.second;
+  for (size_t i = 0; i < texts.size(); ++i) {
+    if (texts[i].data() != key.second[i].data()) return false;
+  }
+  return true;
+}
+
+void MacroExpander::AppendRebased(const MemoTable::value_type& memoized,
+                                  const MemoKey& key,
+                                  TokenSequence* expanded) {
+  const TokenSequence& expansion = memoized.second.expansion;
+  if (IsSameCall(memoized, key)) {
+    expanded->insert(expanded->end(), expansion.begin(), expansion.end());
+    return;
+  }
+  // Texts of the memoized call and of 'key' are equal, so a token within
+  // argument text i moves to the same offset within key.second[i].
+  const auto& texts = memoized.first.second;
+  const auto& by_address = memoized.second.arguments_by_address;
+  const std::less<const char*> before;
+  for (TokenInfo token : expansion) {
+    const char* begin = token.text.data();
+    const auto next = std::upper_bound(
+        by_address.begin(), by_address.end(), begin,
+        [&texts, &before](const char* address, size_t i) {
+          return before(address, texts[i].data());
+        });
+    if (next != by_address.begin()) {
+      const size_t i = *std::prev(next);
+      const size_t offset = begin - texts[i].data();
+      if (offset + token.text.length() <= texts[i].length()) {
+        token.text = key.second[i].substr(offset, token.text.length());
+      }
+    }
+    expanded->push_back(token);
+  }
+}
+
+util::Status MacroExpander::ExpandRange(const TokenSequence& tokens,
+                                        int depth, TokenSequence* expanded) {
+  auto iter = tokens.begin();
+  while (iter != tokens.end()) {
+    if (!IsMacroToken(*iter) || lookup_(MacroName(*iter)) == nullptr) {
+      expanded->push_back(*iter);
+      ++iter;
+      continue;
+    }
+    LexedCall call;
+    auto status = ParseLexedCall(&iter, tokens.end(), &call);
+    if (!status.ok()) return status;
+    MemoKey key;
+    const MemoTable::value_type* memoized;
+    status = ExpandCall(call, depth, &key, &memoized);
+    if (!status.ok()) return status;
+    AppendRebased(*memoized, key, expanded);
+  }
+  return util::OkStatus();
+}
+
+util::Status MacroExpander::ExpandTokens(const TokenStreamView& stream,
+                                         TokenSequence* expanded) {
+  // Copies only the TokenInfos, not their text.
+  TokenSequence tokens;
+  tokens.reserve(stream.size());
+  for (const auto& token : stream) tokens.push_back(*token);
+  expanded->reserve(expanded->size() + tokens.size());
+  return ExpandRange(tokens, 0, expanded);
+}
+
+}  // namespace verible
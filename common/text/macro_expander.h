@@ -0,0 +1,216 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// MacroExpander expands macro calls into sequences of tokens, using the
+// MacroDefinitions of one file.  Like MacroDefinition, it is
+// language-agnostic: each language describes its macro tokens with a
+// MacroExpander::Language.
+//
+// Expansions never copy text: every token of an expansion refers to text in
+// a macro definition body or in the arguments of a call, which are both part
+// of the original source.  Expansions are memoized by macro name and the
+// texts of argument tokens, so that repeated calls with identical arguments
+// (common in macro-heavy code) are expanded only once.  A memoized expansion
+// is rebased onto the arguments of every later call, so that its tokens
+// always refer to the arguments of the call being expanded.
+
+#ifndef VERIBLE_COMMON_TEXT_MACRO_EXPANDER_H_
+#define VERIBLE_COMMON_TEXT_MACRO_EXPANDER_H_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "common/text/macro_definition.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/status.h"
+
+namespace verible {
+
+class MacroExpander {
+ public:
+  // Describes the macro-related tokens of a language.
+  struct Language {
+    // Splits text into tokens (without whitespace or comments) whose text
+    // refers to the given text.
+    std::function<util::Status(absl::string_view, TokenSequence*)> tokenize;
+
+    // Enum of identifier tokens, which may refer to formal parameters.
+    int identifier_enum = 0;
+
+    // Enums of tokens that refer to a macro without arguments.
+    std::vector<int> macro_reference_enums;
+
+    // Enum of tokens that start a macro call, followed by '(', arguments
+    // separated by ',', and a closing token.
+    int macro_call_enum = 0;
+
+    // Enum of the (un-lexed) text of one argument.  Empty arguments may be
+    // omitted between separators.
+    int macro_arg_enum = 0;
+
+    // Enums of tokens that close the arguments of a call.
+    std::vector<int> call_close_enums = {')'};
+
+    // Text before the macro name in references and calls, e.g. "`".
+    absl::string_view reference_prefix;
+  };
+
+  // Returns the definition of a macro by name, or nullptr if it is undefined.
+  using MacroLookup = std::function<const MacroDefinition*(absl::string_view)>;
+
+  // Maximum depth of macros expanded within the expansion of other macros.
+  static constexpr int kMaxNestingDepth = 64;
+
+  // Counters of expansion work.
+  struct Stats {
+    // Number of expanded calls (including nested ones).
+    size_t calls = 0;
+
+    // Number of calls whose expansion was found in the memo table.
+    size_t memo_hits = 0;
+
+    // Number of tokens in all distinct expansions.
+    size_t expanded_tokens = 0;
+  };
+
+  // 'lookup' should return the same definition for a name throughout the
+  // lifetime of the expander, because expansions are memoized.
+  MacroExpander(Language language, MacroLookup lookup)
+      : language_(std::move(language)), lookup_(std::move(lookup)) {}
+
+  MacroExpander(const MacroExpander&) = delete;
+  MacroExpander& operator=(const MacroExpander&) = delete;
+
+  // Parses a macro reference or call that starts at '*iter', which is
+  // advanced past the last token of the call.  The tokens of 'call' refer to
+  // those of the range.  Returns an error if the arguments are not closed
+  // before 'end'.
+  util::Status ParseMacroCall(TokenSequence::const_iterator* iter,
+                              TokenSequence::const_iterator end,
+                              MacroCall* call) const;
+
+  // Expands a macro call, including any macro calls in the result whose
+  // definitions are known.  On success, '*expansion' points to tokens owned
+  // by this expander, which remain valid as long as it exists.  Tokens that
+  // come from arguments refer to the text of the arguments of 'call'.
+  util::Status Expand(const MacroCall& call, const TokenSequence** expansion);
+
+  // Copies the tokens of 'stream' to 'expanded', replacing every macro
+  // reference or call to a known macro by its expansion.  Calls to unknown
+  // macros are copied unchanged.
+  util::Status ExpandTokens(const TokenStreamView& stream,
+                            TokenSequence* expanded);
+
+  const Stats& GetStats() const { return stats_; }
+
+ private:
+  // A macro call whose arguments are fully lexed, including the arguments of
+  // macro calls within them.
+  struct LexedCall {
+    TokenInfo macro_name = TokenInfo::EOFToken();
+    bool has_parameters = false;
+    std::vector<TokenSequence> arguments;
+  };
+
+  // Macro name, and the texts of argument tokens, with an empty text after
+  // each argument.
+  using MemoKey = std::pair<absl::string_view, std::vector<absl::string_view>>;
+
+  // The expansion of the first call with some MemoKey.
+  struct Memo {
+    // Tokens may refer to the argument texts of that call (in the MemoKey).
+    TokenSequence expansion;
+
+    // Indices of non-empty argument texts in the MemoKey, by address.
+    std::vector<size_t> arguments_by_address;
+  };
+
+  using MemoTable = absl::node_hash_map<MemoKey, Memo>;
+
+  // Returns true if 'token' starts a macro reference or call.
+  bool IsMacroToken(const TokenInfo& token) const;
+
+  // Returns the name of the macro referenced by 'token'.
+  absl::string_view MacroName(const TokenInfo& token) const;
+
+  // Appends the tokens of 'text' to 'tokens', lexing the text of macro
+  // arguments as well.
+  util::Status Lex(absl::string_view text, TokenSequence* tokens) const;
+
+  // Like ParseMacroCall(), but lexes arguments, which may span several
+  // tokens.
+  util::Status ParseLexedCall(TokenSequence::const_iterator* iter,
+                              TokenSequence::const_iterator end,
+                              LexedCall* call) const;
+
+  // Returns the lexed tokens of a macro definition body.
+  util::Status BodyTokens(const MacroDefinition& definition,
+                          const TokenSequence** body);
+
+  // Appends 'tokens' to 'expanded', replacing calls to known macros by their
+  // expansions.
+  util::Status ExpandRange(const TokenSequence& tokens, int depth,
+                           TokenSequence* expanded);
+
+  // Expands 'call', or finds its expansion in the memo table.  On success,
+  // '*key' holds the argument texts of 'call', and '*memoized' points to the
+  // memo entry of the first call with the same texts.
+  util::Status ExpandCall(const LexedCall& call, int depth, MemoKey* key,
+                          const MemoTable::value_type** memoized);
+
+  // Returns true if 'memoized' was expanded from the arguments in 'key'
+  // (and not just from arguments with the same texts).
+  static bool IsSameCall(const MemoTable::value_type& memoized,
+                         const MemoKey& key);
+
+  // Appends the expansion of 'memoized' to 'expanded', with tokens that come
+  // from arguments referring to the corresponding argument texts of 'key'.
+  static void AppendRebased(const MemoTable::value_type& memoized,
+                            const MemoKey& key, TokenSequence* expanded);
+
+  // Appends the body of 'definition' to 'substituted', replacing formal
+  // parameters with 'arguments' (or their defaults).
+  util::Status Substitute(const MacroDefinition& definition,
+                          const std::vector<TokenSequence>& arguments,
+                          TokenSequence* substituted);
+
+  const Language language_;
+  const MacroLookup lookup_;
+
+  // Expansions, by macro name and argument texts.
+  MemoTable memo_;
+
+  // Expansions returned by Expand() that were rebased onto other arguments
+  // than those of the memoized call.
+  std::deque<TokenSequence> rebased_;
+
+  // Tokens of definition bodies, by macro name.
+  absl::node_hash_map<absl::string_view, TokenSequence> bodies_;
+
+  // Macros that are being expanded, to detect recursive definitions.
+  absl::flat_hash_set<absl::string_view> expanding_;
+
+  Stats stats_;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_TEXT_MACRO_EXPANDER_H_
@@ -0,0 +1,377 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/text/macro_expander.h"
+
+#include <cctype>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/text/macro_definition.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/container_util.h"
+#include "common/util/status.h"
+
+namespace verible {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using verible::container::FindOrNull;
+
+// Fake token enumerations that would come from parser.tab.hh.
+enum FakeTokenEnum {
+  FakeIdEnum = 256,
+  FakeMacroRefEnum,
+  FakeMacroCallEnum,
+  FakeMacroArgEnum,
+};
+
+static bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Minimal lexer for a Verilog-like macro language: identifiers, `macro
+// references, `macro(arg, ...) calls with un-lexed arguments, and
+// single-character symbols.
+util::Status FakeTokenize(absl::string_view text, TokenSequence* tokens) {
+  size_t pos = 0;
+  const auto identifier_end = [&text](size_t start) {
+    while (start < text.length() && IsIdentifierChar(text[start])) ++start;
+    return start;
+  };
+  while (pos < text.length()) {
+    const char c = text[pos];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      ++pos;
+      continue;
+    }
+    if (IsIdentifierChar(c)) {
+      const size_t end = identifier_end(pos);
+      tokens->emplace_back(FakeIdEnum, text.substr(pos, end - pos));
+      pos = end;
+      continue;
+    }
+    if (c != '`') {
+      tokens->emplace_back(c, text.substr(pos, 1));
+      ++pos;
+      continue;
+    }
+    const size_t end = identifier_end(pos + 1);
+    if (end == pos + 1) return util::InvalidArgumentError("bad macro name");
+    const bool is_call = end < text.length() && text[end] == '(';
+    tokens->emplace_back(is_call ? FakeMacroCallEnum : FakeMacroRefEnum,
+                         text.substr(pos, end - pos));
+    pos = end;
+    if (!is_call) continue;
+    tokens->emplace_back('(', text.substr(pos, 1));
+    // Arguments are not lexed, and end at ',' or ')' outside of parentheses.
+    int balance = 0;
+    size_t arg_start = ++pos;
+    for (;; ++pos) {
+      if (pos == text.length()) {
+        return util::InvalidArgumentError("unterminated macro call");
+      }
+      const char a = text[pos];
+      if (a == '(') ++balance;
+      if (balance > 0) {
+        if (a == ')') --balance;
+        continue;
+      }
+      if (a != ',' && a != ')') continue;
+      const absl::string_view arg = absl::StripAsciiWhitespace(
+          text.substr(arg_start, pos - arg_start));
+      if (!arg.empty()) tokens->emplace_back(FakeMacroArgEnum, arg);
+      tokens->emplace_back(a, text.substr(pos, 1));
+      arg_start = pos + 1;
+      if (a == ')') break;
+    }
+    ++pos;
+  }
+  return util::OkStatus();
+}
+
+MacroExpander::Language FakeLanguage() {
+  MacroExpander::Language language;
+  language.tokenize = &FakeTokenize;
+  language.identifier_enum = FakeIdEnum;
+  language.macro_reference_enums = {FakeMacroRefEnum};
+  language.macro_call_enum = FakeMacroCallEnum;
+  language.macro_arg_enum = FakeMacroArgEnum;
+  language.reference_prefix = "`";
+  return language;
+}
+
+// Expands macros with definitions that are added by each test.
+class MacroExpanderTest : public ::testing::Test {
+ protected:
+  MacroExpanderTest()
+      : expander_(FakeLanguage(), [this](absl::string_view name) {
+          return FindOrNull(definitions_, name);
+        }) {}
+
+  // Defines a macro with the given formal parameters (each optionally with
+  // "=default"), or with no parameter list if 'formals' is null.
+  void Define(absl::string_view name,
+              const std::vector<absl::string_view>* formals,
+              absl::string_view body) {
+    MacroDefinition definition(TokenInfo(0, "`define"),
+                               TokenInfo(FakeIdEnum, name));
+    if (formals != nullptr) {
+      definition.SetCallable();
+      for (const auto formal : *formals) {
+        const auto equals = formal.find('=');
+        MacroParameterInfo parameter;
+        parameter.name = TokenInfo(FakeIdEnum, formal.substr(0, equals));
+        if (equals != absl::string_view::npos) {
+          parameter.default_value =
+              TokenInfo(FakeMacroArgEnum, formal.substr(equals + 1));
+        }
+        definition.AppendParameter(parameter);
+      }
+    }
+    definition.SetDefinitionText(TokenInfo(0, body));
+    definitions_.emplace(name, definition);
+  }
+
+  // Lexes 'text' and expands all macros in it.
+  std::vector<std::string> ExpandText(absl::string_view text) {
+    TokenSequence tokens;
+    EXPECT_TRUE(FakeTokenize(text, &tokens).ok());
+    TokenStreamView view;
+    for (auto iter = tokens.begin(); iter != tokens.end(); ++iter) {
+      view.push_back(iter);
+    }
+    TokenSequence expanded;
+    status_ = expander_.ExpandTokens(view, &expanded);
+    std::vector<std::string> texts;
+    for (const auto& token : expanded) texts.emplace_back(token.text);
+    return texts;
+  }
+
+  // Returns true if all tokens refer to text of 'source'.
+  static bool AllTextWithin(const TokenSequence& tokens,
+                            absl::string_view source) {
+    for (const auto& token : tokens) {
+      if (token.text.begin() < source.begin() ||
+          token.text.end() > source.end()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::map<absl::string_view, MacroDefinition> definitions_;
+  MacroExpander expander_;
+  util::Status status_;
+};
+
+TEST_F(MacroExpanderTest, NoMacros) {
+  EXPECT_THAT(ExpandText("a = b;"), ElementsAre("a", "=", "b", ";"));
+  EXPECT_TRUE(status_.ok());
+  EXPECT_EQ(expander_.GetStats().calls, 0);
+}
+
+TEST_F(MacroExpanderTest, UndefinedMacrosAreUnchanged) {
+  EXPECT_THAT(ExpandText("`FOO `BAR(x, y)"),
+              ElementsAre("`FOO", "`BAR", "(", "x", ",", "y", ")"));
+  EXPECT_TRUE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, ObjectLikeMacro) {
+  Define("WIDTH", nullptr, "8 - 1");
+  EXPECT_THAT(ExpandText("[`WIDTH:0]"),
+              ElementsAre("[", "8", "-", "1", ":", "0", "]"));
+  EXPECT_TRUE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, SubstitutesArguments) {
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("ADD", &formals, "(a + b + a)");
+  EXPECT_THAT(ExpandText("`ADD(x * 2, y)"),
+              ElementsAreArray({"(", "x", "*", "2", "+", "y", "+", "x", "*",
+                                "2", ")"}));
+  EXPECT_TRUE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, DefaultArguments) {
+  const std::vector<absl::string_view> formals = {"a", "b=1"};
+  Define("ADD", &formals, "a + b");
+  EXPECT_THAT(ExpandText("`ADD(x, )"), ElementsAre("x", "+", "1"));
+  EXPECT_TRUE(status_.ok());
+  EXPECT_THAT(ExpandText("`ADD(x, y)"), ElementsAre("x", "+", "y"));
+  EXPECT_TRUE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, EmptyArgumentWithoutDefault) {
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("PAIR", &formals, "{a b}");
+  EXPECT_THAT(ExpandText("`PAIR(, y)"), ElementsAre("{", "y", "}"));
+  EXPECT_TRUE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, CallableWithoutParameters) {
+  const std::vector<absl::string_view> formals;
+  Define("NOW", &formals, "$time");
+  EXPECT_THAT(ExpandText("`NOW()"), ElementsAre("$", "time"));
+  EXPECT_TRUE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, WrongNumberOfArguments) {
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("ADD", &formals, "a + b");
+  ExpandText("`ADD(x, y, z)");
+  EXPECT_FALSE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, ArgumentsToObjectLikeMacro) {
+  Define("WIDTH", nullptr, "8");
+  ExpandText("`WIDTH(x)");
+  EXPECT_FALSE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, NestedMacros) {
+  Define("WIDTH", nullptr, "8");
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("ADD", &formals, "a + b");
+  Define("MSB", &formals, "`ADD(a, `WIDTH) - b");
+  // Macros in arguments are expanded too.
+  EXPECT_THAT(ExpandText("`MSB(`ADD(1, 2), 1)"),
+              ElementsAre("1", "+", "2", "+", "8", "-", "1"));
+  EXPECT_TRUE(status_.ok()) << status_.message();
+}
+
+TEST_F(MacroExpanderTest, RecursiveMacro) {
+  Define("LOOP", nullptr, "1 + `LOOP");
+  ExpandText("`LOOP");
+  EXPECT_FALSE(status_.ok());
+
+  Define("PING", nullptr, "`PONG");
+  Define("PONG", nullptr, "`PING");
+  ExpandText("`PING");
+  EXPECT_FALSE(status_.ok());
+}
+
+TEST_F(MacroExpanderTest, ExpansionsReferToOriginalText) {
+  const absl::string_view source = "`define ADD(a, b) a + b\n`ADD(x, y)\n";
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("ADD", &formals, source.substr(18, 5));
+  TokenSequence tokens;
+  ASSERT_TRUE(FakeTokenize(source.substr(24), &tokens).ok());
+  MacroCall call;
+  auto iter = tokens.cbegin();
+  ASSERT_TRUE(expander_.ParseMacroCall(&iter, tokens.cend(), &call).ok());
+  EXPECT_EQ(iter, tokens.cend());
+  const TokenSequence* expansion;
+  ASSERT_TRUE(expander_.Expand(call, &expansion).ok());
+  ASSERT_EQ(expansion->size(), 3);
+  EXPECT_TRUE(AllTextWithin(*expansion, source));
+  // Identifiers come from the arguments, and '+' from the definition.
+  EXPECT_EQ((*expansion)[0].text.begin(), source.begin() + 29);
+  EXPECT_EQ((*expansion)[1].text.begin(), source.begin() + 20);
+}
+
+TEST_F(MacroExpanderTest, IdenticalCallsAreExpandedOnce) {
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("ADD", &formals, "a + b");
+  const absl::string_view source = "`ADD(x, y) `ADD(x, y) `ADD(y, x)";
+  TokenSequence tokens;
+  ASSERT_TRUE(FakeTokenize(source, &tokens).ok());
+  std::vector<const TokenSequence*> expansions;
+  for (auto iter = tokens.cbegin(); iter != tokens.cend();) {
+    MacroCall call;
+    ASSERT_TRUE(expander_.ParseMacroCall(&iter, tokens.cend(), &call).ok());
+    const TokenSequence* expansion;
+    ASSERT_TRUE(expander_.Expand(call, &expansion).ok());
+    expansions.push_back(expansion);
+  }
+  ASSERT_EQ(expansions.size(), 3);
+  EXPECT_EQ(expander_.GetStats().calls, 3);
+  EXPECT_EQ(expander_.GetStats().memo_hits, 1);
+  EXPECT_EQ(expander_.GetStats().expanded_tokens, 6);
+  // The memoized expansion refers to the arguments of the second call.
+  ASSERT_EQ(expansions[1]->size(), 3);
+  EXPECT_EQ((*expansions[0])[0].text.begin(), source.begin() + 5);
+  EXPECT_EQ((*expansions[1])[0].text.begin(), source.begin() + 16);
+  EXPECT_EQ((*expansions[1])[1].text, "+");
+  EXPECT_EQ((*expansions[1])[2].text.begin(), source.begin() + 19);
+}
+
+TEST_F(MacroExpanderTest, MemoizedExpansionsReferToTheirOwnArguments) {
+  const std::vector<absl::string_view> formals = {"a", "b"};
+  Define("ADD", &formals, "a + b");
+  Define("TWICE", &formals, "`ADD(a, b) * `ADD(b, a)");
+  const absl::string_view source = "`TWICE(x, (y)) `TWICE(x, (y))";
+  TokenSequence tokens;
+  ASSERT_TRUE(FakeTokenize(source, &tokens).ok());
+  TokenStreamView view;
+  for (auto iter = tokens.begin(); iter != tokens.end(); ++iter) {
+    view.push_back(iter);
+  }
+  TokenSequence expanded;
+  ASSERT_TRUE(expander_.ExpandTokens(view, &expanded).ok());
+  ASSERT_EQ(expanded.size(), 22);
+  EXPECT_GT(expander_.GetStats().memo_hits, 0);
+  const absl::string_view first_call = source.substr(0, 14);
+  const absl::string_view second_call = source.substr(15);
+  for (int i = 0; i < 11; ++i) {
+    const TokenInfo& first = expanded[i];
+    const TokenInfo& second = expanded[i + 11];
+    EXPECT_EQ(first.text, second.text);
+    if (first.token_enum != FakeIdEnum && first.text != "(" &&
+        first.text != ")") {
+      continue;  // From the definitions.
+    }
+    EXPECT_TRUE(AllTextWithin({first}, first_call)) << i;
+    EXPECT_TRUE(AllTextWithin({second}, second_call)) << i;
+    EXPECT_EQ(first.text.begin() - first_call.begin(),
+              second.text.begin() - second_call.begin())
+        << i;
+  }
+}
+
+// A testbench dominated by a few shapes of logging macro calls.
+TEST_F(MacroExpanderTest, MacroDenseInput) {
+  const std::vector<absl::string_view> formals = {"ID", "MSG", "VERBOSITY"};
+  Define("uvm_info", &formals,
+         "begin if (uvm_report_enabled(VERBOSITY, UVM_INFO, ID)) "
+         "uvm_report_info(ID, MSG, VERBOSITY, `uvm_file, `uvm_line); end");
+  Define("uvm_file", nullptr, "__FILE__");
+  Define("uvm_line", nullptr, "__LINE__");
+  constexpr int kCalls = 3000;
+  constexpr int kShapes = 3;
+  std::string source;
+  for (int i = 0; i < kCalls; ++i) {
+    absl::StrAppend(&source, "`uvm_info(\"ID", i % kShapes,
+                    "\", $sformatf(\"x=%d\", x), UVM_LOW)\n");
+  }
+  const std::vector<std::string> expanded = ExpandText(source);
+  ASSERT_TRUE(status_.ok()) << status_.message();
+  const auto& stats = expander_.GetStats();
+  // Only the first call of each shape (and the nested macros of the first
+  // one) is actually expanded.
+  EXPECT_EQ(stats.calls - stats.memo_hits, kShapes + 2);
+  EXPECT_EQ(expanded.size(),
+            kCalls * (stats.expanded_tokens - 2) / kShapes);
+}
+
+}  // namespace
+}  // namespace verible
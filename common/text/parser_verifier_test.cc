@@ -121,4 +121,16 @@ TEST(ParserVerifierTest, SeveralPartialUnmatched) {
   EXPECT_EQ(unmatched, unmatched_expected);
 }
 
+TEST(ParserVerifierTest, DeepTree) {
+  auto root = NestedNodes(100000, Leaf(NOT_EOF, "foo"));
+  TokenSequence stream = {Token("foo"), Token("bar")};
+  TokenSequence unmatched_expected = {Token("bar")};
+
+  TokenStreamView view;
+  InitTokenStreamView(stream, &view);
+
+  ParserVerifier verifier(*root, view, equal_text);
+  EXPECT_EQ(verifier.Verify(), unmatched_expected);
+}
+
 }  // namespace verible
@@ -14,16 +14,28 @@
 
 #include "common/text/syntax_tree_context.h"
 
+#include <cstddef>
+
+#include "absl/memory/memory.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/util/logging.h"
 
 namespace verible {
 
+constexpr int SyntaxTreeContext::kNotInside;
+
 const SyntaxTreeNode& SyntaxTreeContext::top() const {
   CHECK(!stack_.empty());
   return *ABSL_DIE_IF_NULL(stack_.back());
 }
 
+SyntaxTreeContext& SyntaxTreeContext::operator=(
+    const SyntaxTreeContext& other) {
+  stack_ = other.stack_;
+  index_.reset();
+  return *this;
+}
+
 SyntaxTreeContext::AutoPop::AutoPop(SyntaxTreeContext* context,
                                     const SyntaxTreeNode& node) {
   context_ = context;
@@ -34,12 +46,49 @@ SyntaxTreeContext::AutoPop::~AutoPop() { context_->Pop(); }
 
 void SyntaxTreeContext::Pop() {
   CHECK(!stack_.empty());
+  if (index_ != nullptr) {
+    const auto& shadowed = index_->shadowed.back();
+    if (shadowed.tag >= 0) {
+      index_->innermost_index_by_tag[shadowed.tag] = shadowed.innermost_index;
+    }
+    index_->shadowed.pop_back();
+  }
   stack_.pop_back();
 }
 
 // Push a SyntaxTreeNode onto the stack
 void SyntaxTreeContext::Push(const verible::SyntaxTreeNode& node) {
+  // An index can only be built up from an empty stack.
+  if (index_ == nullptr && stack_.empty()) {
+    index_ = absl::make_unique<TagIndex>();
+  }
+  if (index_ != nullptr) {
+    auto& innermost_index_by_tag = index_->innermost_index_by_tag;
+    const int tag = node.Tag().tag;
+    if (tag >= 0) {
+      if (static_cast<size_t>(tag) >= innermost_index_by_tag.size()) {
+        innermost_index_by_tag.resize(tag + 1, kNotInside);
+      }
+      index_->shadowed.push_back({tag, innermost_index_by_tag[tag]});
+      innermost_index_by_tag[tag] = stack_.size();
+    } else {
+      index_->shadowed.push_back({tag, kNotInside});
+    }
+  }
   stack_.push_back(&node);
 }
 
+int SyntaxTreeContext::InnermostIndex(int tag) const {
+  if (index_ != nullptr && tag >= 0) {
+    const auto& innermost_index_by_tag = index_->innermost_index_by_tag;
+    return static_cast<size_t>(tag) < innermost_index_by_tag.size()
+               ? innermost_index_by_tag[tag]
+               : kNotInside;
+  }
+  for (int i = static_cast<int>(stack_.size()) - 1; i >= 0; --i) {
+    if (stack_[i]->Tag().tag == tag) return i;
+  }
+  return kNotInside;
+}
+
 }  // namespace verible
@@ -19,6 +19,7 @@
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <vector>
 
 #include "common/text/concrete_syntax_tree.h"
@@ -46,6 +47,17 @@ class SyntaxTreeContext {
   typedef std::vector<const SyntaxTreeNode*> stack_type;
   typedef stack_type::const_iterator const_iterator;
 
+  SyntaxTreeContext() = default;
+
+  // Copies (such as those kept with search matches and lint violations) hold
+  // only the stack, without the index of tags that speeds up the queries of
+  // a traversal, as that index is much larger than a typical stack.  Their
+  // IsInside*() queries search the stack instead.
+  SyntaxTreeContext(const SyntaxTreeContext& other) : stack_(other.stack_) {}
+  SyntaxTreeContext& operator=(const SyntaxTreeContext& other);
+  SyntaxTreeContext(SyntaxTreeContext&&) = default;
+  SyntaxTreeContext& operator=(SyntaxTreeContext&&) = default;
+
   // returns depth of context stack
   size_t size() const { return stack_.size(); }
 
@@ -63,28 +75,36 @@ class SyntaxTreeContext {
   // These might be useful for searching from the top-of-stack downward.
 
   // IsInside returns true if there is a node of the specified
-  // tag on the TreeContext stack.  Search occurs from the bottom of the
-  // stack and returns on the first match found.
+  // tag on the TreeContext stack.
+  // During a traversal, this takes constant time, regardless of the depth of
+  // the stack.
   // Type parameter E can be a language-specific enum or plain integer type.
   template <typename E>
   bool IsInside(E tag_enum) const {
-    const auto iter = std::find_if(
-        begin(), end(),
-        [=](const SyntaxTreeNode* node) { return node->MatchesTag(tag_enum); });
-    return iter != end();
+    return InnermostIndex(static_cast<int>(tag_enum)) != kNotInside;
   }
 
   // Returns true if current context is directly inside one of the includes
   // node types before any of the excludes node types.  Search starts
   // from the top of the stack.
+  // During a traversal, this takes time proportional to the number of node
+  // types, regardless of the depth of the stack.
   template <typename E>
   bool IsInsideFirst(std::initializer_list<E> includes,
                      std::initializer_list<E> excludes) const {
-    for (const auto& type : reversed_view(stack_)) {
-      if (type->MatchesTagAnyOf(includes)) return true;
-      if (type->MatchesTagAnyOf(excludes)) return false;
+    int innermost_include = kNotInside;
+    for (const E tag_enum : includes) {
+      innermost_include = std::max(innermost_include,
+                                   InnermostIndex(static_cast<int>(tag_enum)));
+    }
+    if (innermost_include == kNotInside) return false;
+    // A node that matches both includes and excludes counts as included.
+    for (const E tag_enum : excludes) {
+      if (InnermostIndex(static_cast<int>(tag_enum)) > innermost_include) {
+        return false;
+      }
     }
-    return false;
+    return true;
   }
 
   // Returns true if stack is not empty and top of stack matches tag_enum.
@@ -121,6 +141,9 @@ class SyntaxTreeContext {
   }
 
  protected:
+  // For traversals without recursion, where AutoPop does not apply.
+  friend class TreeContextVisitor;
+
   // Pop the top SyntaxTreeNode off of the stack
   void Pop();
 
@@ -132,6 +155,34 @@ class SyntaxTreeContext {
   // A vector is chosen to allow random access and searches from either end of
   // the stack.
   stack_type stack_;
+
+ private:
+  // Result of InnermostIndex() when no node on the stack has the tag.
+  static constexpr int kNotInside = -1;
+
+  // Returns the index into stack_ of the node closest to the top that has the
+  // given tag, or kNotInside.
+  int InnermostIndex(int tag) const;
+
+  struct TagIndex {
+    // Index into stack_ of the innermost node with each tag, indexed by tag,
+    // or kNotInside.  Grown on demand, as tag ranges are language-specific.
+    // Negative tags are not tracked here, and are searched for instead.
+    std::vector<int> innermost_index_by_tag;
+
+    // Parallel to stack_: each node's tag, and the innermost index of that
+    // tag before the node was pushed, to be restored when it is popped.
+    struct Shadowed {
+      int tag;
+      int innermost_index;
+    };
+    std::vector<Shadowed> shadowed;
+  };
+
+  // Created by the first Push() onto an empty stack, and kept up to date
+  // from then on.  Copies of a non-empty context have none, and search
+  // stack_ instead.
+  std::unique_ptr<TagIndex> index_;
 };
 
 }  // namespace verible
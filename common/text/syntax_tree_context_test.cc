@@ -72,6 +72,59 @@ TEST(SyntaxTreeContextTest, IsInsideTest) {
   }
 }
 
+// Test that IsInside is restored correctly when nested nodes with the same
+// tag are popped.
+TEST(SyntaxTreeContextTest, IsInsideRepeatedTagTest) {
+  SyntaxTreeContext context;
+  SyntaxTreeNode node1(1);
+  SyntaxTreeContext::AutoPop p1(&context, node1);
+  {
+    SyntaxTreeNode node2(2);
+    SyntaxTreeContext::AutoPop p2(&context, node2);
+    {
+      SyntaxTreeNode node3(1);
+      SyntaxTreeContext::AutoPop p3(&context, node3);
+      EXPECT_TRUE(context.IsInside(1));
+      EXPECT_TRUE(context.IsInsideFirst({1}, {2}));
+    }
+    EXPECT_TRUE(context.IsInside(1));
+    EXPECT_FALSE(context.IsInsideFirst({1}, {2}));
+  }
+  EXPECT_TRUE(context.IsInside(1));
+  EXPECT_FALSE(context.IsInside(2));
+  EXPECT_TRUE(context.IsInsideFirst({1}, {2}));
+}
+
+// Test that tags that are large or negative are found.
+TEST(SyntaxTreeContextTest, IsInsideUnusualTagsTest) {
+  SyntaxTreeContext context;
+  EXPECT_FALSE(context.IsInside(1000));
+  EXPECT_FALSE(context.IsInside(-5));
+  SyntaxTreeNode node1(-5);
+  SyntaxTreeContext::AutoPop p1(&context, node1);
+  SyntaxTreeNode node2(1000);
+  SyntaxTreeContext::AutoPop p2(&context, node2);
+  EXPECT_TRUE(context.IsInside(1000));
+  EXPECT_TRUE(context.IsInside(-5));
+  EXPECT_FALSE(context.IsInside(999));
+  EXPECT_FALSE(context.IsInside(-4));
+  EXPECT_TRUE(context.IsInsideFirst({1000}, {-5}));
+  EXPECT_FALSE(context.IsInsideFirst({-5}, {1000}));
+}
+
+// Test that a node type that is both included and excluded counts as
+// included.
+TEST(SyntaxTreeContextTest, IsInsideFirstOverlappingTest) {
+  SyntaxTreeContext context;
+  SyntaxTreeNode node1(1);
+  SyntaxTreeContext::AutoPop p1(&context, node1);
+  SyntaxTreeNode node2(2);
+  SyntaxTreeContext::AutoPop p2(&context, node2);
+  EXPECT_TRUE(context.IsInsideFirst({2}, {1, 2}));
+  EXPECT_TRUE(context.IsInsideFirst({1, 2}, {2}));
+  EXPECT_FALSE(context.IsInsideFirst({1}, {1, 2}));
+}
+
 // Test that IsInsideFirst correctly reports whether context matches.
 TEST(SyntaxTreeContextTest, IsInsideFirstTest) {
   SyntaxTreeContext context;
@@ -212,5 +265,33 @@ TEST(SyntaxTreeContextTest, DirectParentsAreTest) {
   }
 }
 
+// Test that copies, which search their stack, answer like the original.
+TEST(SyntaxTreeContextTest, CopyIsInsideTest) {
+  SyntaxTreeContext context;
+  SyntaxTreeNode node1(1);
+  SyntaxTreeContext::AutoPop p1(&context, node1);
+  SyntaxTreeNode node2(2);
+  SyntaxTreeContext::AutoPop p2(&context, node2);
+  SyntaxTreeContext copy(context);
+  SyntaxTreeContext assigned;
+  assigned = context;
+  for (const SyntaxTreeContext* c : {&context, &copy, &assigned}) {
+    EXPECT_EQ(c->size(), 2);
+    EXPECT_TRUE(c->IsInside(1));
+    EXPECT_TRUE(c->IsInside(2));
+    EXPECT_FALSE(c->IsInside(3));
+    EXPECT_TRUE(c->IsInsideFirst({2}, {1}));
+    EXPECT_FALSE(c->IsInsideFirst({1}, {2}));
+  }
+  // Copies can still be pushed and popped.
+  {
+    SyntaxTreeNode node3(3);
+    SyntaxTreeContext::AutoPop p3(&copy, node3);
+    EXPECT_TRUE(copy.IsInside(3));
+    EXPECT_FALSE(context.IsInside(3));
+  }
+  EXPECT_FALSE(copy.IsInside(3));
+}
+
 }  // namespace
 }  // namespace verible
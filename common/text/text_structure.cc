@@ -26,7 +26,6 @@
 #include <vector>
 
 #include "absl/strings/str_cat.h"
-#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
@@ -44,9 +43,9 @@
 namespace verible {
 
 TextStructureView::TextStructureView(absl::string_view contents)
-    : contents_(contents),
-      lines_(absl::StrSplit(contents_, '\n')),  // SplitLines()
-      line_column_map_(lines_) {
+    : contents_(contents), line_column_map_(contents_) {
+  // Lines are derived from the same scan for line breaks.
+  lines_ = line_column_map_.SplitLines(contents_);
   // more than sufficient memory as number-of-tokens <= bytes-in-file,
   // push_back() should never re-alloc because size <= initial capacity.
   tokens_.reserve(contents.length());
@@ -162,8 +161,7 @@ void TextStructureView::FocusOnSubtreeSpanningSubstring(int left_offset,
   TrimSyntaxTree(left_offset, right_offset);
   TrimTokensToSubstring(left_offset, right_offset);
   TrimContents(left_offset, length);
-  SplitLines();
-  RecalculateLineColumnMap();
+  RecalculateLines();
   CalculateFirstTokensPerLine();
   const util::Status status = InternalConsistencyCheck();
   CHECK(status.ok())
@@ -229,8 +227,9 @@ void TextStructureView::TrimContents(int left_offset, int length) {
   contents_ = contents_.substr(left_offset, length);
 }
 
-void TextStructureView::SplitLines() {
-  lines_ = absl::StrSplit(contents_, '\n');
+void TextStructureView::RecalculateLines() {
+  RecalculateLineColumnMap();
+  lines_ = line_column_map_.SplitLines(contents_);
 }
 
 void TextStructureView::RebaseTokensToSuperstring(absl::string_view superstring,
@@ -242,9 +241,11 @@ void TextStructureView::RebaseTokensToSuperstring(absl::string_view superstring,
     token->RebaseStringView(superstring.begin() + offset + delta);
   });
   // Assigning superstring for the sake of maintaining range invariants.
+  // Lines only need to be found again if the text is a different one.
+  const bool same_text = superstring.data() == contents_.data() &&
+                         superstring.size() == contents_.size();
   contents_ = superstring;
-  // Re-split lines.
-  SplitLines();
+  if (!same_text) RecalculateLines();
 }
 
 void TextStructureView::MutateTokens(const LeafMutator& mutator) {
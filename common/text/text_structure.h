@@ -184,7 +184,9 @@ class TextStructureView {
   void TrimTokensToSubstring(int left_offset, int right_offset);
 
   void TrimContents(int left_offset, int length);
-  void SplitLines();
+
+  // Recalculates lines_ and line_column_map_ from contents_, in one scan.
+  void RecalculateLines();
 
   void ConsumeDeferredExpansion(
       TokenSequence::const_iterator* next_token_iter,
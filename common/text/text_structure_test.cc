@@ -46,6 +46,7 @@
 namespace verible {
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::IsEmpty;
 using ::testing::IsNull;
 using ::testing::SizeIs;
@@ -174,6 +175,19 @@ TEST(RebaseTokensToSuperstringTest, NewOwner) {
   EXPECT_TRUE(IsSubRange(test_view.TokenStream().front().text, superstring));
 }
 
+// Test that lines and line-column map follow the new text.
+TEST(RebaseTokensToSuperstringTest, RecalculatesLines) {
+  const absl::string_view superstring = "a\nbc\nd";
+  const absl::string_view substring = "bc\n";
+  TextStructureView test_view(substring);
+  OneTokenTextStructureView(&test_view);
+  EXPECT_THAT(test_view.Lines(), ElementsAre("bc", ""));
+  test_view.RebaseTokensToSuperstring(superstring, substring, 2);
+  EXPECT_THAT(test_view.Lines(), ElementsAre("a", "bc", "d"));
+  EXPECT_THAT(test_view.GetLineColumnMap().GetBeginningOfLineOffsets(),
+              ElementsAre(0, 2, 5));
+}
+
 // Helper class for testing Token range methods.
 class TokenRangeTest : public ::testing::Test, public TextStructureTokenized {
  public:
@@ -14,6 +14,9 @@
 
 #include "common/text/tree_builder_test_util.h"
 
+#include <cstddef>
+#include <utility>
+
 #include "absl/strings/string_view.h"
 #include "common/text/symbol.h"
 
@@ -23,4 +26,12 @@ constexpr absl::string_view kDontCareText("");
 
 SymbolPtr XLeaf(int token_enum) { return Leaf(token_enum, kDontCareText); }
 
+SymbolPtr NestedNodes(size_t depth, SymbolPtr innermost) {
+  SymbolPtr tree(std::move(innermost));
+  while (depth-- > 0) {
+    tree = TNode(static_cast<int>(depth), std::move(tree));
+  }
+  return tree;
+}
+
 }  // namespace verible
@@ -17,6 +17,7 @@
 #ifndef VERIBLE_COMMON_TEXT_TREE_BUILDER_TEST_UTIL_H_
 #define VERIBLE_COMMON_TEXT_TREE_BUILDER_TEST_UTIL_H_
 
+#include <cstddef>
 #include <utility>
 
 #include "common/text/concrete_syntax_leaf.h"
@@ -41,6 +42,10 @@ SymbolPtr Leaf(Args&&... args) {
 // Use this for constructing leaves where you don't care about the token text.
 SymbolPtr XLeaf(int token_enum);
 
+// Returns 'innermost' nested inside 'depth' nodes, each tagged with its depth
+// (the root is 0), for testing deep trees.  This is built without recursion.
+SymbolPtr NestedNodes(size_t depth, SymbolPtr innermost);
+
 }  // namespace verible
 
 #endif  // VERIBLE_COMMON_TEXT_TREE_BUILDER_TEST_UTIL_H_
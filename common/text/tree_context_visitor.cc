@@ -14,15 +14,48 @@
 
 #include "common/text/tree_context_visitor.h"
 
+#include <vector>
+
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
+#include "common/util/value_saver.h"
 
 namespace verible {
 
 void TreeContextVisitor::Visit(const SyntaxTreeNode& node) {
+  if (traversing_) {
+    node_to_descend_ = &node;  // Traverse() visits the children
+    return;
+  }
   const SyntaxTreeContext::AutoPop p(&current_context_, node);
   for (const auto& child : node.children()) {
     if (child) child->Accept(this);
   }
 }
 
+void TreeContextVisitor::Traverse(const Symbol& root) {
+  const ValueSaver<bool> traversing(&traversing_, true);
+  // Symbols yet to be visited, with the next one at the back.
+  // nullptr marks the end of the children of the innermost context node.
+  std::vector<const Symbol*> pending{&root};
+  while (!pending.empty()) {
+    const Symbol* symbol = pending.back();
+    pending.pop_back();
+    if (symbol == nullptr) {
+      current_context_.Pop();
+      continue;
+    }
+    node_to_descend_ = nullptr;
+    symbol->Accept(this);
+    if (node_to_descend_ == nullptr) continue;
+    current_context_.Push(*node_to_descend_);
+    pending.push_back(nullptr);
+    const auto& children = node_to_descend_->children();
+    for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+      if (*iter != nullptr) pending.push_back(iter->get());
+    }
+  }
+}
+
 }  // namespace verible
@@ -15,6 +15,8 @@
 #ifndef VERIBLE_COMMON_TEXT_TREE_CONTEXT_VISITOR_H_
 #define VERIBLE_COMMON_TEXT_TREE_CONTEXT_VISITOR_H_
 
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/visitors.h"
 
@@ -29,10 +31,28 @@ class TreeContextVisitor : public SymbolVisitor {
  protected:
   void Visit(const SyntaxTreeNode& node) override;
 
+  // Visits the tree rooted at 'root' like root.Accept(this), but with an
+  // explicit stack instead of recursion, so that the depth of the tree is
+  // not limited by the call stack.
+  // While traversing, TreeContextVisitor::Visit(node) does not descend
+  // immediately, but schedules the node's children to be visited after the
+  // current Visit() returns.  This is only equivalent to Accept() for
+  // subclasses whose Visit(node) either does not descend, or does so by
+  // calling TreeContextVisitor::Visit(node) last.
+  void Traverse(const Symbol& root);
+
   const SyntaxTreeContext& Context() const { return current_context_; }
 
   // Keeps track of ancestors as the visitor traverses tree.
   SyntaxTreeContext current_context_;
+
+ private:
+  // True while Traverse() is running.
+  bool traversing_ = false;
+
+  // Node whose children were scheduled by the last Visit(), during
+  // Traverse().
+  const SyntaxTreeNode* node_to_descend_ = nullptr;
 };
 
 }  // namespace verible
@@ -14,6 +14,8 @@
 
 #include "common/text/tree_context_visitor.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -125,5 +127,95 @@ TEST(TreeContextVisitorTest, FullTree) {
   EXPECT_EQ(r.ContextTagHistory(), expect);
 }
 
+// Same as RecordingVisitor, but traverses without recursion.
+class TraversingRecordingVisitor : public RecordingVisitor {
+ public:
+  void Record(const Symbol& root) { Traverse(root); }
+};
+
+TEST(TreeContextVisitorTest, TraverseFullTree) {
+  auto tree = TNode(3,                             //
+                    TNode(4,                       //
+                          XLeaf(99),               //
+                          TNode(1,                 //
+                                XLeaf(99),         //
+                                XLeaf(0))),        //
+                    XLeaf(5),                      //
+                    nullptr,                       //
+                    TNode(6,                       //
+                          TNode(2,                 //
+                                TNode(7,           //
+                                      XLeaf(99)),  //
+                                TNode(8))));
+  TraversingRecordingVisitor r;
+  r.Record(*tree);
+  const std::vector<std::vector<int>> expect = {
+      {},  {3}, {3, 4}, {3, 4},    {3, 4, 1},    {3, 4, 1},
+      {3}, {3}, {3, 6}, {3, 6, 2}, {3, 6, 2, 7}, {3, 6, 2},
+  };
+  EXPECT_EQ(r.ContextTagHistory(), expect);
+}
+
+// Visits only the nodes that are not tagged 'pruned_tag', and their children.
+class PruningVisitor : public TreeContextVisitor {
+ public:
+  explicit PruningVisitor(int pruned_tag) : pruned_tag_(pruned_tag) {}
+
+  void Record(const Symbol& root) { Traverse(root); }
+
+  void Visit(const SyntaxTreeLeaf& leaf) override {
+    tags_.push_back(leaf.Tag().tag);
+  }
+
+  void Visit(const SyntaxTreeNode& node) override {
+    tags_.push_back(node.Tag().tag);
+    if (node.Tag().tag != pruned_tag_) TreeContextVisitor::Visit(node);
+  }
+
+  const std::vector<int>& Tags() const { return tags_; }
+
+ private:
+  const int pruned_tag_;
+  std::vector<int> tags_;
+};
+
+TEST(TreeContextVisitorTest, TraverseSkipsChildrenNotDescended) {
+  auto tree = TNode(1, TNode(2, XLeaf(3)), TNode(4, XLeaf(5)), XLeaf(6));
+  PruningVisitor r(2);
+  r.Record(*tree);
+  EXPECT_EQ(r.Tags(), std::vector<int>({1, 2, 4, 5, 6}));
+}
+
+// Records the deepest context and the number of visited symbols.
+class DepthVisitor : public TreeContextVisitor {
+ public:
+  void Record(const Symbol& root) { Traverse(root); }
+
+  void Visit(const SyntaxTreeLeaf& leaf) override { Count(); }
+
+  void Visit(const SyntaxTreeNode& node) override {
+    Count();
+    TreeContextVisitor::Visit(node);
+  }
+
+  size_t max_depth = 0;
+  size_t symbols = 0;
+
+ private:
+  void Count() {
+    ++symbols;
+    max_depth = std::max(max_depth, Context().size());
+  }
+};
+
+TEST(TreeContextVisitorTest, TraverseDeepTree) {
+  constexpr size_t kDepth = 100000;
+  auto tree = NestedNodes(kDepth, XLeaf(1));
+  DepthVisitor r;
+  r.Record(*tree);
+  EXPECT_EQ(r.symbols, kDepth + 1);
+  EXPECT_EQ(r.max_depth, kDepth);
+}
+
 }  // namespace
 }  // namespace verible
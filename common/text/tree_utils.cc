@@ -32,7 +32,6 @@
 #include "common/util/iterator_adaptors.h"
 #include "common/util/logging.h"
 #include "common/util/spacer.h"
-#include "common/util/value_saver.h"
 
 namespace verible {
 
@@ -125,115 +124,42 @@ const SyntaxTreeLeaf& SymbolCastToLeaf(const Symbol& symbol) {
   return down_cast<const SyntaxTreeLeaf&>(symbol);
 }
 
-namespace {
-// FirstSubtreeFinderMutable is a visitor class that supports the implementation
-// of FindFirstSubtreeMutable().  It is derived from
-// MutableTreeVisitorRecursive because it is intended for use with pruning and
-// modifying syntax trees.
-class FirstSubtreeFinderMutable : public MutableTreeVisitorRecursive {
- public:
-  explicit FirstSubtreeFinderMutable(const TreePredicate& predicate)
-      : predicate_(predicate) {}
-
-  void Visit(const SyntaxTreeNode& node, SymbolPtr* symbol_ptr) override {
-    CHECK_EQ(symbol_ptr->get(), &node);  // symbol_ptr owns node.
-    if (result_ == nullptr) {
-      // If this node matches, return it, and skip evaluating children.
-      if (predicate_(node)) {
-        result_ = symbol_ptr;
-      } else {
-        // Cast the mutable copy of the node pointer (same object as &node).
-        auto* const mutable_node =
-            down_cast<SyntaxTreeNode*>(symbol_ptr->get());
-        for (SymbolPtr& child : mutable_node->mutable_children()) {
-          if (child != nullptr) {
-            child->Accept(this, &child);
-          }
-          // Stop as soon as first result is found.
-          if (result_ != nullptr) return;
-        }
-      }
-    }
-  }
-
-  void Visit(const SyntaxTreeLeaf& leaf, SymbolPtr* symbol_ptr) override {
-    CHECK_EQ(symbol_ptr->get(), &leaf);  // symbol_ptr owns leaf.
-    // If already have a result, stop checking and return right away.
-    if (result_ == nullptr) {
-      if (predicate_(leaf)) {
-        result_ = symbol_ptr;
-      }
-    }
-  }
-
-  ConcreteSyntaxTree* result() const { return result_; }
-
- private:
-  // Matching criterion.
-  TreePredicate predicate_;
-
-  // Contains first matching result found or nullptr if no match is found.
-  ConcreteSyntaxTree* result_ = nullptr;
-};
-
-// FirstSubtreeFinder is a visitor class that supports the implementation of
-// FindFirstSubtree().  It is derived from TreeVisitorRecursive because it is
-// only intended for searching a tree given a predicate.
-class FirstSubtreeFinder : public TreeVisitorRecursive {
- public:
-  explicit FirstSubtreeFinder(const TreePredicate& predicate)
-      : predicate_(predicate) {}
-
-  void Visit(const SyntaxTreeNode& node) override {
-    if (result_ == nullptr) {
-      // If this node matches, return it, and skip evaluating children.
-      if (predicate_(node)) {
-        result_ = &node;
-      } else {
-        for (const SymbolPtr& child : node.children()) {
-          if (child != nullptr) {
-            child->Accept(this);
-          }
-          // Stop as soon as first result is found.
-          if (result_ != nullptr) return;
-        }
-      }
-    }
-  }
-
-  void Visit(const SyntaxTreeLeaf& leaf) override {
-    // If already have a result, stop checking and return right away.
-    if (result_ == nullptr) {
-      if (predicate_(leaf)) {
-        result_ = &leaf;
-      }
-    }
-  }
-
-  const Symbol* result() const { return result_; }
-
- private:
-  // Matching criterion.
-  TreePredicate predicate_;
-
-  // Contains first matching result found or nullptr if no match is found.
-  const Symbol* result_ = nullptr;
-};
-}  // namespace
-
 ConcreteSyntaxTree* FindFirstSubtreeMutable(ConcreteSyntaxTree* tree,
                                             const TreePredicate& pred) {
   if (*ABSL_DIE_IF_NULL(tree) == nullptr) return nullptr;
-  FirstSubtreeFinderMutable finder(pred);
-  (*tree)->Accept(&finder, tree);
-  return finder.result();
+  // Owners of subtrees yet to be searched, in preorder from the back.
+  // Children of a matching node are skipped.
+  std::vector<ConcreteSyntaxTree*> pending{tree};
+  while (!pending.empty()) {
+    ConcreteSyntaxTree* subtree = pending.back();
+    pending.pop_back();
+    if (pred(**subtree)) return subtree;
+    if ((*subtree)->Kind() != SymbolKind::kNode) continue;
+    auto& children =
+        down_cast<SyntaxTreeNode*>(subtree->get())->mutable_children();
+    for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+      if (*iter != nullptr) pending.push_back(&*iter);
+    }
+  }
+  return nullptr;
 }
 
 const Symbol* FindFirstSubtree(const Symbol* tree, const TreePredicate& pred) {
   if (tree == nullptr) return nullptr;
-  FirstSubtreeFinder finder(pred);
-  tree->Accept(&finder);
-  return finder.result();
+  // Subtrees yet to be searched, in preorder from the back.
+  std::vector<const Symbol*> pending{tree};
+  while (!pending.empty()) {
+    const Symbol* subtree = pending.back();
+    pending.pop_back();
+    if (pred(*subtree)) return subtree;
+    if (subtree->Kind() != SymbolKind::kNode) continue;
+    const auto& children =
+        down_cast<const SyntaxTreeNode*>(subtree)->children();
+    for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+      if (*iter != nullptr) pending.push_back(iter->get());
+    }
+  }
+  return nullptr;
 }
 
 ConcreteSyntaxTree* FindSubtreeStartingAtOffset(
@@ -392,20 +318,35 @@ void PrettyPrinter::Visit(const SyntaxTreeLeaf& leaf) {
   leaf.get().ToStream(auto_indent(), context_) << std::endl;
 }
 
-void RawSymbolPrinter::Visit(const SyntaxTreeNode& node) {
-  std::string tag_info = "";
+std::string RawSymbolPrinter::TagInfo(const SyntaxTreeNode& node) const {
   const int tag = node.Tag().tag;
-  if (tag != 0) tag_info = absl::StrCat("(tag: ", tag, ") ");
-
-  auto_indent() << "Node " << tag_info << "{" << std::endl;
+  if (tag == 0) return "";
+  return absl::StrCat("(tag: ", tag, ") ");
+}
 
-  {
-    ValueSaver<int> value_saver(&indent_, indent_ + 2);
-    for (const auto& child : node.children()) {
-      if (child) child->Accept(this);
+void RawSymbolPrinter::Visit(const SyntaxTreeNode& node) {
+  // Symbols yet to be printed, with the next one at the back.
+  // nullptr marks the end of a node.
+  std::vector<const Symbol*> pending{&node};
+  while (!pending.empty()) {
+    const Symbol* symbol = pending.back();
+    pending.pop_back();
+    if (symbol == nullptr) {
+      indent_ -= 2;
+      auto_indent() << "}" << std::endl;
+    } else if (symbol->Kind() != SymbolKind::kNode) {
+      symbol->Accept(this);  // leaf
+    } else {
+      const auto& subtree = *down_cast<const SyntaxTreeNode*>(symbol);
+      auto_indent() << "Node " << TagInfo(subtree) << "{" << std::endl;
+      indent_ += 2;
+      pending.push_back(nullptr);
+      const auto& children = subtree.children();
+      for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+        if (*iter != nullptr) pending.push_back(iter->get());
+      }
     }
   }
-  auto_indent() << "}" << std::endl;
 }
 
 std::ostream& RawTreePrinter::Print(std::ostream& stream) const {
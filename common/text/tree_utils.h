@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <iosfwd>
+#include <string>
 
 #include "absl/strings/string_view.h"
 #include "common/text/concrete_syntax_leaf.h"
@@ -174,9 +175,14 @@ class RawSymbolPrinter : public SymbolVisitor {
   explicit RawSymbolPrinter(std::ostream* stream) : stream_(stream) {}
 
   void Visit(const SyntaxTreeLeaf&) override;
+  // Prints the whole subtree, without recursion.  Leaves are printed by
+  // Visit(const SyntaxTreeLeaf&).
   void Visit(const SyntaxTreeNode&) override;
 
  protected:
+  // Returns the description of a node's tag that precedes its children.
+  virtual std::string TagInfo(const SyntaxTreeNode& node) const;
+
   // Output stream.
   std::ostream* stream_;
 
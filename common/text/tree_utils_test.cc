@@ -14,6 +14,8 @@
 
 #include "common/text/tree_utils.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <sstream>  // IWYU pragma: keep  // for ostringstream
 #include <string>
@@ -1196,5 +1198,64 @@ TEST(GetSubtreeAsLeafTest, GotNodeInsteadOfLeaf) {
   EXPECT_DEATH(GetSubtreeAsLeaf(*root, FakeEnum::kZero, 0), "");
 }
 
+// Depth at which recursive traversal would overflow the stack.
+constexpr size_t kDeepTreeDepth = 100000;
+
+// Printed output is indented by depth, so its size grows quadratically.
+constexpr size_t kDeepPrintedTreeDepth = 4000;
+
+TEST(DeepTreeTest, RawPrint) {
+  const auto tree = NestedNodes(kDeepPrintedTreeDepth, Leaf(1, "x"));
+  std::ostringstream stream;
+  stream << RawTreePrinter(*tree);
+  const std::string output(stream.str());
+  EXPECT_EQ(std::count(output.begin(), output.end(), '\n'),
+            2 * kDeepPrintedTreeDepth + 1);
+  EXPECT_EQ(output.find("Node {"), 0);
+}
+
+TEST(DeepTreeTest, PrettyPrint) {
+  constexpr absl::string_view text("x");
+  const auto tree = NestedNodes(kDeepPrintedTreeDepth, Leaf(1, text));
+  std::ostringstream stream;
+  PrettyPrintTree(*tree, TokenInfo::Context(text), &stream);
+  EXPECT_NE(stream.str().find("(#1 @0-1: \"x\")"), std::string::npos);
+}
+
+TEST(DeepTreeTest, FindFirstSubtree) {
+  auto tree = NestedNodes(kDeepTreeDepth, Leaf(1, "x"));
+  const Symbol* found = FindFirstSubtree(
+      tree.get(),
+      [](const Symbol& s) { return s.Kind() == SymbolKind::kLeaf; });
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->Tag().tag, 1);
+  EXPECT_EQ(FindFirstSubtree(tree.get(),
+                             [](const Symbol& s) { return s.Tag().tag < 0; }),
+            nullptr);
+}
+
+TEST(DeepTreeTest, FindFirstSubtreeMutable) {
+  auto tree = NestedNodes(kDeepTreeDepth, Leaf(1, "x"));
+  SymbolPtr* found = FindFirstSubtreeMutable(
+      &tree, [](const Symbol& s) { return s.Kind() == SymbolKind::kLeaf; });
+  ASSERT_NE(found, nullptr);
+  *found = nullptr;  // prune
+  EXPECT_EQ(FindFirstSubtreeMutable(&tree,
+                                    [](const Symbol& s) {
+                                      return s.Kind() == SymbolKind::kLeaf;
+                                    }),
+            nullptr);
+}
+
+TEST(DeepTreeTest, MutateLeaves) {
+  auto tree = NestedNodes(kDeepTreeDepth, Leaf(1, "x"));
+  MutateLeaves(&tree, [](TokenInfo* token) { token->token_enum = 7; });
+  const Symbol* leaf = FindFirstSubtree(
+      tree.get(),
+      [](const Symbol& s) { return s.Kind() == SymbolKind::kLeaf; });
+  ASSERT_NE(leaf, nullptr);
+  EXPECT_EQ(leaf->Tag().tag, 7);
+}
+
 }  // namespace
 }  // namespace verible
@@ -0,0 +1,35 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// AllocationCount() counts heap allocations, for tests of how work scales.
+// Unlike time, the count is deterministic, so it can be bounded tightly.
+//
+// Linking this library replaces the global operator new and delete of the
+// whole program with counting ones, so only tests and benchmarks should
+// depend on it.
+
+#ifndef VERIBLE_COMMON_UTIL_ALLOCATION_COUNTER_H_
+#define VERIBLE_COMMON_UTIL_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace verible {
+
+// Returns the number of calls to operator new (in all threads) so far.
+size_t AllocationCount();
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_ALLOCATION_COUNTER_H_
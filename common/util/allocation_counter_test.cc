@@ -0,0 +1,55 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/util/allocation_counter.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+TEST(AllocationCountTest, CountsNew) {
+  const size_t before = AllocationCount();
+  auto value = std::make_unique<int>(1);
+  EXPECT_EQ(AllocationCount(), before + 1);
+  value.reset();
+  EXPECT_EQ(AllocationCount(), before + 1);
+}
+
+TEST(AllocationCountTest, CountsContainerGrowth) {
+  std::vector<std::string> strings;
+  strings.reserve(100);
+  const size_t before = AllocationCount();
+  for (int i = 0; i < 100; ++i) {
+    // Longer than any small-string buffer.
+    strings.emplace_back(100, 'x');
+  }
+  EXPECT_EQ(AllocationCount(), before + 100);
+}
+
+TEST(AllocationCountTest, NoThrowNew) {
+  const size_t before = AllocationCount();
+  int* values = new (std::nothrow) int[8];
+  ASSERT_NE(values, nullptr);
+  delete[] values;
+  EXPECT_EQ(AllocationCount(), before + 1);
+}
+
+}  // namespace
+}  // namespace verible
@@ -0,0 +1,222 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/content_cache.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <ctime>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/util/file_util.h"
+#include "common/util/logging.h"
+
+namespace verible {
+
+// 128-bit FNV-1a parameters, from
+// http://www.isthe.com/chongo/tech/comp/fnv/index.html
+static constexpr unsigned __int128 kFnvOffsetBasis =
+    (static_cast<unsigned __int128>(0x6c62272e07bb0142ULL) << 64) |
+    0x62b821756295c58dULL;
+static constexpr unsigned __int128 kFnvPrime =
+    (static_cast<unsigned __int128>(0x0000000001000000ULL) << 64) |
+    0x000000000000013bULL;
+
+ContentHasher::ContentHasher() : state_(kFnvOffsetBasis) {}
+
+void ContentHasher::Mix(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    state_ ^= static_cast<unsigned char>(data[i]);
+    state_ *= kFnvPrime;
+  }
+}
+
+ContentHasher& ContentHasher::Add(absl::string_view data) {
+  // Prefix with the length in a fixed (little-endian) byte order.
+  uint64_t size = data.size();
+  char size_bytes[8];
+  for (char& byte : size_bytes) {
+    byte = static_cast<char>(size & 0xff);
+    size >>= 8;
+  }
+  Mix(size_bytes, sizeof(size_bytes));
+  Mix(data.data(), data.size());
+  return *this;
+}
+
+ContentHasher& ContentHasher::Add(int64_t value) {
+  return Add(absl::AlphaNum(value).Piece());
+}
+
+std::string ContentHasher::HexDigest() const {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  std::string digest(32, '0');
+  unsigned __int128 state = state_;
+  for (auto iter = digest.rbegin(); iter != digest.rend(); ++iter) {
+    *iter = kHexDigits[static_cast<int>(state & 0xf)];
+    state >>= 4;
+  }
+  return digest;
+}
+
+static bool IsValidKey(absl::string_view key) {
+  return !key.empty() && std::all_of(key.begin(), key.end(), [](char c) {
+    return absl::ascii_isalnum(c);
+  });
+}
+
+ContentCache::ContentCache(absl::string_view directory, size_t max_bytes)
+    : directory_(directory),
+      max_bytes_(max_bytes),
+      ok_(file::CreateDir(directory)) {}
+
+std::string ContentCache::EntryPath(absl::string_view key) const {
+  return file::JoinPath(directory_, key);
+}
+
+bool ContentCache::Lookup(absl::string_view key, std::string* value) const {
+  if (!ok_ || !IsValidKey(key)) return false;
+  const std::string path(EntryPath(key));
+  if (!file::GetContents(path, value)) return false;
+  // Refresh the modification time, which orders entries for eviction.
+  // Failure is harmless: the entry is just more likely to be evicted.
+  utimes(path.c_str(), nullptr);
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto found = entries_.find(key);
+  if (found != entries_.end()) {
+    recency_.splice(recency_.end(), recency_, found->second.recency);
+  }
+  return true;
+}
+
+bool ContentCache::Insert(absl::string_view key, absl::string_view value) {
+  if (!ok_ || !IsValidKey(key)) return false;
+  if (!file::SetContentsAtomically(EntryPath(key), value)) return false;
+  if (max_bytes_ == 0) return true;
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (inserts_until_rescan_ == 0) {
+    // The scan finds the new entry too.
+    RescanLocked();
+  } else {
+    --inserts_until_rescan_;
+    const auto found = entries_.find(key);
+    if (found != entries_.end()) {
+      total_bytes_ -= found->second.size;
+      recency_.erase(found->second.recency);
+      entries_.erase(found);
+    }
+    recency_.emplace_back(key);
+    entries_.emplace(std::string(key),
+                     Entry{value.size(), std::prev(recency_.end())});
+    total_bytes_ += value.size();
+  }
+  EvictLocked();
+  return true;
+}
+
+size_t ContentCache::Evict() {
+  if (!ok_ || max_bytes_ == 0) return 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  RescanLocked();
+  return EvictLocked();
+}
+
+// Temporary files older than this were abandoned by writers that died.
+static constexpr time_t kAbandonedTempFileSeconds = 3600;
+
+namespace {
+struct ScannedEntry {
+  std::string key;
+  size_t size;
+  struct timespec last_used;
+};
+}  // namespace
+
+void ContentCache::RescanLocked() {
+  recency_.clear();
+  entries_.clear();
+  total_bytes_ = 0;
+  DIR* dir = opendir(directory_.c_str());
+  if (dir == nullptr) return;
+  std::vector<ScannedEntry> scanned;
+  const time_t now = time(nullptr);
+  while (const struct dirent* dir_entry = readdir(dir)) {
+    const absl::string_view name(dir_entry->d_name);
+    if (name == "." || name == "..") continue;
+    const std::string path(EntryPath(name));
+    struct stat entry_stat;
+    // Entries may be concurrently removed by other processes.
+    if (stat(path.c_str(), &entry_stat) != 0) continue;
+    if (!S_ISREG(entry_stat.st_mode)) continue;
+    if (!IsValidKey(name)) {
+      // Writes in progress (see file::SetContentsAtomically()) are not
+      // entries yet.
+      if (absl::StrContains(name, ".tmp-") &&
+          now - entry_stat.st_mtime > kAbandonedTempFileSeconds) {
+        unlink(path.c_str());
+      }
+      continue;
+    }
+    scanned.push_back({std::string(name),
+                       static_cast<size_t>(entry_stat.st_size),
+                       entry_stat.st_mtim});
+  }
+  closedir(dir);
+
+  std::sort(scanned.begin(), scanned.end(),
+            [](const ScannedEntry& left, const ScannedEntry& right) {
+              if (left.last_used.tv_sec != right.last_used.tv_sec) {
+                return left.last_used.tv_sec < right.last_used.tv_sec;
+              }
+              return left.last_used.tv_nsec < right.last_used.tv_nsec;
+            });
+  for (auto& entry : scanned) {
+    recency_.push_back(std::move(entry.key));
+    entries_.emplace(recency_.back(),
+                     Entry{entry.size, std::prev(recency_.end())});
+    total_bytes_ += entry.size;
+  }
+  // Amortizes the cost of scans over the inserts between them.
+  inserts_until_rescan_ = entries_.size() + 1;
+}
+
+size_t ContentCache::EvictLocked() {
+  size_t removed = 0;
+  while (total_bytes_ > max_bytes_ && !recency_.empty()) {
+    const auto found = entries_.find(recency_.front());
+    const std::string path(EntryPath(found->first));
+    // Another process may have removed this entry already, which counts
+    // toward the bound just the same.
+    if (unlink(path.c_str()) == 0) ++removed;
+    VLOG(2) << "evicted cache entry: " << path;
+    total_bytes_ -= found->second.size;
+    entries_.erase(found);
+    recency_.pop_front();
+  }
+  return removed;
+}
+
+}  // namespace verible
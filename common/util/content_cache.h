@@ -0,0 +1,139 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_CONTENT_CACHE_H_
+#define VERIBLE_COMMON_UTIL_CONTENT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace verible {
+
+// ContentHasher computes a 128-bit FNV-1a digest over a sequence of values.
+// Unlike absl::Hash, the digest is stable across processes and builds, so it
+// is suitable as a key for data that persists on disk.
+//
+// Example:
+//   const std::string key =
+//       ContentHasher().Add(version).Add(options).Add(text).HexDigest();
+class ContentHasher {
+ public:
+  ContentHasher();
+
+  // Adds a string.  Each string is length-delimited, so that ("ab", "c")
+  // and ("a", "bc") produce different digests.
+  ContentHasher& Add(absl::string_view data);
+
+  ContentHasher& Add(int64_t value);
+
+  // Returns the digest as 32 lowercase hexadecimal characters.
+  std::string HexDigest() const;
+
+ private:
+  void Mix(const char* data, size_t size);
+
+  unsigned __int128 state_;
+};
+
+// ContentCache is a persistent key-value store of strings, kept in a local
+// directory with one file per entry.  Keys are expected to be digests of
+// everything that determines the value (see ContentHasher), which makes
+// entries immutable: a key is never associated with a different value.
+// Keys must be non-empty and alphanumeric, because they are used as file
+// names; operations on other keys fail.
+//
+// Several processes may share one cache directory.  Entries are written
+// atomically (to a temporary file, renamed into place), so readers only ever
+// see complete entries.  Entries that disappear due to concurrent eviction
+// are simply cache misses.  For the same reasons, a ContentCache may be used
+// concurrently from multiple threads.
+//
+// The total size of entries is bounded by evicting the least recently used
+// entries, where recency is tracked with file modification times.  To keep
+// inserts cheap, each instance tracks the entries it knows of in memory, and
+// only rescans the directory (to learn of other processes' entries) after
+// about as many inserts as there were entries at the last scan.
+// Temporary files of writes in progress are left alone, unless they are
+// old enough to have been abandoned.
+class ContentCache {
+ public:
+  // 'directory' is created if it does not already exist (its parent must).
+  // 'max_bytes' bounds the total size of all entries; 0 means unbounded.
+  ContentCache(absl::string_view directory, size_t max_bytes);
+
+  ContentCache(const ContentCache&) = delete;
+  ContentCache& operator=(const ContentCache&) = delete;
+
+  // Returns true if the cache directory exists and is usable.
+  bool ok() const { return ok_; }
+
+  // Returns true and sets 'value' if 'key' is in the cache.
+  // A hit marks the entry as most recently used.
+  bool Lookup(absl::string_view key, std::string* value) const;
+
+  // Stores 'value' under 'key', and evicts old entries if the cache exceeds
+  // its size bound.  Returns true on success.
+  bool Insert(absl::string_view key, absl::string_view value);
+
+  // Rescans the directory, and removes least recently used entries until the
+  // total size of entries is within bounds.  Returns the number of removed
+  // entries.
+  size_t Evict();
+
+ private:
+  struct Entry {
+    size_t size;
+
+    // Position in 'recency_'.
+    std::list<std::string>::iterator recency;
+  };
+
+  std::string EntryPath(absl::string_view key) const;
+
+  // Replaces the known entries with those in the directory.
+  void RescanLocked();
+
+  // Removes least recently used known entries until the total size of
+  // entries is within bounds.  Returns the number of removed entries.
+  size_t EvictLocked();
+
+  const std::string directory_;
+  const size_t max_bytes_;
+  bool ok_;
+
+  // Guards all fields below.
+  mutable std::mutex mutex_;
+
+  // Keys of known entries, least recently used first.
+  mutable std::list<std::string> recency_;
+
+  // Known entries, by key.
+  mutable std::map<std::string, Entry, std::less<>> entries_;
+
+  // Total size of known entries.
+  size_t total_bytes_ = 0;
+
+  // Number of inserts until the next rescan; 0 before the first one.
+  size_t inserts_until_rescan_ = 0;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_CONTENT_CACHE_H_
@@ -0,0 +1,185 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/content_cache.h"
+
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "common/util/file_util.h"
+
+namespace verible {
+namespace {
+
+TEST(ContentHasherTest, EmptyIsStable) {
+  EXPECT_EQ(ContentHasher().HexDigest(), ContentHasher().HexDigest());
+  EXPECT_EQ(ContentHasher().HexDigest().length(), 32);
+  // Without any input, the digest is the FNV offset basis.
+  EXPECT_EQ(ContentHasher().HexDigest(), "6c62272e07bb014262b821756295c58d");
+}
+
+TEST(ContentHasherTest, SameInputsSameDigest) {
+  EXPECT_EQ(ContentHasher().Add("abc").Add(12).HexDigest(),
+            ContentHasher().Add("abc").Add(12).HexDigest());
+}
+
+TEST(ContentHasherTest, DifferentInputsDifferentDigests) {
+  const std::string base = ContentHasher().Add("abc").HexDigest();
+  EXPECT_NE(base, ContentHasher().HexDigest());
+  EXPECT_NE(base, ContentHasher().Add("abd").HexDigest());
+  EXPECT_NE(base, ContentHasher().Add("abc").Add("").HexDigest());
+  EXPECT_NE(ContentHasher().Add(1).HexDigest(),
+            ContentHasher().Add(2).HexDigest());
+}
+
+TEST(ContentHasherTest, InputsAreDelimited) {
+  EXPECT_NE(ContentHasher().Add("ab").Add("c").HexDigest(),
+            ContentHasher().Add("a").Add("bc").HexDigest());
+  EXPECT_NE(ContentHasher().Add("abc").HexDigest(),
+            ContentHasher().Add("ab").Add("c").HexDigest());
+}
+
+// Returns a fresh cache directory path, unique to the calling test.
+static std::string TestCacheDir(absl::string_view name) {
+  const std::string dir =
+      file::JoinPath(testing::TempDir(), absl::StrCat("content_cache_", name));
+  // Clear out entries left behind by previous runs.
+  ContentCache(dir, 1).Evict();
+  return dir;
+}
+
+// Sets the last-used time of a cache entry.
+static void SetLastUsed(absl::string_view dir, absl::string_view key,
+                        time_t seconds) {
+  const struct timeval times[2] = {{seconds, 0}, {seconds, 0}};
+  ASSERT_EQ(utimes(file::JoinPath(dir, key).c_str(), times), 0);
+}
+
+TEST(ContentCacheTest, MissingDirectoryParent) {
+  ContentCache cache("/this/path/does/not/exist", 0);
+  EXPECT_FALSE(cache.ok());
+  std::string value;
+  EXPECT_FALSE(cache.Lookup("abc", &value));
+  EXPECT_FALSE(cache.Insert("abc", "def"));
+}
+
+TEST(ContentCacheTest, InsertThenLookup) {
+  ContentCache cache(TestCacheDir("insert"), 0);
+  ASSERT_TRUE(cache.ok());
+  std::string value;
+  EXPECT_FALSE(cache.Lookup("key1", &value));
+  EXPECT_TRUE(cache.Insert("key1", "value1"));
+  EXPECT_TRUE(cache.Insert("key2", ""));
+  EXPECT_TRUE(cache.Lookup("key1", &value));
+  EXPECT_EQ(value, "value1");
+  EXPECT_TRUE(cache.Lookup("key2", &value));
+  EXPECT_EQ(value, "");
+}
+
+TEST(ContentCacheTest, PersistsAcrossInstances) {
+  const std::string dir = TestCacheDir("persist");
+  EXPECT_TRUE(ContentCache(dir, 0).Insert("key", "value"));
+  std::string value;
+  EXPECT_TRUE(ContentCache(dir, 0).Lookup("key", &value));
+  EXPECT_EQ(value, "value");
+}
+
+TEST(ContentCacheTest, InvalidKeys) {
+  ContentCache cache(TestCacheDir("invalid"), 0);
+  std::string value;
+  for (const absl::string_view key : {"", ".", "..", "a/b", "../x", "a.b"}) {
+    EXPECT_FALSE(cache.Insert(key, "value")) << key;
+    EXPECT_FALSE(cache.Lookup(key, &value)) << key;
+  }
+}
+
+TEST(ContentCacheTest, EvictsLeastRecentlyUsed) {
+  const std::string dir = TestCacheDir("evict");
+  ContentCache cache(dir, 10);
+  EXPECT_TRUE(cache.Insert("a", "1234"));
+  EXPECT_TRUE(cache.Insert("b", "1234"));
+  SetLastUsed(dir, "a", 1000);
+  SetLastUsed(dir, "b", 2000);
+
+  // Using "a" makes "b" the least recently used.
+  std::string value;
+  EXPECT_TRUE(cache.Lookup("a", &value));
+  EXPECT_EQ(cache.Evict(), 0);  // within bounds
+
+  EXPECT_TRUE(cache.Insert("c", "1234"));  // over bounds: evicts "b"
+  EXPECT_TRUE(cache.Lookup("a", &value));
+  EXPECT_FALSE(cache.Lookup("b", &value));
+  EXPECT_TRUE(cache.Lookup("c", &value));
+}
+
+TEST(ContentCacheTest, EntryLargerThanBound) {
+  ContentCache cache(TestCacheDir("large"), 4);
+  EXPECT_TRUE(cache.Insert("key", "too large for the cache"));
+  std::string value;
+  EXPECT_FALSE(cache.Lookup("key", &value));
+}
+
+TEST(ContentCacheTest, TemporaryFiles) {
+  const std::string dir = TestCacheDir("temporary");
+  // A write in progress, and one that was abandoned long ago.
+  const std::string writing = file::JoinPath(dir, "a.tmp-123456");
+  const std::string abandoned = file::JoinPath(dir, "b.tmp-654321");
+  ASSERT_TRUE(file::SetContents(writing, "larger than the bound"));
+  ASSERT_TRUE(file::SetContents(abandoned, "larger than the bound"));
+  SetLastUsed(dir, "b.tmp-654321", 1000);
+
+  ContentCache cache(dir, 10);
+  EXPECT_EQ(cache.Evict(), 0);
+  std::string value;
+  EXPECT_TRUE(file::GetContents(writing, &value));
+  EXPECT_FALSE(file::GetContents(abandoned, &value));
+  // Temporary files do not count toward the bound.
+  EXPECT_TRUE(cache.Insert("key", "1234"));
+  EXPECT_TRUE(cache.Lookup("key", &value));
+}
+
+TEST(ContentCacheTest, ManyInserts) {
+  ContentCache cache(TestCacheDir("many"), 40);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(cache.Insert(absl::StrCat("key", i), "1234567890"));
+  }
+  // Only the 4 most recent entries fit.
+  std::string value;
+  for (int i = 0; i < 96; ++i) {
+    EXPECT_FALSE(cache.Lookup(absl::StrCat("key", i), &value)) << i;
+  }
+  for (int i = 96; i < 100; ++i) {
+    EXPECT_TRUE(cache.Lookup(absl::StrCat("key", i), &value)) << i;
+  }
+}
+
+TEST(ContentCacheTest, UnboundedNeverEvicts) {
+  const std::string dir = TestCacheDir("unbounded");
+  ContentCache cache(dir, 0);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(cache.Insert(absl::StrCat("key", i), "some value"));
+  }
+  EXPECT_EQ(cache.Evict(), 0);
+  std::string value;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(cache.Lookup(absl::StrCat("key", i), &value));
+  }
+}
+
+}  // namespace
+}  // namespace verible
@@ -14,6 +14,8 @@
 
 #include "common/util/file_util.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -38,6 +40,14 @@ absl::string_view Basename(absl::string_view filename) {
              : filename.substr(last_slash_pos + 1);
 }
 
+absl::string_view Dirname(absl::string_view filename) {
+  auto last_slash_pos = filename.find_last_of("/\\");
+
+  return last_slash_pos == absl::string_view::npos
+             ? absl::string_view(".")
+             : filename.substr(0, last_slash_pos);
+}
+
 absl::string_view Stem(absl::string_view filename) {
   auto last_dot_pos = filename.find_last_of('.');
 
@@ -69,6 +79,94 @@ bool SetContents(absl::string_view filename, absl::string_view content) {
   return true;
 }
 
+// Writes all of content to file descriptor, retrying on short writes.
+static bool WriteFully(int fd, absl::string_view content) {
+  const char* data = content.data();
+  size_t remaining = content.size();
+  while (remaining > 0) {
+    const ssize_t written = write(fd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += written;
+    remaining -= written;
+  }
+  return true;
+}
+
+// Overwrites the existing file 'path' in place, keeping its inode, links,
+// and owner.  Readers may see a partially written file.
+static bool SetContentsInPlace(const std::string& path,
+                               absl::string_view content) {
+  const int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+  if (fd < 0) return false;
+  bool ok = WriteFully(fd, content);
+  ok = (fsync(fd) == 0) && ok;
+  ok = (close(fd) == 0) && ok;
+  return ok;
+}
+
+// Flushes the directory entries of 'dir' to disk.
+static bool SyncDirectory(const std::string& dir) {
+  const int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) return false;
+  bool ok = fsync(fd) == 0;
+  ok = (close(fd) == 0) && ok;
+  return ok;
+}
+
+bool SetContentsAtomically(absl::string_view filename,
+                           absl::string_view content) {
+  // Replace the file that a symlink points to, not the symlink itself.
+  std::string path(filename);
+  char* resolved = realpath(path.c_str(), nullptr);
+  if (resolved != nullptr) {
+    path = resolved;
+    free(resolved);
+  }
+  struct stat original_stat;
+  const bool exists = stat(path.c_str(), &original_stat) == 0;
+  // Renaming would break the other hard links of the file.
+  if (exists && original_stat.st_nlink > 1) {
+    return SetContentsInPlace(path, content);
+  }
+
+  // Temporary file must be in the same directory (same filesystem)
+  // for rename() to be atomic.
+  std::string temp_path = absl::StrCat(path, ".tmp-XXXXXX");
+  const int fd = mkstemp(&temp_path[0]);
+  if (fd < 0) return false;
+
+  if (exists) {
+    // mkstemp creates files with mode 0600, owned by this process; carry
+    // over the original owner and permissions.  If the owner cannot be
+    // kept, write in place instead.
+    struct stat temp_stat;
+    const bool same_owner = fstat(fd, &temp_stat) == 0 &&
+                            temp_stat.st_uid == original_stat.st_uid &&
+                            temp_stat.st_gid == original_stat.st_gid;
+    if (!same_owner &&
+        fchown(fd, original_stat.st_uid, original_stat.st_gid) != 0) {
+      close(fd);
+      unlink(temp_path.c_str());
+      return SetContentsInPlace(path, content);
+    }
+  }
+  bool ok = WriteFully(fd, content);
+  // fchmod after fchown, which may clear set-user-ID and set-group-ID bits.
+  if (ok && exists) ok = fchmod(fd, original_stat.st_mode & 07777) == 0;
+  ok = (fsync(fd) == 0) && ok;
+  ok = (close(fd) == 0) && ok;
+  if (ok) ok = rename(temp_path.c_str(), path.c_str()) == 0;
+  if (!ok) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  // Make the rename itself durable.
+  return SyncDirectory(std::string(Dirname(path)));
+}
+
 std::string JoinPath(absl::string_view base, absl::string_view name) {
   return absl::StrCat(base, "/", name);
 }
@@ -30,6 +30,10 @@ namespace file {
 // empty string.
 absl::string_view Basename(absl::string_view filename);
 
+// Returns the part of the path before the final "/", or "." if there is no
+// "/" in the path.
+absl::string_view Dirname(absl::string_view filename);
+
 // Returns the part of the basename of path prior to the final ".".  If
 // there is no "." in the basename, this is equivalent to file::Basename(path).
 absl::string_view Stem(absl::string_view filename);
@@ -42,6 +46,18 @@ bool GetContents(absl::string_view filename, std::string *content);
 // TODO(hzeller): consider util::Status return ?
 bool SetContents(absl::string_view filename, absl::string_view content);
 
+// Replace file "filename" with given content, such that readers either see
+// the complete old content or the complete new content, never a partially
+// written file.  Content is written to a temporary file in the same directory,
+// which is then renamed over "filename", and the directory is synced.  If
+// "filename" is a symlink, the file it points to is replaced.  Permission bits
+// and owner of an existing "filename" are preserved.  If "filename" has other
+// hard links, or its owner cannot be preserved, it is overwritten in place
+// instead, which is not atomic.  On failure of the atomic replacement,
+// "filename" is left untouched.
+bool SetContentsAtomically(absl::string_view filename,
+                           absl::string_view content);
+
 // Join directory + filename
 std::string JoinPath(absl::string_view base, absl::string_view name);
 
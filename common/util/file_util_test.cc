@@ -14,6 +14,9 @@
 
 #include "common/util/file_util.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <string>
 
 #include "gtest/gtest.h"
@@ -30,6 +33,14 @@ TEST(FileUtil, Basename) {
   EXPECT_EQ(file::Basename(""), "");
 }
 
+TEST(FileUtil, Dirname) {
+  EXPECT_EQ(file::Dirname("/foo/bar/baz"), "/foo/bar");
+  EXPECT_EQ(file::Dirname("foo/bar/baz"), "foo/bar");
+  EXPECT_EQ(file::Dirname("/foo/bar/"), "/foo/bar");
+  EXPECT_EQ(file::Dirname("baz"), ".");
+  EXPECT_EQ(file::Dirname(""), ".");
+}
+
 TEST(FileUtil, Stem) {
   EXPECT_EQ(file::Stem(""), "");
   EXPECT_EQ(file::Stem("/foo/bar.baz"), "/foo/bar");
@@ -51,6 +62,77 @@ TEST(FileUtil, CreateDir) {
   EXPECT_EQ(test_content, read_back_content);
 }
 
+TEST(FileUtil, SetContentsAtomically) {
+  const std::string test_file =
+      file::JoinPath(testing::TempDir(), "atomic_write_test");
+  EXPECT_TRUE(file::SetContents(test_file, "old content, longer than new"));
+  chmod(test_file.c_str(), 0640);
+
+  EXPECT_TRUE(file::SetContentsAtomically(test_file, "new content"));
+  std::string read_back_content;
+  EXPECT_TRUE(file::GetContents(test_file, &read_back_content));
+  EXPECT_EQ(read_back_content, "new content");
+
+  // Permissions of the replaced file are preserved.
+  struct stat file_stat;
+  ASSERT_EQ(stat(test_file.c_str(), &file_stat), 0);
+  EXPECT_EQ(file_stat.st_mode & 0777, 0640);
+  unlink(test_file.c_str());
+}
+
+TEST(FileUtil, SetContentsAtomicallyNewFile) {
+  const std::string test_file =
+      file::JoinPath(testing::TempDir(), "atomic_write_new_file_test");
+  unlink(test_file.c_str());
+  EXPECT_TRUE(file::SetContentsAtomically(test_file, "fresh"));
+  std::string read_back_content;
+  EXPECT_TRUE(file::GetContents(test_file, &read_back_content));
+  EXPECT_EQ(read_back_content, "fresh");
+  unlink(test_file.c_str());
+}
+
+TEST(FileUtil, SetContentsAtomicallyThroughSymlink) {
+  const std::string target =
+      file::JoinPath(testing::TempDir(), "atomic_write_symlink_target");
+  const std::string link =
+      file::JoinPath(testing::TempDir(), "atomic_write_symlink");
+  EXPECT_TRUE(file::SetContents(target, "old"));
+  unlink(link.c_str());
+  ASSERT_EQ(symlink(target.c_str(), link.c_str()), 0);
+
+  EXPECT_TRUE(file::SetContentsAtomically(link, "new"));
+  struct stat link_stat;
+  ASSERT_EQ(lstat(link.c_str(), &link_stat), 0);
+  EXPECT_TRUE(S_ISLNK(link_stat.st_mode));
+  std::string read_back_content;
+  EXPECT_TRUE(file::GetContents(target, &read_back_content));
+  EXPECT_EQ(read_back_content, "new");
+  unlink(link.c_str());
+  unlink(target.c_str());
+}
+
+TEST(FileUtil, SetContentsAtomicallyKeepsHardLinks) {
+  const std::string test_file =
+      file::JoinPath(testing::TempDir(), "atomic_write_hard_link_test");
+  const std::string other_link =
+      file::JoinPath(testing::TempDir(), "atomic_write_hard_link_other");
+  EXPECT_TRUE(file::SetContents(test_file, "old"));
+  unlink(other_link.c_str());
+  ASSERT_EQ(link(test_file.c_str(), other_link.c_str()), 0);
+
+  EXPECT_TRUE(file::SetContentsAtomically(test_file, "new"));
+  std::string read_back_content;
+  EXPECT_TRUE(file::GetContents(other_link, &read_back_content));
+  EXPECT_EQ(read_back_content, "new");
+  unlink(other_link.c_str());
+  unlink(test_file.c_str());
+}
+
+TEST(FileUtil, SetContentsAtomicallyBadDirectory) {
+  EXPECT_FALSE(file::SetContentsAtomically(
+      file::JoinPath(testing::TempDir(), "no/such/dir/file"), "content"));
+}
+
 TEST(FileUtil, ScopedTestFile) {
   const absl::string_view test_content = "Hello World!";
   file::testing::ScopedTestFile test_file(testing::TempDir(), test_content);
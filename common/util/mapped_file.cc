@@ -0,0 +1,74 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/util/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/util/status.h"
+
+namespace verible {
+
+MappedFile::~MappedFile() { Unmap(); }
+
+void MappedFile::Unmap() {
+  if (size_ != 0) munmap(const_cast<void*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+util::Status MappedFile::Open(absl::string_view path) {
+  Unmap();
+  const std::string path_str(path);
+  const int fd = open(path_str.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return util::NotFoundError(
+        absl::StrCat("Cannot open ", path, ": ", strerror(errno)));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    const int error = errno;
+    close(fd);
+    return util::InternalError(
+        absl::StrCat("Cannot stat ", path, ": ", strerror(error)));
+  }
+  // Empty files cannot be mapped, and need not be.
+  if (file_stat.st_size > 0) {
+    void* data =
+        mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      close(fd);
+      return util::InternalError(
+          absl::StrCat("Cannot map ", path, ": ", strerror(error)));
+    }
+    data_ = data;
+    size_ = file_stat.st_size;
+  }
+  // The mapping remains valid after the file is closed.
+  close(fd);
+  return util::OkStatus();
+}
+
+}  // namespace verible
@@ -0,0 +1,58 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VERIBLE_COMMON_UTIL_MAPPED_FILE_H_
+#define VERIBLE_COMMON_UTIL_MAPPED_FILE_H_
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+#include "common/util/status.h"
+
+namespace verible {
+
+// MappedFile maps the contents of a file into memory, read-only, so that
+// large files can be read in place, and only the parts that are accessed
+// are paged in.  The mapping does not change if the file is replaced (e.g.
+// by renaming a new file over it), but it does if the file is modified in
+// place.
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile();
+
+  // Maps the file at 'path', replacing any previous mapping.
+  util::Status Open(absl::string_view path);
+
+  // Contents of the mapped file, valid as long as this object is, and until
+  // the next Open().  Empty if no file is mapped.
+  absl::string_view contents() const {
+    return absl::string_view(static_cast<const char*>(data_), size_);
+  }
+
+ private:
+  void Unmap();
+
+  const void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_MAPPED_FILE_H_
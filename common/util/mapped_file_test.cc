@@ -0,0 +1,65 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/util/mapped_file.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "common/util/file_util.h"
+
+namespace verible {
+namespace {
+
+TEST(MappedFileTest, MapsContents) {
+  const std::string path =
+      file::JoinPath(testing::TempDir(), "mapped_file_test");
+  ASSERT_TRUE(file::SetContents(path, "mapped contents"));
+  MappedFile mapped;
+  EXPECT_TRUE(mapped.contents().empty());
+  ASSERT_TRUE(mapped.Open(path).ok());
+  EXPECT_EQ(mapped.contents(), "mapped contents");
+}
+
+TEST(MappedFileTest, SurvivesReplacement) {
+  const std::string path =
+      file::JoinPath(testing::TempDir(), "mapped_file_replaced");
+  ASSERT_TRUE(file::SetContents(path, "old"));
+  MappedFile mapped;
+  ASSERT_TRUE(mapped.Open(path).ok());
+  ASSERT_TRUE(file::SetContentsAtomically(path, "new contents"));
+  EXPECT_EQ(mapped.contents(), "old");
+  ASSERT_TRUE(mapped.Open(path).ok());
+  EXPECT_EQ(mapped.contents(), "new contents");
+}
+
+TEST(MappedFileTest, EmptyFile) {
+  const std::string path = file::JoinPath(testing::TempDir(), "mapped_empty");
+  ASSERT_TRUE(file::SetContents(path, ""));
+  MappedFile mapped;
+  ASSERT_TRUE(mapped.Open(path).ok());
+  EXPECT_TRUE(mapped.contents().empty());
+}
+
+TEST(MappedFileTest, MissingFile) {
+  MappedFile mapped;
+  const auto status = mapped.Open(
+      file::JoinPath(testing::TempDir(), "mapped_file_does_not_exist"));
+  EXPECT_EQ(status.code(), util::StatusCode::kNotFound);
+  EXPECT_TRUE(mapped.contents().empty());
+}
+
+}  // namespace
+}  // namespace verible
@@ -0,0 +1,51 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/memory_usage.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <fstream>
+
+namespace verible {
+
+size_t PeakResidentMemoryBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  // Reported in bytes.
+  return usage.ru_maxrss;
+#else
+  // Reported in kilobytes.
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+size_t CurrentResidentMemoryBytes() {
+#ifdef __linux__
+  // The second field is the resident set size, in pages.
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages, resident_pages;
+  if (!(statm >> total_pages >> resident_pages)) return 0;
+  const long page_size = sysconf(_SC_PAGESIZE);
+  if (page_size <= 0) return 0;
+  return resident_pages * static_cast<size_t>(page_size);
+#else
+  return 0;
+#endif
+}
+
+}  // namespace verible
@@ -0,0 +1,34 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_MEMORY_USAGE_H_
+#define VERIBLE_COMMON_UTIL_MEMORY_USAGE_H_
+
+#include <cstddef>
+
+namespace verible {
+
+// Returns the largest amount of physical memory used by this process so far
+// (its peak resident set size), in bytes, or 0 if it is unavailable.
+// This covers the whole process: all threads, and all previous work.
+size_t PeakResidentMemoryBytes();
+
+// Returns the amount of physical memory currently used by this process
+// (its resident set size), in bytes, or 0 if it is unavailable.
+// Unlike the peak, this can shrink when memory is returned to the system.
+size_t CurrentResidentMemoryBytes();
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_MEMORY_USAGE_H_
@@ -0,0 +1,57 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/memory_usage.h"
+
+#include <cstddef>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+TEST(PeakResidentMemoryBytesTest, NonZero) {
+  EXPECT_GT(PeakResidentMemoryBytes(), 0);
+}
+
+TEST(PeakResidentMemoryBytesTest, GrowsWithUse) {
+  const size_t before = PeakResidentMemoryBytes();
+  // Touch every page of a large buffer, to make it resident.
+  constexpr size_t kSize = 64 << 20;
+  const std::unique_ptr<char[]> buffer(new char[kSize]);
+  for (size_t i = 0; i < kSize; i += 4096) buffer[i] = static_cast<char>(i);
+  const size_t after = PeakResidentMemoryBytes();
+  EXPECT_GE(after, before);
+  EXPECT_GE(after, kSize);
+  EXPECT_EQ(buffer[4096], static_cast<char>(4096));
+}
+
+TEST(CurrentResidentMemoryBytesTest, NotAbovePeak) {
+  const size_t current = CurrentResidentMemoryBytes();
+  EXPECT_LE(current, PeakResidentMemoryBytes());
+}
+
+TEST(CurrentResidentMemoryBytesTest, GrowsWithUse) {
+  const size_t before = CurrentResidentMemoryBytes();
+  if (before == 0) return;  // unavailable on this platform
+  constexpr size_t kSize = 64 << 20;
+  const std::unique_ptr<char[]> buffer(new char[kSize]);
+  for (size_t i = 0; i < kSize; i += 4096) buffer[i] = static_cast<char>(i);
+  EXPECT_GE(CurrentResidentMemoryBytes(), before + kSize / 2);
+  EXPECT_EQ(buffer[4096], static_cast<char>(4096));
+}
+
+}  // namespace
+}  // namespace verible
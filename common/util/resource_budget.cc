@@ -0,0 +1,78 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/resource_budget.h"
+
+#include <cstddef>
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "common/util/memory_usage.h"
+#include "common/util/status.h"
+
+namespace verible {
+
+constexpr int ResourceBudget::kPollInterval;
+
+ResourceBudget::ResourceBudget(absl::Duration time_limit,
+                               size_t memory_limit_bytes)
+    : time_limit_(time_limit),
+      deadline_(time_limit > absl::ZeroDuration() ? absl::Now() + time_limit
+                                                  : absl::InfiniteFuture()),
+      memory_limit_bytes_(memory_limit_bytes),
+      baseline_memory_bytes_(
+          memory_limit_bytes != 0 ? CurrentResidentMemoryBytes() : 0) {}
+
+ResourceBudget::Reason ResourceBudget::Check() const {
+  if (absl::Now() >= deadline_) return kTime;
+  if (memory_limit_bytes_ != 0) {
+    const size_t current = CurrentResidentMemoryBytes();
+    if (current > baseline_memory_bytes_ &&
+        current - baseline_memory_bytes_ > memory_limit_bytes_) {
+      return kMemory;
+    }
+  }
+  return kNone;
+}
+
+bool ResourceBudget::Exhausted() {
+  if (reason_.load(std::memory_order_relaxed) != kNone) return true;
+  if (polls_until_check_.fetch_sub(1, std::memory_order_relaxed) > 0) {
+    return false;
+  }
+  polls_until_check_.store(kPollInterval, std::memory_order_relaxed);
+  const Reason reason = Check();
+  if (reason == kNone) return false;
+  reason_.store(reason, std::memory_order_relaxed);
+  return true;
+}
+
+util::Status ResourceBudget::status() const {
+  switch (reason_.load(std::memory_order_relaxed)) {
+    case kTime:
+      return util::Status(
+          util::StatusCode::kDeadlineExceeded,
+          absl::StrCat("Ran out of time budget (",
+                       absl::FormatDuration(time_limit_), ")."));
+    case kMemory:
+      return util::ResourceExhaustedError(
+          absl::StrCat("Ran out of memory budget (",
+                       memory_limit_bytes_ >> 20, " MiB)."));
+    default:
+      return util::OkStatus();
+  }
+}
+
+}  // namespace verible
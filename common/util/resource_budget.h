@@ -0,0 +1,83 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ResourceBudget limits the time and memory spent on one unit of work, such
+// as analyzing one file, so that a single pathological input cannot stall a
+// whole batch.  Long-running loops poll Exhausted() and wind down as soon as
+// it returns true; callers then report status() instead of a result.
+//
+// Usage:
+//   ResourceBudget budget(absl::Milliseconds(500), 1 << 30);
+//   while (has_more_work()) {
+//     if (budget.Exhausted()) return budget.status();
+//     ...
+//   }
+
+#ifndef VERIBLE_COMMON_UTIL_RESOURCE_BUDGET_H_
+#define VERIBLE_COMMON_UTIL_RESOURCE_BUDGET_H_
+
+#include <atomic>
+#include <cstddef>
+
+#include "absl/time/time.h"
+#include "common/util/status.h"
+
+namespace verible {
+
+class ResourceBudget {
+ public:
+  // Number of calls to Exhausted() between looks at the clock and at memory
+  // usage.
+  static constexpr int kPollInterval = 1024;
+
+  // A budget without limits, which is never exhausted.
+  ResourceBudget() : ResourceBudget(absl::InfiniteDuration(), 0) {}
+
+  // Starts a budget that allows 'time_limit' from now, and growth of this
+  // process's resident memory by 'memory_limit_bytes' from now.
+  // A non-positive time limit, or a memory limit of 0, means unlimited.
+  // Memory is measured for the whole process, so when several budgets are
+  // in effect concurrently, each one also sees the others' usage.
+  ResourceBudget(absl::Duration time_limit, size_t memory_limit_bytes);
+
+  ResourceBudget(const ResourceBudget&) = delete;
+  ResourceBudget& operator=(const ResourceBudget&) = delete;
+
+  // Returns true once the budget has run out, and ever after.
+  // This is cheap enough to call in inner loops, and may be called
+  // concurrently from several threads.
+  bool Exhausted();
+
+  // Returns OK while the budget lasts, DeadlineExceeded after running out of
+  // time, or ResourceExhausted after running out of memory.
+  util::Status status() const;
+
+ private:
+  enum Reason { kNone, kTime, kMemory };
+
+  // Compares usage against the limits.
+  Reason Check() const;
+
+  const absl::Duration time_limit_;
+  const absl::Time deadline_;
+  const size_t memory_limit_bytes_;
+  const size_t baseline_memory_bytes_;
+
+  std::atomic<int> polls_until_check_{0};
+  std::atomic<Reason> reason_{kNone};
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_RESOURCE_BUDGET_H_
@@ -0,0 +1,85 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/resource_budget.h"
+
+#include <cstddef>
+#include <memory>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "common/util/memory_usage.h"
+#include "common/util/status.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+using util::StatusCode;
+
+TEST(ResourceBudgetTest, UnlimitedIsNeverExhausted) {
+  ResourceBudget budget;
+  for (int i = 0; i < 4 * ResourceBudget::kPollInterval; ++i) {
+    ASSERT_FALSE(budget.Exhausted());
+  }
+  EXPECT_TRUE(budget.status().ok());
+}
+
+TEST(ResourceBudgetTest, NonPositiveLimitsAreUnlimited) {
+  ResourceBudget budget(absl::ZeroDuration(), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  EXPECT_FALSE(budget.Exhausted());
+  EXPECT_TRUE(budget.status().ok());
+}
+
+TEST(ResourceBudgetTest, RunsOutOfTime) {
+  ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  // The first poll always looks at the clock.
+  EXPECT_TRUE(budget.Exhausted());
+  EXPECT_EQ(budget.status().code(), StatusCode::kDeadlineExceeded);
+}
+
+TEST(ResourceBudgetTest, ChecksTimePeriodically) {
+  ResourceBudget budget(absl::Milliseconds(1), 0);
+  EXPECT_FALSE(budget.Exhausted());
+  absl::SleepFor(absl::Milliseconds(2));
+  bool exhausted = false;
+  for (int i = 0; i <= ResourceBudget::kPollInterval && !exhausted; ++i) {
+    exhausted = budget.Exhausted();
+  }
+  EXPECT_TRUE(exhausted);
+  // Stays exhausted.
+  EXPECT_TRUE(budget.Exhausted());
+  EXPECT_EQ(budget.status().code(), StatusCode::kDeadlineExceeded);
+}
+
+TEST(ResourceBudgetTest, RunsOutOfMemory) {
+  if (CurrentResidentMemoryBytes() == 0) return;  // unavailable
+  ResourceBudget budget(absl::InfiniteDuration(), 1 << 20);
+  EXPECT_FALSE(budget.Exhausted());
+  constexpr size_t kSize = 64 << 20;
+  const std::unique_ptr<char[]> buffer(new char[kSize]);
+  for (size_t i = 0; i < kSize; i += 4096) buffer[i] = static_cast<char>(i);
+  bool exhausted = false;
+  for (int i = 0; i <= ResourceBudget::kPollInterval && !exhausted; ++i) {
+    exhausted = budget.Exhausted();
+  }
+  EXPECT_TRUE(exhausted);
+  EXPECT_EQ(budget.status().code(), StatusCode::kResourceExhausted);
+  EXPECT_EQ(buffer[4096], static_cast<char>(4096));
+}
+
+}  // namespace
+}  // namespace verible
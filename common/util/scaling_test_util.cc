@@ -0,0 +1,132 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/util/scaling_test_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "common/util/allocation_counter.h"
+
+namespace verible {
+namespace testing {
+
+std::vector<size_t> GeometricScales(size_t first, double ratio, int count) {
+  std::vector<size_t> scales;
+  double scale = first;
+  for (int i = 0; i < count; ++i) {
+    scales.push_back(static_cast<size_t>(std::round(scale)));
+    scale *= ratio;
+  }
+  return scales;
+}
+
+double FitGrowthExponent(const std::vector<std::pair<double, double>>& points) {
+  std::vector<std::pair<double, double>> logs;
+  for (const auto& point : points) {
+    if (point.first > 0 && point.second > 0) {
+      logs.emplace_back(std::log(point.first), std::log(point.second));
+    }
+  }
+  if (logs.empty()) return 0;
+  double mean_x = 0;
+  double mean_y = 0;
+  for (const auto& point : logs) {
+    mean_x += point.first;
+    mean_y += point.second;
+  }
+  mean_x /= logs.size();
+  mean_y /= logs.size();
+  double covariance = 0;
+  double variance = 0;
+  for (const auto& point : logs) {
+    covariance += (point.first - mean_x) * (point.second - mean_y);
+    variance += (point.first - mean_x) * (point.first - mean_x);
+  }
+  // Identical sizes leave the slope undefined.
+  if (variance < 1e-12) return 0;
+  return covariance / variance;
+}
+
+std::vector<ScalingSample> MeasureScaling(const ScalingWorkFactory& factory,
+                                          const std::vector<size_t>& scales,
+                                          int repetitions) {
+  std::vector<ScalingSample> samples;
+  for (const size_t scale : scales) {
+    ScalingSample sample;
+    for (int i = 0; i < std::max(repetitions, 1); ++i) {
+      // Each run gets freshly prepared work, which it may consume.
+      const ScalingWork work = factory(scale);
+      sample.size = work.size;
+      const size_t allocations = AllocationCount();
+      const auto start = std::chrono::steady_clock::now();
+      work.run();
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      sample.allocations = AllocationCount() - allocations;
+      if (i == 0 || elapsed.count() < sample.seconds) {
+        sample.seconds = elapsed.count();
+      }
+    }
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+bool TimeGrowthChecksEnabled() {
+  const char* value = std::getenv("VERIBLE_CHECK_SCALING_TIME");
+  return value != nullptr && *value != '\0' && std::strcmp(value, "0") != 0;
+}
+
+void ExpectGrowthWithin(absl::string_view name,
+                        const std::vector<ScalingSample>& samples,
+                        const GrowthLimits& limits) {
+  std::vector<std::pair<double, double>> times;
+  std::vector<std::pair<double, double>> allocations;
+  std::ostringstream table;
+  table << "size seconds allocations\n";
+  double slowest = 0;
+  for (const auto& sample : samples) {
+    slowest = std::max(slowest, sample.seconds);
+    times.emplace_back(sample.size, sample.seconds);
+    allocations.emplace_back(sample.size, sample.allocations);
+    table << sample.size << ' ' << sample.seconds << ' ' << sample.allocations
+          << '\n';
+  }
+  EXPECT_LE(FitGrowthExponent(allocations), limits.allocations)
+      << "Allocations of " << name << " grow too fast:\n"
+      << table.str();
+  if (TimeGrowthChecksEnabled()) {
+    EXPECT_LE(FitGrowthExponent(times), limits.time)
+        << "Time of " << name << " grows too fast:\n"
+        << table.str();
+  } else if (slowest >= kMinSecondsForDefaultTimeCheck) {
+    EXPECT_LE(FitGrowthExponent(times), kDefaultTimeGrowthLimit)
+        << "Time of " << name << " grows quadratically or worse:\n"
+        << table.str();
+  }
+}
+
+}  // namespace testing
+}  // namespace verible
@@ -0,0 +1,123 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Utilities for tests that guard against superlinear algorithms: they run
+// some work on inputs of geometrically growing sizes, fit the growth of its
+// time and heap allocations to a power law (cost ~ size^k), and check the
+// fitted exponents k.
+//
+// Allocation counts are deterministic, so their exponents are always
+// checked.  Timings depend on the machine and its load, so by default their
+// exponents are only held to kDefaultTimeGrowthLimit, which still rejects
+// quadratic growth.  The tighter limits of each test are checked when the
+// environment variable VERIBLE_CHECK_SCALING_TIME is set to a non-empty
+// value other than "0", e.g. with
+//   bazel test --test_env=VERIBLE_CHECK_SCALING_TIME=1 <target>
+//
+// Example:
+//   const auto samples = MeasureScaling(
+//       [](size_t n) {
+//         auto input = std::make_shared<std::string>(MakeInput(n));
+//         return ScalingWork{input->size(), [input]() { Process(*input); }};
+//       },
+//       GeometricScales(1000, 2, 4));
+//   ExpectGrowthWithin("Process", samples, kLinearGrowth);
+
+#ifndef VERIBLE_COMMON_UTIL_SCALING_TEST_UTIL_H_
+#define VERIBLE_COMMON_UTIL_SCALING_TEST_UTIL_H_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace verible {
+namespace testing {
+
+// Work prepared for one input.  Only 'run' is measured.
+struct ScalingWork {
+  // Size of the input, e.g. in bytes.
+  size_t size = 0;
+
+  std::function<void()> run;
+};
+
+// Prepares the work for an input built at scale 'n'.
+using ScalingWorkFactory = std::function<ScalingWork(size_t n)>;
+
+// Measurements of one ScalingWork.
+struct ScalingSample {
+  size_t size = 0;
+
+  // Fastest of the repeated runs.
+  double seconds = 0;
+
+  // Heap allocations of one run.
+  size_t allocations = 0;
+};
+
+// Upper limits of fitted growth exponents.
+struct GrowthLimits {
+  double time;
+  double allocations;
+};
+
+// Limits for work that should grow linearly, or as n log n.  They leave room
+// for timing noise, cache effects and lower-order terms, but not for a
+// quadratic term.  Allocation counts are exact, so their limits are tighter.
+constexpr GrowthLimits kLinearGrowth = {1.4, 1.15};
+constexpr GrowthLimits kLinearithmicGrowth = {1.5, 1.25};
+
+// Limit of time growth exponents that is checked by default.  It tolerates
+// noisy, shared machines, but a quadratic term that dominates over the
+// measured sizes still exceeds it.
+constexpr double kDefaultTimeGrowthLimit = 1.8;
+
+// Timings below this many seconds (of the slowest sample) are mostly noise,
+// and are not checked by default.
+constexpr double kMinSecondsForDefaultTimeCheck = 0.001;
+
+// Returns 'count' scales, starting at 'first', each 'ratio' times the one
+// before.
+std::vector<size_t> GeometricScales(size_t first, double ratio, int count);
+
+// Returns the exponent k of the power law cost = c * size^k that best fits
+// 'points' of (size, cost), by least squares on their logarithms.  Points
+// with a size or cost that is not positive are ignored; returns 0 if fewer
+// than two distinct sizes remain.
+double FitGrowthExponent(const std::vector<std::pair<double, double>>& points);
+
+// Prepares and runs the work for each of 'scales', 'repetitions' times.
+std::vector<ScalingSample> MeasureScaling(const ScalingWorkFactory& factory,
+                                          const std::vector<size_t>& scales,
+                                          int repetitions = 3);
+
+// Returns true if VERIBLE_CHECK_SCALING_TIME enables checks of time growth.
+bool TimeGrowthChecksEnabled();
+
+// Fits the growth of allocations and of time in 'samples', and expects them
+// within 'limits'.  Unless TimeGrowthChecksEnabled(), time is only expected
+// within kDefaultTimeGrowthLimit, and only if it is long enough to measure.
+// Failures print 'name' and all samples.
+void ExpectGrowthWithin(absl::string_view name,
+                        const std::vector<ScalingSample>& samples,
+                        const GrowthLimits& limits);
+
+}  // namespace testing
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_SCALING_TEST_UTIL_H_
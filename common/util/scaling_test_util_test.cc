@@ -0,0 +1,140 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/util/scaling_test_util.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace testing {
+namespace {
+
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+
+TEST(GeometricScalesTest, Doubling) {
+  EXPECT_THAT(GeometricScales(10, 2, 4), ElementsAre(10, 20, 40, 80));
+  EXPECT_TRUE(GeometricScales(10, 2, 0).empty());
+}
+
+// Returns (size, cost(size)) for sizes that double from 100.
+template <typename Cost>
+std::vector<std::pair<double, double>> Points(Cost cost) {
+  std::vector<std::pair<double, double>> points;
+  for (double size = 100; size <= 12800; size *= 2) {
+    points.emplace_back(size, cost(size));
+  }
+  return points;
+}
+
+TEST(FitGrowthExponentTest, PowerLaws) {
+  EXPECT_THAT(FitGrowthExponent(Points([](double n) { return 3 * n; })),
+              DoubleNear(1, 1e-9));
+  EXPECT_THAT(FitGrowthExponent(Points([](double n) { return n * n; })),
+              DoubleNear(2, 1e-9));
+  EXPECT_THAT(FitGrowthExponent(Points([](double n) { return 5.0; })),
+              DoubleNear(0, 1e-9));
+}
+
+TEST(FitGrowthExponentTest, DistinguishesLinearithmicFromQuadratic) {
+  const double linearithmic =
+      FitGrowthExponent(Points([](double n) { return n * std::log(n); }));
+  EXPECT_GT(linearithmic, 1);
+  EXPECT_LT(linearithmic, kLinearithmicGrowth.allocations);
+  // A small quadratic term still shows over this range.
+  EXPECT_GT(
+      FitGrowthExponent(Points([](double n) { return 100 * n + n * n / 10; })),
+      kLinearithmicGrowth.time);
+  // Quadratic growth fails even the default time check.
+  EXPECT_GT(FitGrowthExponent(Points([](double n) { return n * n; })),
+            kDefaultTimeGrowthLimit);
+  EXPECT_LT(linearithmic, kDefaultTimeGrowthLimit);
+}
+
+TEST(FitGrowthExponentTest, Degenerate) {
+  EXPECT_EQ(FitGrowthExponent({}), 0);
+  EXPECT_EQ(FitGrowthExponent({{10, 5}}), 0);
+  EXPECT_EQ(FitGrowthExponent({{10, 5}, {10, 50}}), 0);
+  // Zero costs are ignored.
+  EXPECT_THAT(FitGrowthExponent({{10, 0}, {10, 10}, {100, 100}}),
+              DoubleNear(1, 1e-9));
+}
+
+TEST(MeasureScalingTest, CountsAllocations) {
+  const auto samples = MeasureScaling(
+      [](size_t n) {
+        return ScalingWork{n, [n]() {
+                             std::vector<std::unique_ptr<int>> values;
+                             values.reserve(n);
+                             for (size_t i = 0; i < n; ++i) {
+                               values.push_back(std::make_unique<int>(i));
+                             }
+                           }};
+      },
+      GeometricScales(100, 4, 3), 2);
+  ASSERT_EQ(samples.size(), 3);
+  EXPECT_EQ(samples[0].size, 100);
+  EXPECT_EQ(samples[0].allocations, 101);
+  EXPECT_EQ(samples[2].size, 1600);
+  EXPECT_EQ(samples[2].allocations, 1601);
+  ExpectGrowthWithin("make_unique", samples, kLinearGrowth);
+}
+
+TEST(MeasureScalingTest, DetectsQuadraticAllocations) {
+  const auto samples = MeasureScaling(
+      [](size_t n) {
+        return ScalingWork{n, [n]() {
+                             std::vector<std::unique_ptr<int>> values;
+                             for (size_t i = 0; i < n * n / 100; ++i) {
+                               values.push_back(std::make_unique<int>(i));
+                             }
+                           }};
+      },
+      GeometricScales(100, 2, 4), 1);
+  std::vector<std::pair<double, double>> allocations;
+  for (const auto& sample : samples) {
+    allocations.emplace_back(sample.size, sample.allocations);
+  }
+  EXPECT_GT(FitGrowthExponent(allocations), 1.9);
+}
+
+TEST(TimeGrowthChecksEnabledTest, OptIn) {
+  const char* saved = std::getenv("VERIBLE_CHECK_SCALING_TIME");
+  const std::string saved_value = saved == nullptr ? "" : saved;
+  unsetenv("VERIBLE_CHECK_SCALING_TIME");
+  EXPECT_FALSE(TimeGrowthChecksEnabled());
+  setenv("VERIBLE_CHECK_SCALING_TIME", "0", 1);
+  EXPECT_FALSE(TimeGrowthChecksEnabled());
+  setenv("VERIBLE_CHECK_SCALING_TIME", "1", 1);
+  EXPECT_TRUE(TimeGrowthChecksEnabled());
+  if (saved == nullptr) {
+    unsetenv("VERIBLE_CHECK_SCALING_TIME");
+  } else {
+    setenv("VERIBLE_CHECK_SCALING_TIME", saved_value.c_str(), 1);
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace verible
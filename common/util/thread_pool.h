@@ -0,0 +1,84 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VERIBLE_COMMON_UTIL_THREAD_POOL_H_
+#define VERIBLE_COMMON_UTIL_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace verible {
+
+// ThreadPool runs scheduled work items on a fixed set of worker threads.
+// Work items are started in the order in which they were scheduled.
+// The destructor waits for all scheduled work to finish.
+//
+// Example:
+//   std::vector<Result> results(inputs.size());
+//   {
+//     ThreadPool pool(4);
+//     for (size_t i = 0; i < inputs.size(); ++i) {
+//       pool.Schedule([&, i]() { results[i] = Process(inputs[i]); });
+//     }
+//   }  // all work is done here
+class ThreadPool {
+ public:
+  // Starts 'num_threads' workers.  If 'num_threads' is 0, use the number
+  // of hardware threads available.
+  explicit ThreadPool(size_t num_threads);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Waits for all scheduled work to complete, then joins all workers.
+  ~ThreadPool();
+
+  // Enqueues a work item.  Work items must not throw.
+  void Schedule(std::function<void()> work);
+
+  // Blocks until every work item scheduled so far has completed.
+  void Wait();
+
+  size_t NumThreads() const { return workers_.size(); }
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+
+  // Guards all fields below.
+  std::mutex mutex_;
+
+  // Signals workers that work is available or that they should exit.
+  std::condition_variable work_available_;
+
+  // Signals Wait() that all work has completed.
+  std::condition_variable work_done_;
+
+  std::deque<std::function<void()>> queue_;
+
+  // Number of work items that are queued or currently running.
+  size_t pending_ = 0;
+
+  bool shutting_down_ = false;
+};
+
+}  // namespace verible
+
+#endif  // VERIBLE_COMMON_UTIL_THREAD_POOL_H_
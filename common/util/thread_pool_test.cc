@@ -0,0 +1,75 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/util/thread_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace verible {
+namespace {
+
+TEST(ThreadPoolTest, DefaultNumThreads) {
+  ThreadPool pool(0);
+  EXPECT_GE(pool.NumThreads(), 1);
+}
+
+TEST(ThreadPoolTest, NoWork) {
+  ThreadPool pool(3);
+  EXPECT_EQ(pool.NumThreads(), 3);
+  pool.Wait();  // returns immediately
+}
+
+TEST(ThreadPoolTest, DestructorCompletesAllWork) {
+  constexpr int kNumItems = 1000;
+  std::vector<int> results(kNumItems, 0);
+  {
+    ThreadPool pool(4);
+    for (int i = 0; i < kNumItems; ++i) {
+      pool.Schedule([&results, i]() { results[i] = i * i; });
+    }
+  }
+  for (int i = 0; i < kNumItems; ++i) {
+    EXPECT_EQ(results[i], i * i);
+  }
+}
+
+TEST(ThreadPoolTest, WaitCompletesAllWork) {
+  std::atomic<int> count(0);
+  ThreadPool pool(2);
+  for (int round = 1; round <= 3; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      pool.Schedule([&count]() { ++count; });
+    }
+    pool.Wait();
+    EXPECT_EQ(count, round * 100);
+  }
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsInScheduleOrder) {
+  std::vector<int> order;
+  {
+    ThreadPool pool(1);
+    for (int i = 0; i < 10; ++i) {
+      pool.Schedule([&order, i]() { order.push_back(i); });
+    }
+  }
+  EXPECT_THAT(order, ::testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+}
+
+}  // namespace
+}  // namespace verible
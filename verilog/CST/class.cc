@@ -0,0 +1,64 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/CST/class.h"
+
+#include <vector>
+
+#include "common/analysis/matcher/matcher.h"
+#include "common/analysis/matcher/matcher_builders.h"
+#include "common/analysis/syntax_tree_search.h"
+#include "common/text/concrete_syntax_leaf.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/token_info.h"
+#include "common/text/tree_utils.h"
+#include "common/util/logging.h"
+#include "verilog/CST/verilog_matchers.h"  // IWYU pragma: keep
+
+namespace verilog {
+
+std::vector<verible::TreeSearchMatch> FindAllClassDeclarations(
+    const verible::Symbol& root) {
+  return SearchSyntaxTree(root, NodekClassDeclaration());
+}
+
+static const verible::SyntaxTreeNode& GetClassHeader(
+    const verible::Symbol& s) {
+  return verible::GetSubtreeAsNode(s, NodeEnum::kClassDeclaration, 0,
+                                   NodeEnum::kClassHeader);
+}
+
+const verible::TokenInfo& GetClassNameToken(const verible::Symbol& s) {
+  const auto& name_leaf =
+      verible::GetSubtreeAsLeaf(GetClassHeader(s), NodeEnum::kClassHeader, 3);
+  return name_leaf.get();
+}
+
+const verible::TokenInfo* GetClassExtendsNameToken(const verible::Symbol& s) {
+  const verible::Symbol* extends =
+      verible::GetSubtreeAsSymbol(GetClassHeader(s), NodeEnum::kClassHeader, 5);
+  if (extends == nullptr) return nullptr;
+  // The base class follows the 'extends' keyword.
+  const verible::Symbol* base = ABSL_DIE_IF_NULL(verible::GetSubtreeAsSymbol(
+      *extends, NodeEnum::kExtendsList, 1));
+  const auto& base_node = verible::SymbolCastToNode(*base);
+  if (base_node.MatchesTag(NodeEnum::kQualifiedId)) {
+    // The last of the scoped names is the class.
+    base = ABSL_DIE_IF_NULL(base_node.children().back().get());
+  }
+  return &ABSL_DIE_IF_NULL(verible::GetLeftmostLeaf(*base))->get();
+}
+
+}  // namespace verilog
@@ -0,0 +1,79 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Unit tests for class-related concrete-syntax-tree functions.
+//
+// Testing strategy:
+// The point of these tests is to validate the structure that is assumed
+// about class declaration nodes and the structure that is actually
+// created by the parser, so test *should* use the parser-generated
+// syntax trees, as opposed to hand-crafted/mocked syntax trees.
+
+#include "verilog/CST/class.h"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/util/logging.h"
+#include "verilog/analysis/verilog_analyzer.h"
+
+#undef EXPECT_OK
+#define EXPECT_OK(value) EXPECT_TRUE((value).ok())
+
+namespace verilog {
+namespace {
+
+TEST(FindAllClassDeclarationsTest, EmptySource) {
+  VerilogAnalyzer analyzer("", "");
+  EXPECT_OK(analyzer.Analyze());
+  const auto& root = analyzer.Data().SyntaxTree();
+  EXPECT_TRUE(FindAllClassDeclarations(*ABSL_DIE_IF_NULL(root)).empty());
+}
+
+TEST(FindAllClassDeclarationsTest, NamesAndBaseClasses) {
+  VerilogAnalyzer analyzer(R"(
+class a;
+endclass
+package p;
+  class b extends a;
+  endclass
+endpackage
+module m;
+endmodule
+class c extends p::b;
+endclass
+class d #(int N = 1) extends q::base #(N);
+endclass
+)",
+                           "");
+  EXPECT_OK(analyzer.Analyze());
+  const auto& root = analyzer.Data().SyntaxTree();
+  std::vector<absl::string_view> names, bases;
+  for (const auto& declaration :
+       FindAllClassDeclarations(*ABSL_DIE_IF_NULL(root))) {
+    names.push_back(GetClassNameToken(*declaration.match).text);
+    const verible::TokenInfo* base =
+        GetClassExtendsNameToken(*declaration.match);
+    bases.push_back(base == nullptr ? "" : base->text);
+  }
+  EXPECT_THAT(names, testing::ElementsAre("a", "b", "c", "d"));
+  EXPECT_THAT(bases, testing::ElementsAre("", "a", "b", "base"));
+}
+
+}  // namespace
+}  // namespace verilog
@@ -14,6 +14,7 @@
 
 #include "verilog/CST/module.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "common/analysis/matcher/matcher.h"
@@ -24,6 +25,7 @@
 #include "common/text/symbol.h"
 #include "common/text/token_info.h"
 #include "common/text/tree_utils.h"
+#include "common/util/logging.h"
 #include "verilog/CST/verilog_matchers.h"  // IWYU pragma: keep
 
 namespace verilog {
@@ -46,4 +48,40 @@ const verible::TokenInfo& GetModuleNameToken(const verible::Symbol& s) {
   return name_leaf.get();
 }
 
+std::vector<verible::TreeSearchMatch> FindAllInterfaceDeclarations(
+    const verible::Symbol& root) {
+  return SearchSyntaxTree(root, NodekInterfaceDeclaration());
+}
+
+const verible::TokenInfo& GetInterfaceNameToken(const verible::Symbol& s) {
+  const auto& header_node = verible::GetSubtreeAsNode(
+      s, NodeEnum::kInterfaceDeclaration, 0, NodeEnum::kModuleHeader);
+  const auto& name_leaf =
+      verible::GetSubtreeAsLeaf(header_node, NodeEnum::kModuleHeader, 2);
+  return name_leaf.get();
+}
+
+std::vector<verible::TreeSearchMatch> FindAllModuleInstantiations(
+    const verible::Symbol& root) {
+  std::vector<verible::TreeSearchMatch> instantiations =
+      SearchSyntaxTree(root, NodekInstantiationBase());
+  // Only instances with port connections are kGateInstances.
+  instantiations.erase(
+      std::remove_if(instantiations.begin(), instantiations.end(),
+                     [](const verible::TreeSearchMatch& instantiation) {
+                       return SearchSyntaxTree(*instantiation.match,
+                                               NodekGateInstance())
+                           .empty();
+                     }),
+      instantiations.end());
+  return instantiations;
+}
+
+const verible::TokenInfo& GetModuleInstantiationTypeToken(
+    const verible::Symbol& s) {
+  const auto& type_node = verible::GetSubtreeAsNode(
+      s, NodeEnum::kInstantiationBase, 0, NodeEnum::kInstantiationType);
+  return ABSL_DIE_IF_NULL(verible::GetLeftmostLeaf(type_node))->get();
+}
+
 }  // namespace verilog
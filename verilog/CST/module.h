@@ -37,6 +37,24 @@ const verible::SyntaxTreeNode& GetModuleHeader(const verible::Symbol&);
 // Extract the subnode of a module declaration that is the module name.
 const verible::TokenInfo& GetModuleNameToken(const verible::Symbol&);
 
+// Find all interface declarations.
+std::vector<verible::TreeSearchMatch> FindAllInterfaceDeclarations(
+    const verible::Symbol&);
+
+// Extract the subnode of an interface declaration that is the interface name.
+const verible::TokenInfo& GetInterfaceNameToken(const verible::Symbol&);
+
+// Find all instantiations of modules or interfaces with port connections,
+// like "foo bar(...);".  Declarations without parentheses, like "foo bar;",
+// are indistinguishable from data declarations, and are not included.
+std::vector<verible::TreeSearchMatch> FindAllModuleInstantiations(
+    const verible::Symbol&);
+
+// Extract the name of the instantiated module (or interface) type from an
+// instantiation found by FindAllModuleInstantiations().
+const verible::TokenInfo& GetModuleInstantiationTypeToken(
+    const verible::Symbol&);
+
 }  // namespace verilog
 
 #endif  // VERIBLE_VERILOG_CST_MODULE_H_
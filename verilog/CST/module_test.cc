@@ -27,6 +27,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/text_structure.h"
@@ -113,5 +114,45 @@ TEST(GetModuleNameTokenTest, ValidModule) {
   EXPECT_EQ(token.text, "foo");
 }
 
+TEST(FindAllInterfaceDeclarationsTest, InterfacesOnly) {
+  VerilogAnalyzer analyzer(R"(
+interface i1;
+endinterface
+module m;
+endmodule
+interface i2(input clk);
+endinterface
+)",
+                           "");
+  EXPECT_OK(analyzer.Analyze());
+  const auto& root = analyzer.Data().SyntaxTree();
+  std::vector<absl::string_view> names;
+  for (const auto& interface :
+       FindAllInterfaceDeclarations(*ABSL_DIE_IF_NULL(root))) {
+    names.push_back(GetInterfaceNameToken(*interface.match).text);
+  }
+  EXPECT_THAT(names, testing::ElementsAre("i1", "i2"));
+}
+
+TEST(FindAllModuleInstantiationsTest, InstancesWithPorts) {
+  VerilogAnalyzer analyzer(R"(
+module m;
+  foo f1(a, b);
+  bar #(.W(4)) b1(.x(y)), b2();
+  logic l;
+  baz v;
+endmodule
+)",
+                           "");
+  EXPECT_OK(analyzer.Analyze());
+  const auto& root = analyzer.Data().SyntaxTree();
+  std::vector<absl::string_view> types;
+  for (const auto& instantiation :
+       FindAllModuleInstantiations(*ABSL_DIE_IF_NULL(root))) {
+    types.push_back(GetModuleInstantiationTypeToken(*instantiation.match).text);
+  }
+  EXPECT_THAT(types, testing::ElementsAre("foo", "bar"));
+}
+
 }  // namespace
 }  // namespace verilog
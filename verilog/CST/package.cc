@@ -39,4 +39,17 @@ const verible::TokenInfo& GetPackageNameToken(const verible::Symbol& s) {
   return name_node.get();
 }
 
+std::vector<verible::TreeSearchMatch> FindAllPackageImportItems(
+    const verible::Symbol& root) {
+  return SearchSyntaxTree(root, NodekPackageImportItem());
+}
+
+const verible::TokenInfo& GetImportedPackageNameToken(
+    const verible::Symbol& s) {
+  const auto& prefix_node = verible::GetSubtreeAsNode(
+      s, NodeEnum::kPackageImportItem, 0, NodeEnum::kScopePrefix);
+  return verible::GetSubtreeAsLeaf(prefix_node, NodeEnum::kScopePrefix, 0)
+      .get();
+}
+
 }  // namespace verilog
@@ -33,6 +33,14 @@ std::vector<verible::TreeSearchMatch> FindAllPackageDeclarations(
 // Extract the subnode of a package declaration that is the package name.
 const verible::TokenInfo& GetPackageNameToken(const verible::Symbol&);
 
+// Find all package import items, like "pkg::*" in "import pkg::*;".
+std::vector<verible::TreeSearchMatch> FindAllPackageImportItems(
+    const verible::Symbol&);
+
+// Extract the name of the imported package from a package import item.
+// For "export *::*;", this is "*".
+const verible::TokenInfo& GetImportedPackageNameToken(const verible::Symbol&);
+
 }  // namespace verilog
 
 #endif  // VERIBLE_VERILOG_CST_PACKAGE_H_
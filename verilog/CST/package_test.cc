@@ -27,6 +27,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/text_structure.h"
@@ -114,5 +115,24 @@ TEST(GetPackageNameTokenTest, ValidPackage) {
   EXPECT_EQ(token.text, "foo");
 }
 
+TEST(GetImportedPackageNameTokenTest, ImportItems) {
+  VerilogAnalyzer analyzer(R"(
+package p;
+  import q::*;
+endpackage
+module m;
+  import r::x, s::*;
+endmodule
+)",
+                           "");
+  EXPECT_OK(analyzer.Analyze());
+  const auto& root = analyzer.Data().SyntaxTree();
+  std::vector<absl::string_view> names;
+  for (const auto& item : FindAllPackageImportItems(*ABSL_DIE_IF_NULL(root))) {
+    names.push_back(GetImportedPackageNameToken(*item.match).text);
+  }
+  EXPECT_THAT(names, testing::ElementsAre("q", "r", "s"));
+}
+
 }  // namespace
 }  // namespace verilog
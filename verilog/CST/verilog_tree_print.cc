@@ -26,7 +26,6 @@
 #include "common/text/concrete_syntax_tree.h"
 #include "common/text/symbol.h"
 #include "common/text/token_info.h"
-#include "common/util/value_saver.h"
 #include "verilog/CST/verilog_nonterminals.h"  // for NodeEnumToString
 #include "verilog/parser/verilog_parser.h"  // for verilog_symbol_name
 
@@ -44,20 +43,10 @@ void VerilogPrettyPrinter::Visit(const verible::SyntaxTreeLeaf& leaf) {
   auto_indent() << verible::TokenWithContext{leaf.get(), context_} << std::endl;
 }
 
-void VerilogPrettyPrinter::Visit(const verible::SyntaxTreeNode& node) {
-  std::string tag_info = absl::StrCat(
+std::string VerilogPrettyPrinter::TagInfo(
+    const verible::SyntaxTreeNode& node) const {
+  return absl::StrCat(
       "(tag: ", NodeEnumToString(static_cast<NodeEnum>(node.Tag().tag)), ") ");
-
-  auto_indent() << "Node " << tag_info << "{" << std::endl;
-
-  {
-    const verible::ValueSaver<int> value_saver(&indent_, indent_ + 2);
-    for (const auto& child : node.children()) {
-      // TODO(fangism): display nullptrs or child indices to show position.
-      if (child) child->Accept(this);
-    }
-  }
-  auto_indent() << "}" << std::endl;
 }
 
 void PrettyPrintVerilogTree(const verible::Symbol& root, absl::string_view base,
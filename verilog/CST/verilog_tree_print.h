@@ -18,6 +18,7 @@
 #define VERIBLE_VERILOG_CST_VERILOG_TREE_PRINT_H_
 
 #include <iosfwd>
+#include <string>
 
 #include "common/text/concrete_syntax_leaf.h"
 #include "common/text/concrete_syntax_tree.h"
@@ -32,9 +33,11 @@ class VerilogPrettyPrinter : public verible::PrettyPrinter {
                                 absl::string_view base);
 
   void Visit(const verible::SyntaxTreeLeaf&) override;
-  void Visit(const verible::SyntaxTreeNode&) override;
+  using verible::PrettyPrinter::Visit;  // for SyntaxTreeNode
 
-  // void Visit(verible::SyntaxTreeNode*) override;
+ protected:
+  // Describes the node's tag by its NodeEnum name.
+  std::string TagInfo(const verible::SyntaxTreeNode&) const override;
 };
 
 // Prints tree contained at root to stream
@@ -0,0 +1,97 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/analysis_stats.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/text/flat_tree.h"
+#include "common/text/text_structure.h"
+#include "common/util/memory_usage.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/parser/verilog_token_enum.h"
+
+namespace verilog {
+
+using verible::FlatSyntaxTree;
+
+void AnalysisStats::RecordMemoryGrowth(absl::string_view phase,
+                                       size_t resident_bytes_before) {
+  const size_t resident_bytes_after = verible::CurrentResidentMemoryBytes();
+  memory_growth_bytes.emplace_back(
+      std::string(phase), static_cast<int64_t>(resident_bytes_after) -
+                              static_cast<int64_t>(resident_bytes_before));
+}
+
+AnalysisStats ComputeAnalysisStats(const VerilogAnalyzer& analyzer) {
+  const verible::TextStructureView& data = analyzer.Data();
+  AnalysisStats stats;
+  stats.bytes = data.Contents().size();
+  stats.raw_tokens = data.TokenStream().size();
+  stats.filtered_tokens = data.GetTokenStreamView().size();
+  stats.max_parser_stack = analyzer.MaxUsedStackSize();
+  stats.macro_definitions =
+      analyzer.PreprocessorData().macro_definitions.size();
+  for (const auto& token : data.GetTokenStreamView()) {
+    switch (token->token_enum) {
+      case MacroIdentifier:
+      case MacroCallId:
+      case MacroIdItem:
+        ++stats.macro_calls;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Measure the tree without recursion, since it may be very deep.
+  const FlatSyntaxTree tree(data.SyntaxTree().get());
+  std::vector<size_t> levels(tree.size());  // of each symbol, root is 1
+  for (FlatSyntaxTree::index_type i = 0; i < tree.size(); ++i) {
+    const auto parent = tree.Parent(i);
+    levels[i] = (parent == FlatSyntaxTree::kNone) ? 1 : levels[parent] + 1;
+    stats.tree_depth = std::max(stats.tree_depth, levels[i]);
+    if (tree.IsLeaf(i)) {
+      ++stats.tree_leaves;
+    } else {
+      ++stats.tree_nodes;
+    }
+  }
+  return stats;
+}
+
+std::ostream& operator<<(std::ostream& stream, const AnalysisStats& stats) {
+  stream << "bytes: " << stats.bytes << '\n'
+         << "raw_tokens: " << stats.raw_tokens << '\n'
+         << "filtered_tokens: " << stats.filtered_tokens << '\n'
+         << "tree_nodes: " << stats.tree_nodes << '\n'
+         << "tree_leaves: " << stats.tree_leaves << '\n'
+         << "tree_depth: " << stats.tree_depth << '\n'
+         << "max_parser_stack: " << stats.max_parser_stack << '\n'
+         << "macro_definitions: " << stats.macro_definitions << '\n'
+         << "macro_calls: " << stats.macro_calls << '\n';
+  for (const auto& phase : stats.memory_growth_bytes) {
+    stream << "memory_growth_bytes_in_" << phase.first << ": "
+           << phase.second << '\n';
+  }
+  return stream;
+}
+
+}  // namespace verilog
@@ -0,0 +1,81 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// AnalysisStats summarizes the size and shape of an analyzed file, to help
+// explain where time and memory go on large or unusual inputs.
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_ANALYSIS_STATS_H_
+#define VERIBLE_VERILOG_ANALYSIS_ANALYSIS_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "verilog/analysis/verilog_analyzer.h"
+
+namespace verilog {
+
+struct AnalysisStats {
+  // Size of the text.
+  size_t bytes = 0;
+
+  // Number of lexed tokens, including whitespace and comments.
+  size_t raw_tokens = 0;
+
+  // Number of tokens that remain after filtering (and preprocessing, when
+  // the file was parsed).
+  size_t filtered_tokens = 0;
+
+  // Number of nodes and leaves in the syntax tree.
+  size_t tree_nodes = 0;
+  size_t tree_leaves = 0;
+
+  // Number of levels in the syntax tree (0 without a tree).
+  size_t tree_depth = 0;
+
+  // Largest size of the parser's symbol stack.
+  size_t max_parser_stack = 0;
+
+  // Number of macro definitions, and of macro calls and references.
+  size_t macro_definitions = 0;
+  size_t macro_calls = 0;
+
+  // Change in resident memory over each phase of work, in the order in which
+  // they were recorded.  Unlike the process peak, this only covers the work
+  // on this file, even when several files are analyzed in one run.  Memory
+  // that was allocated and released within a phase is not seen, and the
+  // change is negative when a phase releases more than it allocates.
+  std::vector<std::pair<std::string, int64_t>> memory_growth_bytes;
+
+  // Records the change in resident memory under the name of a completed
+  // phase.  'resident_bytes_before' is the CurrentResidentMemoryBytes() of
+  // when the phase started.
+  void RecordMemoryGrowth(absl::string_view phase,
+                          size_t resident_bytes_before);
+};
+
+// Returns statistics about the results of 'analyzer', without any memory
+// records.
+AnalysisStats ComputeAnalysisStats(const VerilogAnalyzer& analyzer);
+
+// Prints one "name: value" line per statistic.
+std::ostream& operator<<(std::ostream&, const AnalysisStats&);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_ANALYSIS_STATS_H_
@@ -0,0 +1,73 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/analysis_stats.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/match.h"
+#include "verilog/analysis/verilog_analyzer.h"
+
+namespace verilog {
+namespace {
+
+TEST(ComputeAnalysisStatsTest, EmptyFile) {
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode("", "<file>");
+  const AnalysisStats stats = ComputeAnalysisStats(*analyzer);
+  EXPECT_EQ(stats.bytes, 0);
+  EXPECT_EQ(stats.raw_tokens, 1);  // EOF
+  EXPECT_EQ(stats.macro_definitions, 0);
+  EXPECT_EQ(stats.macro_calls, 0);
+  EXPECT_TRUE(stats.memory_growth_bytes.empty());
+}
+
+TEST(ComputeAnalysisStatsTest, Module) {
+  const char kCode[] =
+      "`define FOO 1\n"
+      "module m;  // comment\n"
+      "  wire w = `FOO;\n"
+      "endmodule\n";
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(kCode, "<file>");
+  ASSERT_TRUE(analyzer->ParseStatus().ok());
+  const AnalysisStats stats = ComputeAnalysisStats(*analyzer);
+  EXPECT_EQ(stats.bytes, sizeof(kCode) - 1);
+  EXPECT_GT(stats.raw_tokens, stats.filtered_tokens);
+  EXPECT_EQ(stats.macro_definitions, 1);
+  EXPECT_EQ(stats.macro_calls, 1);
+  EXPECT_GT(stats.tree_nodes, 0);
+  // Every leaf is a filtered token, but EOF is not a leaf.
+  EXPECT_GT(stats.tree_leaves, 0);
+  EXPECT_LT(stats.tree_leaves, stats.filtered_tokens);
+  EXPECT_GT(stats.tree_depth, 2);
+}
+
+TEST(AnalysisStatsTest, Print) {
+  AnalysisStats stats;
+  stats.bytes = 12;
+  stats.tree_depth = 3;
+  stats.RecordMemoryGrowth("analysis", 0);
+  ASSERT_EQ(stats.memory_growth_bytes.size(), 1);
+  EXPECT_EQ(stats.memory_growth_bytes.front().first, "analysis");
+  std::ostringstream stream;
+  stream << stats;
+  EXPECT_TRUE(absl::StrContains(stream.str(), "bytes: 12\n"));
+  EXPECT_TRUE(absl::StrContains(stream.str(), "tree_depth: 3\n"));
+  EXPECT_TRUE(
+      absl::StrContains(stream.str(), "memory_growth_bytes_in_analysis: "));
+}
+
+}  // namespace
+}  // namespace verilog
@@ -60,21 +60,22 @@ std::string ForbiddenSystemTaskFunctionRule::GetDescription(
 }
 
 // Set of invalid functions and suggested replacements
-const std::map<std::string, std::string>&
+const std::map<std::string, std::string, std::less<>>&
 ForbiddenSystemTaskFunctionRule::InvalidSymbolsMap() {
-  static const auto* invalid_symbols = new std::map<std::string, std::string>({
-      {"$psprintf", "$sformatf"},
-      {"$random", "$urandom"},
-      {"$srandom", "process::self().srandom()"},
-      // $dist_* functions (LRM 20.15.2)
-      {"$dist_chi_square", "$urandom"},
-      {"$dist_erlang", "$urandom"},
-      {"$dist_exponential", "$urandom"},
-      {"$dist_normal", "$urandom"},
-      {"$dist_poisson", "$urandom"},
-      {"$dist_t", "$urandom"},
-      {"$dist_uniform", "$urandom"},
-  });
+  static const auto* invalid_symbols =
+      new std::map<std::string, std::string, std::less<>>({
+          {"$psprintf", "$sformatf"},
+          {"$random", "$urandom"},
+          {"$srandom", "process::self().srandom()"},
+          // $dist_* functions (LRM 20.15.2)
+          {"$dist_chi_square", "$urandom"},
+          {"$dist_erlang", "$urandom"},
+          {"$dist_exponential", "$urandom"},
+          {"$dist_normal", "$urandom"},
+          {"$dist_poisson", "$urandom"},
+          {"$dist_t", "$urandom"},
+          {"$dist_uniform", "$urandom"},
+      });
   return *invalid_symbols;
 }
 
@@ -83,8 +84,8 @@ void ForbiddenSystemTaskFunctionRule::HandleSymbol(
   verible::matcher::BoundSymbolManager manager;
   if (matcher_.Matches(symbol, &manager)) {
     if (auto leaf = manager.GetAs<verible::SyntaxTreeLeaf>("name")) {
-      const auto& ism = InvalidSymbolsMap();
-      if (ism.find(std::string(leaf->get().text)) != ism.end()) {
+      // The transparent comparator finds the name without copying it.
+      if (InvalidSymbolsMap().count(leaf->get().text) != 0) {
         violations_.insert(
             verible::LintViolation(leaf->get(), FormatReason(*leaf), context));
       }
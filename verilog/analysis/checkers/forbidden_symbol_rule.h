@@ -15,6 +15,7 @@
 #ifndef VERIBLE_VERILOG_ANALYSIS_CHECKERS_FORBIDDEN_SYMBOL_RULE_H_
 #define VERIBLE_VERILOG_ANALYSIS_CHECKERS_FORBIDDEN_SYMBOL_RULE_H_
 
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
@@ -62,7 +63,8 @@ class ForbiddenSystemTaskFunctionRule : public verible::SyntaxTreeLintRule {
   static const char kTopic[];
 
   // Set of invalid functions and suggested replacements
-  static const std::map<std::string, std::string>& InvalidSymbolsMap();
+  static const std::map<std::string, std::string, std::less<>>&
+  InvalidSymbolsMap();
 
   const verible::matcher::Matcher matcher_ =
       SystemTFIdentifierLeaf().Bind("name");
@@ -49,6 +49,8 @@ class LineLengthRule : public verible::TextStructureLintRule {
 
   void Lint(const verible::TextStructureView&, absl::string_view) override;
 
+  bool NeedsSyntaxTree() const override { return false; }
+
   verible::LintRuleStatus Report() const override;
 
  private:
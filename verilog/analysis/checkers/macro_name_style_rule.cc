@@ -21,7 +21,7 @@
 #include "common/analysis/citation.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/token_stream_lint_rule.h"
-#include "common/strings/naming_utils.h"
+#include "common/text/identifier_table.h"
 #include "common/text/token_info.h"
 #include "verilog/analysis/descriptions.h"
 #include "verilog/analysis/lint_rule_registry.h"
@@ -31,6 +31,7 @@ namespace verilog {
 namespace analysis {
 
 using verible::GetStyleGuideCitation;
+using verible::IdentifierTable;
 using verible::LintRuleStatus;
 using verible::LintViolation;
 using verible::TokenInfo;
@@ -70,7 +71,7 @@ void MacroNameStyleRule::HandleToken(const TokenInfo& token) {
         case TK_SPACE:  // stay in the same state
           break;
         case PP_Identifier: {
-          if (!verible::IsNameAllCapsUnderscoresDigits(token.text))
+          if (!Identifiers().HasNamingStyle(token, IdentifierTable::kAllCaps))
             violations_.insert(LintViolation(token, kMessage));
           state_ = State::kNormal;
           break;
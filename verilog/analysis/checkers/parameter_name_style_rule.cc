@@ -22,7 +22,7 @@
 #include "common/analysis/citation.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/matcher/bound_symbol_manager.h"
-#include "common/strings/naming_utils.h"
+#include "common/text/identifier_table.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/token_info.h"
@@ -35,6 +35,7 @@ namespace verilog {
 namespace analysis {
 
 using verible::GetStyleGuideCitation;
+using verible::IdentifierTable;
 using verible::LintRuleStatus;
 using verible::LintViolation;
 using verible::SyntaxTreeContext;
@@ -72,14 +73,14 @@ void ParameterNameStyleRule::HandleSymbol(const verible::Symbol& symbol,
     else
       param_name_token = &GetParameterNameToken(symbol);
 
-    const auto param_name = param_name_token->text;
+    const uint8_t styles = Identifiers().NamingStylesOf(*param_name_token);
     if (param_decl_token == TK_localparam) {
-      if (!verible::IsUpperCamelCaseWithDigits(param_name))
+      if (!(styles & IdentifierTable::kUpperCamelCase))
         violations_.insert(
             LintViolation(*param_name_token, kLocalParamMessage, context));
     } else if (param_decl_token == TK_parameter) {
-      if (!verible::IsUpperCamelCaseWithDigits(param_name) &&
-          !verible::IsNameAllCapsUnderscoresDigits(param_name))
+      if (!(styles & (IdentifierTable::kUpperCamelCase |
+                      IdentifierTable::kAllCaps)))
         violations_.insert(
             LintViolation(*param_name_token, kParameterMessage, context));
     }
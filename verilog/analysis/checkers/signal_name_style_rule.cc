@@ -21,8 +21,8 @@
 #include "common/analysis/citation.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/matcher/bound_symbol_manager.h"
-#include "common/strings/naming_utils.h"
 #include "common/text/concrete_syntax_leaf.h"
+#include "common/text/identifier_table.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "common/text/token_info.h"
@@ -40,6 +40,7 @@ namespace analysis {
 VERILOG_REGISTER_LINT_RULE(SignalNameStyleRule);
 
 using verible::GetStyleGuideCitation;
+using verible::IdentifierTable;
 using verible::LintRuleStatus;
 using verible::LintViolation;
 using verible::SyntaxTreeContext;
@@ -64,22 +65,22 @@ void SignalNameStyleRule::HandleSymbol(const verible::Symbol& symbol,
   if (matcher_port_.Matches(symbol, &manager)) {
     const auto* identifier_leaf =
         GetIdentifierFromModulePortDeclaration(symbol);
-    const auto name = ABSL_DIE_IF_NULL(identifier_leaf)->get().text;
-    if (!verible::IsLowerSnakeCaseWithDigits(name))
+    if (!Identifiers().HasNamingStyle(ABSL_DIE_IF_NULL(identifier_leaf)->get(),
+                                      IdentifierTable::kLowerSnakeCase))
       violations_.insert(
           LintViolation(identifier_leaf->get(), kMessage, context));
   } else if (matcher_net_.Matches(symbol, &manager)) {
     const auto identifier_leaves = GetIdentifiersFromNetDeclaration(symbol);
     for (auto& leaf : identifier_leaves) {
-      const auto name = leaf->text;
-      if (!verible::IsLowerSnakeCaseWithDigits(name))
+      if (!Identifiers().HasNamingStyle(*leaf,
+                                        IdentifierTable::kLowerSnakeCase))
         violations_.insert(LintViolation(*leaf, kMessage, context));
     }
   } else if (matcher_data_.Matches(symbol, &manager)) {
     const auto identifier_leaves = GetIdentifiersFromDataDeclaration(symbol);
     for (auto& leaf : identifier_leaves) {
-      const auto name = leaf->text;
-      if (!verible::IsLowerSnakeCaseWithDigits(name))
+      if (!Identifiers().HasNamingStyle(*leaf,
+                                        IdentifierTable::kLowerSnakeCase))
         violations_.insert(LintViolation(*leaf, kMessage, context));
     }
   }
@@ -22,7 +22,7 @@
 #include "common/analysis/citation.h"
 #include "common/analysis/lint_rule_status.h"
 #include "common/analysis/matcher/bound_symbol_manager.h"
-#include "common/strings/naming_utils.h"
+#include "common/text/identifier_table.h"
 #include "common/text/symbol.h"
 #include "common/text/syntax_tree_context.h"
 #include "verilog/CST/type.h"
@@ -34,6 +34,7 @@ namespace analysis {
 VERILOG_REGISTER_LINT_RULE(StructUnionNameStyleRule);
 
 using verible::GetStyleGuideCitation;
+using verible::IdentifierTable;
 using verible::LintRuleStatus;
 using verible::LintViolation;
 using verible::SyntaxTreeContext;
@@ -73,7 +74,8 @@ void StructUnionNameStyleRule::HandleSymbol(const verible::Symbol& symbol,
     }
     const auto* identifier_leaf = GetIdentifierFromTypeDeclaration(symbol);
     const auto name = ABSL_DIE_IF_NULL(identifier_leaf)->get().text;
-    if (!verible::IsLowerSnakeCaseWithDigits(name) ||
+    if (!Identifiers().HasNamingStyle(identifier_leaf->get(),
+                                      IdentifierTable::kLowerSnakeCase) ||
         !absl::EndsWith(name, "_t")) {
       violations_.insert(LintViolation(identifier_leaf->get(), msg, context));
     }
@@ -14,17 +14,17 @@
 
 #include "verilog/analysis/lint_rule_registry.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "absl/container/node_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "common/analysis/line_lint_rule.h"
 #include "common/analysis/syntax_tree_lint_rule.h"
 #include "common/analysis/text_structure_lint_rule.h"
 #include "common/analysis/token_stream_lint_rule.h"
-#include "common/util/container_util.h"
 #include "common/util/logging.h"
 #include "verilog/analysis/descriptions.h"
 
@@ -35,17 +35,36 @@ using verible::LineLintRule;
 using verible::SyntaxTreeLintRule;
 using verible::TextStructureLintRule;
 using verible::TokenStreamLintRule;
-using verible::container::FindOrNull;
 
 namespace {
-// Used to export function local static pointer to avoid global variables
+// Returns the most recently registered rule of type RuleType.
+// This is a function-local pointer, which is constant-initialized, to avoid
+// depending on the order of static initialization.
 template <typename RuleType>
-absl::node_hash_map<LintRuleId, LintRuleInfo<RuleType>>* GetLintRuleRegistry() {
-  static auto* registry =
-      new absl::node_hash_map<LintRuleId, LintRuleInfo<RuleType>>();
-  return registry;
+const LintRuleRegisterer<RuleType>*& LastRegisteredRule() {
+  static const LintRuleRegisterer<RuleType>* last = nullptr;
+  return last;
 }
 
+// Becomes true when the rules of type RuleType are first looked up, after
+// which no more rules may be registered.
+template <typename RuleType>
+bool& RegistryIsSealed() {
+  static bool sealed = false;
+  return sealed;
+}
+
+// A registered rule, with its name.
+template <typename RuleType>
+struct NamedLintRule {
+  LintRuleId name;
+  const LintRuleEntry<RuleType>* entry;
+
+  bool operator<(const NamedLintRule& other) const {
+    return name < other.name;
+  }
+};
+
 // LintRuleRegistry is a template for interacting with lint rule registries.
 // It is expected to be implicitly instantiated for every LintRule type.
 template <typename RuleType>
@@ -54,79 +73,127 @@ class LintRuleRegistry {
   // Create and returns an instance of RuleType identified by rule.
   // Returns nullptr if rule is not registered.
   static std::unique_ptr<RuleType> CreateLintRule(const LintRuleId& rule) {
-    auto* create_func = FindOrNull(*GetLintRuleRegistry<RuleType>(), rule);
-    if (create_func == nullptr) {
-      return nullptr;
-    } else {
-      return (create_func->lint_rule_generator)();
-    }
+    const auto* entry = Find(rule);
+    if (entry == nullptr) return nullptr;
+    return entry->create();
   }
 
   // Returns true if registry holds a LintRule named rule.
   static bool ContainsLintRule(const LintRuleId& rule) {
-    const auto reg = GetLintRuleRegistry<RuleType>();
-    return reg->find(rule) != reg->end();
+    return Find(rule) != nullptr;
+  }
+
+  // Returns the registered name equal to 'rule', or an empty string_view.
+  static LintRuleId RegisteredName(const LintRuleId& rule) {
+    const auto& rules = SortedRules();
+    const auto iter = LowerBound(rule);
+    if (iter == rules.end() || iter->name != rule) return {};
+    return iter->name;
   }
 
   // Returns a sequence of registered rule names.
   static std::vector<LintRuleId> GetRegisteredRulesNames() {
-    const auto* registry = GetLintRuleRegistry<RuleType>();
+    const auto& rules = SortedRules();
     std::vector<LintRuleId> rule_ids;
-    rule_ids.reserve(registry->size());
-    for (const auto& rule_bundle : *registry) {
-      rule_ids.push_back(rule_bundle.first);
+    rule_ids.reserve(rules.size());
+    for (const auto& rule : rules) {
+      rule_ids.push_back(rule.name);
     }
     return rule_ids;
   }
 
-  // Registers a lint rule with the appropriate registry.
-  static void Register(const LintRuleId& rule,
-                       const LintRuleGenerator<RuleType>& creator,
-                       const LintDescription& descriptor) {
-    LintRuleInfo<RuleType> info;
-    info.lint_rule_generator = creator;
-    info.description = descriptor;
-    (*GetLintRuleRegistry<RuleType>())[rule] = info;
+  // Links a lint rule into the list of registered rules.
+  static const LintRuleRegisterer<RuleType>* Register(
+      const LintRuleRegisterer<RuleType>* registerer) {
+    CHECK(!RegistryIsSealed<RuleType>())
+        << "Lint rules must be registered before any are looked up.";
+    auto*& last = LastRegisteredRule<RuleType>();
+    const auto* previous = last;
+    last = registerer;
+    return previous;
   }
 
   // Returns the description of the specific rule, formatted for description
   // type passed in.
   static std::string GetRuleDescription(const LintRuleId& rule,
                                         DescriptionType description_type) {
-    auto* create_func = FindOrNull(*GetLintRuleRegistry<RuleType>(), rule);
-    return (ABSL_DIE_IF_NULL(create_func)->description)(description_type);
+    return ABSL_DIE_IF_NULL(Find(rule))->description(description_type);
   }
 
   // Adds each rule name and a struct of information describing the rule to the
   // map passed in.
   static void GetRegisteredRuleDescriptions(LintRuleDescriptionsMap* rule_map,
                                             DescriptionType description_type) {
-    const auto* registry = GetLintRuleRegistry<RuleType>();
-    for (const auto& rule_bundle : *registry) {
-      (*rule_map)[rule_bundle.first].description =
-          GetRuleDescription(rule_bundle.first, description_type);
+    for (const auto& rule : SortedRules()) {
+      (*rule_map)[rule.name].description =
+          rule.entry->description(description_type);
     }
   }
 
   LintRuleRegistry() = delete;
   LintRuleRegistry(const LintRuleRegistry&) = delete;
   LintRuleRegistry& operator=(const LintRuleRegistry&) = delete;
+
+ private:
+  // Returns all registered rules, sorted by name.  This is built on first
+  // use, which is the first time that any rule's Name() is called.
+  static const std::vector<NamedLintRule<RuleType>>& SortedRules() {
+    static const auto* rules = [] {
+      RegistryIsSealed<RuleType>() = true;
+      auto* sorted = new std::vector<NamedLintRule<RuleType>>;
+      for (const auto* registerer = LastRegisteredRule<RuleType>();
+           registerer != nullptr; registerer = registerer->Next()) {
+        const auto& entry = registerer->Entry();
+        sorted->push_back({entry.name(), &entry});
+      }
+      std::sort(sorted->begin(), sorted->end());
+      for (size_t i = 1; i < sorted->size(); ++i) {
+        CHECK_NE((*sorted)[i - 1].name, (*sorted)[i].name)
+            << "Lint rule registered more than once.";
+      }
+      return sorted;
+    }();
+    return *rules;
+  }
+
+  static typename std::vector<NamedLintRule<RuleType>>::const_iterator
+  LowerBound(const LintRuleId& rule) {
+    const auto& rules = SortedRules();
+    return std::lower_bound(rules.begin(), rules.end(), rule,
+                            [](const NamedLintRule<RuleType>& entry,
+                               const LintRuleId& name) {
+                              return entry.name < name;
+                            });
+  }
+
+  // Returns the entry of the rule named 'rule', or nullptr.
+  static const LintRuleEntry<RuleType>* Find(const LintRuleId& rule) {
+    const auto iter = LowerBound(rule);
+    if (iter == SortedRules().end() || iter->name != rule) return nullptr;
+    return iter->entry;
+  }
 };
 
 }  // namespace
 
 template <typename RuleType>
 LintRuleRegisterer<RuleType>::LintRuleRegisterer(
-    const LintRuleId& rule, const LintRuleGenerator<RuleType>& creator,
-    const LintDescription& descriptor) {
-  LintRuleRegistry<RuleType>::Register(rule, creator, descriptor);
-}
+    const LintRuleEntry<RuleType>& entry)
+    : entry_(entry), next_(LintRuleRegistry<RuleType>::Register(this)) {}
 
 bool IsRegisteredLintRule(const LintRuleId& rule_name) {
-  return LintRuleRegistry<SyntaxTreeLintRule>::ContainsLintRule(rule_name) ||
-         LintRuleRegistry<TokenStreamLintRule>::ContainsLintRule(rule_name) ||
-         LintRuleRegistry<LineLintRule>::ContainsLintRule(rule_name) ||
-         LintRuleRegistry<TextStructureLintRule>::ContainsLintRule(rule_name);
+  return !RegisteredLintRuleName(rule_name).empty();
+}
+
+LintRuleId RegisteredLintRuleName(absl::string_view rule_name) {
+  for (const LintRuleId name :
+       {LintRuleRegistry<SyntaxTreeLintRule>::RegisteredName(rule_name),
+        LintRuleRegistry<TokenStreamLintRule>::RegisteredName(rule_name),
+        LintRuleRegistry<LineLintRule>::RegisteredName(rule_name),
+        LintRuleRegistry<TextStructureLintRule>::RegisteredName(rule_name)}) {
+    if (!name.empty()) return name;
+  }
+  return {};
 }
 
 // The following functions are LintRule-type-specific:
@@ -183,6 +250,27 @@ std::set<LintRuleId> GetAllRegisteredLintRuleNames() {
   return result;
 }
 
+std::string GetLintRuleDescription(const LintRuleId& rule_name,
+                                   DescriptionType description_type) {
+  if (LintRuleRegistry<SyntaxTreeLintRule>::ContainsLintRule(rule_name)) {
+    return LintRuleRegistry<SyntaxTreeLintRule>::GetRuleDescription(
+        rule_name, description_type);
+  }
+  if (LintRuleRegistry<TokenStreamLintRule>::ContainsLintRule(rule_name)) {
+    return LintRuleRegistry<TokenStreamLintRule>::GetRuleDescription(
+        rule_name, description_type);
+  }
+  if (LintRuleRegistry<LineLintRule>::ContainsLintRule(rule_name)) {
+    return LintRuleRegistry<LineLintRule>::GetRuleDescription(
+        rule_name, description_type);
+  }
+  if (LintRuleRegistry<TextStructureLintRule>::ContainsLintRule(rule_name)) {
+    return LintRuleRegistry<TextStructureLintRule>::GetRuleDescription(
+        rule_name, description_type);
+  }
+  return "";
+}
+
 // TODO(fangism): Look at dependency tree between descriptions.h and
 // verilog_linter.cc so we can combine these two functions to just take in a
 // DescriptionType.
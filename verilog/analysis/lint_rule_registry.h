@@ -28,7 +28,6 @@
 #ifndef VERIBLE_VERILOG_ANALYSIS_LINT_RULE_REGISTRY_H_
 #define VERIBLE_VERILOG_ANALYSIS_LINT_RULE_REGISTRY_H_
 
-#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -46,21 +45,28 @@
 namespace verilog {
 namespace analysis {
 
-template <typename RuleType>
-class LintRuleRegisterer;
-
 using LintRuleId = absl::string_view;
 
 template <typename RuleType>
-using LintRuleGenerator = std::function<std::unique_ptr<RuleType>()>;
-using LintDescription = std::function<std::string(DescriptionType)>;
+using LintRuleFactory = std::unique_ptr<RuleType> (*)();
+using LintDescription = std::string (*)(DescriptionType);
 
+// Static information about one lint rule.  Entries only hold pointers to
+// functions, so that they are constant-initialized, and nothing about a rule
+// is computed until it is looked up.
 template <typename RuleType>
-struct LintRuleInfo {
-  LintRuleGenerator<RuleType> lint_rule_generator;
+struct LintRuleEntry {
+  absl::string_view (*name)();
+  LintRuleFactory<RuleType> create;
   LintDescription description;
 };
 
+// Creates an instance of lint rule class RuleClass.
+template <typename RuleClass>
+std::unique_ptr<typename RuleClass::rule_type> MakeLintRule() {
+  return std::unique_ptr<typename RuleClass::rule_type>(new RuleClass());
+}
+
 struct LintRuleDescriptionInfo {
   std::string description;
   bool default_enabled = false;
@@ -89,38 +95,58 @@ using LintRuleDescriptionsMap =
 // (in my_lint_rule.cc):
 // VERILOG_REGISTER_LINT_RULE(MyLintRule);
 //
-// Name() needs to be a function and not a constant to guarantee proper
-// string initialization (from first invocation during static global
-// initialization, when registration happens), and must be backed by string
-// memory with guaranteed lifetime.  e.g.
+// Registration only links a constant LintRuleEntry into a list, which keeps
+// process startup cheap: Name() is first called when rules are looked up,
+// and rules are only constructed when they are enabled.
+//
+// Name() must be backed by string memory with guaranteed lifetime, e.g.
 //
 // absl::string_view MyLintRule::Name() {
 //   return "my-lint-rule";  // safely initialized function-local string literal
 // }
 //
-#define VERILOG_REGISTER_LINT_RULE(class_name)                               \
-  static verilog::analysis::LintRuleRegisterer<class_name::rule_type>        \
-      __##class_name##__registerer(                                          \
-          class_name::Name(),                                                \
-          []() {                                                             \
-            return std::unique_ptr<class_name::rule_type>(new class_name()); \
-          },                                                                 \
-          class_name::GetDescription);
+#define VERILOG_REGISTER_LINT_RULE(class_name)                             \
+  static constexpr verilog::analysis::LintRuleEntry<class_name::rule_type> \
+      __##class_name##__entry = {                                          \
+          &class_name::Name,                                               \
+          &verilog::analysis::MakeLintRule<class_name>,                    \
+          &class_name::GetDescription,                                     \
+  };                                                                       \
+  static verilog::analysis::LintRuleRegisterer<class_name::rule_type>      \
+      __##class_name##__registerer(__##class_name##__entry);
 
 // Static objects of type LintRuleRegisterer are used to register concrete
 // parsers in LintRuleRegistry. Users are expected to create these objects
 // using the VERILOG_REGISTER_LINT_RULE macro.
+// Each registerer is a node of an intrusive list of the registered rules of
+// one RuleType, so registration does not allocate.  All rules must be
+// registered (during static initialization) before any rule is looked up.
 template <typename RuleType>
 class LintRuleRegisterer {
  public:
-  LintRuleRegisterer(const LintRuleId& rule,
-                     const LintRuleGenerator<RuleType>& creator,
-                     const LintDescription& descriptor);
+  explicit LintRuleRegisterer(const LintRuleEntry<RuleType>& entry);
+
+  LintRuleRegisterer(const LintRuleRegisterer&) = delete;
+  LintRuleRegisterer& operator=(const LintRuleRegisterer&) = delete;
+
+  const LintRuleEntry<RuleType>& Entry() const { return entry_; }
+
+  // Previously registered rule, or nullptr.
+  const LintRuleRegisterer* Next() const { return next_; }
+
+ private:
+  const LintRuleEntry<RuleType>& entry_;
+  const LintRuleRegisterer* next_;
 };
 
 // Returns true if rule_name refers to a known lint rule.
 bool IsRegisteredLintRule(const LintRuleId& rule_name);
 
+// Returns the registered name that equals 'rule_name', or an empty
+// string_view if there is no such rule.  Unlike 'rule_name', the result has
+// guaranteed lifetime.
+LintRuleId RegisteredLintRuleName(absl::string_view rule_name);
+
 // Returns sequence of syntax tree rule names.
 std::vector<LintRuleId> RegisteredSyntaxTreeRulesNames();
 
@@ -154,6 +180,11 @@ std::unique_ptr<verible::TextStructureLintRule> CreateTextStructureLintRule(
 // this set, because their lifetime is guaranteed by the registration process.
 std::set<LintRuleId> GetAllRegisteredLintRuleNames();
 
+// Returns the description of a registered rule, formatted for
+// 'description_type', or an empty string if there is no such rule.
+std::string GetLintRuleDescription(const LintRuleId& rule_name,
+                                   DescriptionType description_type);
+
 // Returns a map mapping each rule to a struct of information about the rule to
 // print.
 LintRuleDescriptionsMap GetAllRuleDescriptionsHelpFlag();
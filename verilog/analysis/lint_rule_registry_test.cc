@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
@@ -237,6 +238,38 @@ TEST(GetAllRuleDescriptionsHelpFlagTest, TextRuleValid) {
   EXPECT_EQ(it->second.description, "TextRule1");
 }
 
+// Verifies that registered names are the ones returned by the rules.
+TEST(RegisteredLintRuleNameTest, ReturnsRegisteredName) {
+  const std::string name("test-rule-2");  // different storage
+  const LintRuleId registered = RegisteredLintRuleName(name);
+  EXPECT_EQ(registered, name);
+  EXPECT_EQ(registered.data(), TreeRule2::Name().data());
+  EXPECT_EQ(RegisteredLintRuleName("line-rule-1").data(),
+            LineRule1::Name().data());
+}
+
+// Verifies that unknown names are not found.
+TEST(RegisteredLintRuleNameTest, UnknownName) {
+  EXPECT_TRUE(RegisteredLintRuleName("invalid-id").empty());
+  EXPECT_TRUE(RegisteredLintRuleName("").empty());
+}
+
+// Verifies that rule names are listed in sorted order.
+TEST(LintRuleRegistryTest, RuleNamesSorted) {
+  const auto names = RegisteredSyntaxTreeRulesNames();
+  EXPECT_EQ(names, std::vector<LintRuleId>({"test-rule-1", "test-rule-2"}));
+}
+
+// Verifies that one rule can be described without describing all of them.
+TEST(GetLintRuleDescriptionTest, OneRule) {
+  EXPECT_EQ(GetLintRuleDescription("token-rule-1", DescriptionType::kMarkdown),
+            "TokenRule1");
+  EXPECT_EQ(GetLintRuleDescription("text-rule-1", DescriptionType::kMarkdown),
+            "TextRule1");
+  EXPECT_EQ(GetLintRuleDescription("invalid-id", DescriptionType::kMarkdown),
+            "");
+}
+
 }  // namespace
 }  // namespace analysis
 }  // namespace verilog
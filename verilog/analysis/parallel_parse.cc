@@ -0,0 +1,184 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/parallel_parse.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/lexer/token_stream_adapter.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/symbol.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/casts.h"
+#include "common/util/logging.h"
+#include "common/util/thread_pool.h"
+#include "verilog/CST/verilog_nonterminals.h"
+#include "verilog/parser/verilog_parser.h"
+#include "verilog/parser/verilog_token_enum.h"
+
+namespace verilog {
+
+using verible::ConcreteSyntaxTree;
+using verible::SyntaxTreeNode;
+using verible::TokenStreamView;
+
+// Number of pieces per thread, which evens out the load when design units
+// vary in size.
+static constexpr size_t kPiecesPerThread = 4;
+
+// Returns true if tokens[i] starts a module declaration (which has a
+// matching endmodule), as opposed to an extern module prototype.
+static bool IsModuleStart(const TokenStreamView& tokens, size_t i) {
+  const int token_enum = tokens[i]->token_enum;
+  if (token_enum != TK_module && token_enum != TK_macromodule) return false;
+  return i == 0 || tokens[i - 1]->token_enum != TK_extern;
+}
+
+// Returns true if tokens[i] immediately follows "endmodule" or
+// "endmodule : label".
+static bool FollowsEndmodule(const TokenStreamView& tokens, size_t i) {
+  if (i >= 1 && tokens[i - 1]->token_enum == TK_endmodule) return true;
+  return i >= 3 && tokens[i - 3]->token_enum == TK_endmodule &&
+         tokens[i - 2]->token_enum == ':';
+}
+
+std::vector<size_t> FindDesignUnitBoundaries(const TokenStreamView& tokens) {
+  std::vector<size_t> boundaries;
+  int module_depth = 0;
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    switch (tokens[i]->token_enum) {
+      case PP_ifdef:
+      case PP_ifndef:
+      case PP_elsif:
+      case PP_else:
+      case PP_endif:
+        // Conditionals may enclose several design units, or split one.
+        return {};
+      case TK_endmodule:
+        if (--module_depth < 0) return {};  // unbalanced
+        break;
+      default:
+        if (IsModuleStart(tokens, i)) {
+          if (module_depth == 0 && i > 0 && FollowsEndmodule(tokens, i)) {
+            boundaries.push_back(i);
+          }
+          ++module_depth;
+        }
+        break;
+    }
+  }
+  if (module_depth != 0) return {};  // unbalanced
+  return boundaries;
+}
+
+// Groups design units into about 'num_pieces' pieces of similar numbers of
+// tokens.  Returns the start index of each piece after the first.
+static std::vector<size_t> ChoosePieceBoundaries(
+    const std::vector<size_t>& boundaries, size_t num_tokens,
+    size_t num_pieces) {
+  std::vector<size_t> piece_boundaries;
+  const size_t target_size = std::max<size_t>(num_tokens / num_pieces, 1);
+  size_t piece_start = 0;
+  for (const size_t boundary : boundaries) {
+    if (boundary - piece_start >= target_size) {
+      piece_boundaries.push_back(boundary);
+      piece_start = boundary;
+    }
+  }
+  return piece_boundaries;
+}
+
+namespace {
+// Result of parsing one piece of the token stream.
+struct ParsedPiece {
+  bool ok = false;
+  ConcreteSyntaxTree root;
+  size_t max_used_stack_size = 0;
+};
+}  // namespace
+
+static void ParsePiece(const TokenStreamView& piece, ParsedPiece* result) {
+  auto generator = verible::MakeTokenViewer(piece);
+  VerilogParser parser(&generator);
+  result->ok = parser.Parse().ok();
+  result->root = parser.TakeRoot();
+  result->max_used_stack_size = parser.MaxUsedStackSize();
+}
+
+bool ParseDesignUnitsConcurrently(const TokenStreamView& tokens,
+                                  size_t num_threads, ConcreteSyntaxTree* root,
+                                  size_t* max_used_stack_size) {
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  const std::vector<size_t> boundaries = FindDesignUnitBoundaries(tokens);
+  const std::vector<size_t> piece_boundaries = ChoosePieceBoundaries(
+      boundaries, tokens.size(), num_threads * kPiecesPerThread);
+  if (piece_boundaries.empty()) return false;  // nothing to gain
+  VLOG(1) << "Parsing " << piece_boundaries.size() + 1 << " pieces on "
+          << num_threads << " threads.";
+
+  // Each parser gets its own view of a contiguous slice of the stream.
+  // The last piece includes the EOF token of the whole stream.
+  std::vector<TokenStreamView> pieces;
+  pieces.reserve(piece_boundaries.size() + 1);
+  size_t piece_start = 0;
+  for (const size_t boundary : piece_boundaries) {
+    pieces.emplace_back(tokens.begin() + piece_start,
+                        tokens.begin() + boundary);
+    piece_start = boundary;
+  }
+  pieces.emplace_back(tokens.begin() + piece_start, tokens.end());
+
+  std::vector<ParsedPiece> results(pieces.size());
+  {
+    verible::ThreadPool pool(std::min(num_threads, pieces.size()));
+    for (size_t i = 0; i < pieces.size(); ++i) {
+      pool.Schedule([&pieces, &results, i]() {
+        ParsePiece(pieces[i], &results[i]);
+      });
+    }
+  }  // waits for all pieces
+
+  // Every piece must parse cleanly into a list of descriptions.  Otherwise,
+  // the serial parser's error recovery could have produced a different tree.
+  for (const auto& result : results) {
+    if (!result.ok || result.root == nullptr ||
+        result.root->Kind() != verible::SymbolKind::kNode ||
+        !verible::down_cast<const SyntaxTreeNode*>(result.root.get())
+             ->MatchesTag(NodeEnum::kDescriptionList)) {
+      VLOG(1) << "Piece did not parse cleanly, falling back to serial parse.";
+      return false;
+    }
+  }
+
+  // Stitch all descriptions together under the first piece's root.
+  ConcreteSyntaxTree stitched(std::move(results.front().root));
+  auto* description_list = verible::down_cast<SyntaxTreeNode*>(stitched.get());
+  size_t max_stack = results.front().max_used_stack_size;
+  for (auto iter = results.begin() + 1; iter != results.end(); ++iter) {
+    description_list->AppendChild(verible::ForwardChildren(iter->root));
+    max_stack = std::max(max_stack, iter->max_used_stack_size);
+  }
+  *root = std::move(stitched);
+  *max_used_stack_size = max_stack;
+  return true;
+}
+
+}  // namespace verilog
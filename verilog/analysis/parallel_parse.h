@@ -0,0 +1,59 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Concurrent parsing of large files that consist of many top-level design
+// units, such as generated gate-level netlists.
+//
+// A sequence of top-level descriptions parses into a kDescriptionList node
+// whose children are the descriptions, and each description is parsed
+// independently of its neighbors.  Splitting the token stream between
+// descriptions, parsing the pieces with independent parsers, and
+// concatenating the resulting lists yields the same tree as parsing the
+// whole stream at once.
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_PARALLEL_PARSE_H_
+#define VERIBLE_VERILOG_ANALYSIS_PARALLEL_PARSE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/token_stream_view.h"
+
+namespace verilog {
+
+// Returns the indices into 'tokens' of top-level module declarations that
+// immediately follow the end of another top-level module declaration.
+// These are safe places to split the stream for parsing.
+// Returns no indices if any split would be ambiguous, which is the case when
+// the stream contains preprocessor conditionals (which may span design
+// units), or unbalanced module/endmodule keywords (e.g. hidden in macros).
+std::vector<size_t> FindDesignUnitBoundaries(
+    const verible::TokenStreamView& tokens);
+
+// Parses 'tokens' (already preprocessed and contextualized) in pieces split
+// at design unit boundaries, on up to 'num_threads' threads (0 means all
+// hardware threads), and stitches the results under one kDescriptionList.
+// Returns true and sets 'root' and 'max_used_stack_size' on success.
+// Returns false without modifying its outputs if the stream cannot be split,
+// or if any piece has a syntax error; callers should then parse serially,
+// so that error recovery and diagnostics are the same as usual.
+bool ParseDesignUnitsConcurrently(const verible::TokenStreamView& tokens,
+                                  size_t num_threads,
+                                  verible::ConcreteSyntaxTree* root,
+                                  size_t* max_used_stack_size);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_PARALLEL_PARSE_H_
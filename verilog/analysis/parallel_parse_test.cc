@@ -0,0 +1,240 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/analysis/parallel_parse.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "common/lexer/token_stream_adapter.h"
+#include "common/text/concrete_syntax_tree.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/text/tree_compare.h"
+#include "verilog/parser/verilog_parser.h"
+#include "verilog/parser/verilog_token_enum.h"
+
+namespace verilog {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+using verible::TokenInfo;
+using verible::TokenSequence;
+using verible::TokenStreamView;
+
+// Holds a sequence of tokens (ending with EOF), and a view of all of them.
+class TokenStream {
+ public:
+  explicit TokenStream(std::initializer_list<TokenInfo> tokens)
+      : tokens_(tokens) {
+    tokens_.push_back(TokenInfo::EOFToken());
+    verible::InitTokenStreamView(tokens_, &view_);
+  }
+
+  const TokenStreamView& View() const { return view_; }
+
+ private:
+  TokenSequence tokens_;
+  TokenStreamView view_;
+};
+
+// Token stream for: module <name>; endmodule
+std::vector<TokenInfo> ModuleTokens(absl::string_view name) {
+  return {{TK_module, "module"},
+          {SymbolIdentifier, name},
+          {';', ";"},
+          {TK_endmodule, "endmodule"}};
+}
+
+TEST(FindDesignUnitBoundariesTest, Empty) {
+  const TokenStream stream({});
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), IsEmpty());
+}
+
+TEST(FindDesignUnitBoundariesTest, OneModule) {
+  const TokenStream stream({
+      {TK_module, "module"},
+      {SymbolIdentifier, "m"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+  });
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), IsEmpty());
+}
+
+TEST(FindDesignUnitBoundariesTest, ConsecutiveModules) {
+  const TokenStream stream({
+      {TK_module, "module"},  // 0
+      {SymbolIdentifier, "m"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {TK_macromodule, "macromodule"},  // 4
+      {SymbolIdentifier, "n"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {':', ":"},
+      {SymbolIdentifier, "n"},
+      {TK_module, "module"},  // 10
+      {SymbolIdentifier, "p"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+  });
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), ElementsAre(4, 10));
+}
+
+TEST(FindDesignUnitBoundariesTest, NotAfterOtherDescriptions) {
+  const TokenStream stream({
+      {TK_module, "module"},  // 0
+      {SymbolIdentifier, "m"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {TK_parameter, "parameter"},  // 4
+      {SymbolIdentifier, "P"},
+      {'=', "="},
+      {TK_DecNumber, "1"},
+      {';', ";"},
+      {TK_module, "module"},  // 9
+      {SymbolIdentifier, "n"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+  });
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), IsEmpty());
+}
+
+TEST(FindDesignUnitBoundariesTest, NestedModules) {
+  const TokenStream stream({
+      {TK_module, "module"},  // 0
+      {SymbolIdentifier, "outer"},
+      {';', ";"},
+      {TK_module, "module"},  // 3
+      {SymbolIdentifier, "inner1"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {TK_module, "module"},  // 7: nested, not a boundary
+      {SymbolIdentifier, "inner2"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {TK_endmodule, "endmodule"},
+      {TK_module, "module"},  // 12
+      {SymbolIdentifier, "m"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+  });
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), ElementsAre(12));
+}
+
+TEST(FindDesignUnitBoundariesTest, PreprocessorConditional) {
+  const TokenStream stream({
+      {TK_module, "module"},
+      {SymbolIdentifier, "m"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {PP_ifdef, "`ifdef"},
+      {PP_Identifier, "FOO"},
+      {TK_module, "module"},
+      {SymbolIdentifier, "n"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+      {PP_endif, "`endif"},
+  });
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), IsEmpty());
+}
+
+TEST(FindDesignUnitBoundariesTest, Unbalanced) {
+  const TokenStream stream({
+      {MacroIdentifier, "`MODULE_HEADER"},
+      {TK_endmodule, "endmodule"},
+      {TK_module, "module"},
+      {SymbolIdentifier, "n"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+  });
+  EXPECT_THAT(FindDesignUnitBoundaries(stream.View()), IsEmpty());
+}
+
+// Returns a stream of consecutive modules with the given names.
+TokenSequence ManyModules(const std::vector<std::string>& names) {
+  TokenSequence tokens;
+  for (const auto& name : names) {
+    for (const auto& token : ModuleTokens(name)) tokens.push_back(token);
+  }
+  tokens.push_back(TokenInfo::EOFToken());
+  return tokens;
+}
+
+verible::ConcreteSyntaxTree ParseSerially(const TokenStreamView& view) {
+  auto generator = verible::MakeTokenViewer(view);
+  VerilogParser parser(&generator);
+  EXPECT_TRUE(parser.Parse().ok());
+  return parser.TakeRoot();
+}
+
+TEST(ParseDesignUnitsConcurrentlyTest, SameTreeAsSerial) {
+  constexpr size_t kModules = 50;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < kModules; ++i) {
+    names.push_back("m" + std::to_string(i));
+  }
+  const TokenSequence tokens(ManyModules(names));
+  TokenStreamView view;
+  verible::InitTokenStreamView(tokens, &view);
+
+  const verible::ConcreteSyntaxTree serial_tree = ParseSerially(view);
+  for (const size_t num_threads : {2, 3, 8}) {
+    verible::ConcreteSyntaxTree tree;
+    size_t max_stack = 0;
+    ASSERT_TRUE(ParseDesignUnitsConcurrently(view, num_threads, &tree,
+                                             &max_stack));
+    EXPECT_TRUE(verible::EqualTrees(serial_tree.get(), tree.get()))
+        << "threads: " << num_threads;
+  }
+}
+
+TEST(ParseDesignUnitsConcurrentlyTest, SyntaxErrorFallsBack) {
+  const TokenSequence tokens{
+      {TK_module, "module"},       {SymbolIdentifier, "m"},
+      {';', ";"},                  {TK_endmodule, "endmodule"},
+      {TK_module, "module"},       {SymbolIdentifier, "n"},
+      {TK_endmodule, "endmodule"},  // missing ';'
+      TokenInfo::EOFToken(),
+  };
+  TokenStreamView view;
+  verible::InitTokenStreamView(tokens, &view);
+  verible::ConcreteSyntaxTree tree;
+  size_t max_stack = 0;
+  EXPECT_FALSE(ParseDesignUnitsConcurrently(view, 2, &tree, &max_stack));
+  EXPECT_EQ(tree, nullptr);
+  EXPECT_EQ(max_stack, 0);
+}
+
+TEST(ParseDesignUnitsConcurrentlyTest, SingleModuleNotSplit) {
+  const TokenStream stream({
+      {TK_module, "module"},
+      {SymbolIdentifier, "m"},
+      {';', ";"},
+      {TK_endmodule, "endmodule"},
+  });
+  verible::ConcreteSyntaxTree tree;
+  size_t max_stack = 0;
+  EXPECT_FALSE(ParseDesignUnitsConcurrently(stream.View(), 4, &tree,
+                                            &max_stack));
+  EXPECT_EQ(tree, nullptr);
+}
+
+}  // namespace
+}  // namespace verilog
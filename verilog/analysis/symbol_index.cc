@@ -0,0 +1,419 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verilog/analysis/symbol_index.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/util/content_cache.h"
+#include "common/util/file_util.h"
+#include "common/util/status.h"
+#include "common/util/thread_pool.h"
+
+namespace verilog {
+
+// Serialized index, in native byte order:
+//   Header
+//   FileRecord[num_files], ordered by path
+//   SymbolRecord[num_symbols], grouped by file, in the order of files
+//   uint32_t[num_symbols], indices of symbol records ordered by name
+//   char[strings_size], texts referenced by StringRef, without separators
+//
+// Change kMagic whenever the format, or what is extracted from files,
+// changes: indexes with a different magic are not read, so nothing of them
+// is reused.
+static constexpr char kMagic[8] = {'V', 'S', 'Y', 'M', 'I', 'D', 'X', '1'};
+
+namespace {
+
+struct Header {
+  char magic[8];
+  uint32_t num_files;
+  uint32_t num_symbols;
+  uint32_t strings_size;
+  uint32_t reserved;
+};
+
+struct StringRef {
+  uint32_t offset;
+  uint32_t size;
+};
+
+struct FileRecord {
+  StringRef path;
+  StringRef digest;
+  uint32_t first_symbol;
+  uint32_t num_symbols;
+};
+
+// Bits of SymbolRecord::flags above the IndexedSymbolKind.
+constexpr uint32_t kDefinitionFlag = 0x100;
+
+struct SymbolRecord {
+  StringRef name;
+  uint32_t file;
+  uint32_t line;
+  uint32_t column;
+  uint32_t flags;
+};
+
+constexpr size_t kFilesOffset = sizeof(Header);
+
+// Records are copied out, because data need not be aligned.
+template <typename T>
+T ReadRecord(absl::string_view data, size_t offset) {
+  T record;
+  std::memcpy(&record, data.data() + offset, sizeof(T));
+  return record;
+}
+
+template <typename T>
+void AppendRecord(const T& record, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&record), sizeof(T));
+}
+
+// Collects the texts of an index, storing each distinct text once.
+class StringTable {
+ public:
+  StringRef Add(absl::string_view text) {
+    const auto found = offsets_.find(text);
+    if (found != offsets_.end()) {
+      return {found->second, static_cast<uint32_t>(text.size())};
+    }
+    const uint32_t offset = data_.size();
+    data_.append(text.data(), text.size());
+    offsets_.emplace(std::string(text), offset);
+    return {offset, static_cast<uint32_t>(text.size())};
+  }
+
+  const std::string& Data() const { return data_; }
+
+ private:
+  std::string data_;
+  absl::flat_hash_map<std::string, uint32_t> offsets_;
+};
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& stream, IndexedSymbolKind kind) {
+  switch (kind) {
+    case IndexedSymbolKind::kModule:
+      return stream << "module";
+    case IndexedSymbolKind::kInterface:
+      return stream << "interface";
+    case IndexedSymbolKind::kPackage:
+      return stream << "package";
+    case IndexedSymbolKind::kClass:
+      return stream << "class";
+  }
+  return stream << "unknown";
+}
+
+std::ostream& operator<<(std::ostream& stream,
+                         const SymbolLocation& location) {
+  return stream << location.line << ':' << location.column << ": "
+                << location.kind << ' '
+                << (location.is_definition ? "definition" : "reference") << ' '
+                << location.name;
+}
+
+std::vector<IndexedFile> IndexFiles(const std::vector<std::string>& paths,
+                                    const SymbolExtractor& extractor,
+                                    size_t num_threads,
+                                    const SymbolIndexView* previous,
+                                    SymbolIndexStats* stats) {
+  enum Outcome : char { kUnreadable, kAnalyzed, kReused };
+  std::vector<IndexedFile> files(paths.size());
+  std::vector<Outcome> outcomes(paths.size(), kUnreadable);
+  {
+    verible::ThreadPool pool(num_threads);
+    for (size_t i = 0; i < paths.size(); ++i) {
+      pool.Schedule([&, i]() {
+        std::string contents;
+        if (!verible::file::GetContents(paths[i], &contents)) return;
+        IndexedFile& file = files[i];
+        file.path = paths[i];
+        file.digest = verible::ContentHasher().Add(contents).HexDigest();
+        if (previous != nullptr) {
+          const int found = previous->FindFile(file.path);
+          if (found >= 0 && previous->FileDigest(found) == file.digest) {
+            file.symbols = previous->GetFile(found).symbols;
+            outcomes[i] = kReused;
+            return;
+          }
+        }
+        file.symbols = extractor(file.path, contents);
+        outcomes[i] = kAnalyzed;
+      });
+    }
+  }
+
+  SymbolIndexStats counts;
+  std::vector<IndexedFile> indexed;
+  indexed.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    switch (outcomes[i]) {
+      case kUnreadable:
+        ++counts.unreadable_files;
+        continue;
+      case kAnalyzed:
+        ++counts.analyzed_files;
+        break;
+      case kReused:
+        ++counts.reused_files;
+        break;
+    }
+    indexed.push_back(std::move(files[i]));
+  }
+  if (stats != nullptr) *stats = counts;
+  return indexed;
+}
+
+std::string SerializeSymbolIndex(const std::vector<IndexedFile>& files) {
+  std::vector<const IndexedFile*> sorted;
+  sorted.reserve(files.size());
+  for (const auto& file : files) sorted.push_back(&file);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const IndexedFile* left, const IndexedFile* right) {
+                     return left->path < right->path;
+                   });
+  sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                           [](const IndexedFile* left,
+                              const IndexedFile* right) {
+                             return left->path == right->path;
+                           }),
+               sorted.end());
+
+  StringTable strings;
+  std::vector<FileRecord> file_records;
+  std::vector<SymbolRecord> symbol_records;
+  std::vector<absl::string_view> names;
+  for (const IndexedFile* file : sorted) {
+    FileRecord file_record;
+    file_record.path = strings.Add(file->path);
+    file_record.digest = strings.Add(file->digest);
+    file_record.first_symbol = symbol_records.size();
+    file_record.num_symbols = file->symbols.size();
+    for (const auto& symbol : file->symbols) {
+      SymbolRecord symbol_record;
+      symbol_record.name = strings.Add(symbol.name);
+      symbol_record.file = file_records.size();
+      symbol_record.line = symbol.line;
+      symbol_record.column = symbol.column;
+      symbol_record.flags = static_cast<uint32_t>(symbol.kind) |
+                            (symbol.is_definition ? kDefinitionFlag : 0);
+      symbol_records.push_back(symbol_record);
+      names.push_back(symbol.name);
+    }
+    file_records.push_back(file_record);
+  }
+  // Symbols of the same name stay ordered by file and position.
+  std::vector<uint32_t> by_name(symbol_records.size());
+  for (size_t i = 0; i < by_name.size(); ++i) by_name[i] = i;
+  std::stable_sort(by_name.begin(), by_name.end(),
+                   [&names](uint32_t left, uint32_t right) {
+                     return names[left] < names[right];
+                   });
+
+  Header header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.num_files = file_records.size();
+  header.num_symbols = symbol_records.size();
+  header.strings_size = strings.Data().size();
+  std::string data;
+  data.reserve(sizeof(Header) + file_records.size() * sizeof(FileRecord) +
+               symbol_records.size() *
+                   (sizeof(SymbolRecord) + sizeof(uint32_t)) +
+               strings.Data().size());
+  AppendRecord(header, &data);
+  for (const auto& record : file_records) AppendRecord(record, &data);
+  for (const auto& record : symbol_records) AppendRecord(record, &data);
+  for (const uint32_t index : by_name) AppendRecord(index, &data);
+  data += strings.Data();
+  return data;
+}
+
+// Offsets of the sections that follow the file records.
+static size_t SymbolsOffset(size_t num_files) {
+  return kFilesOffset + num_files * sizeof(FileRecord);
+}
+
+static size_t ByNameOffset(size_t num_files, size_t num_symbols) {
+  return SymbolsOffset(num_files) + num_symbols * sizeof(SymbolRecord);
+}
+
+static size_t StringsOffset(size_t num_files, size_t num_symbols) {
+  return ByNameOffset(num_files, num_symbols) + num_symbols * sizeof(uint32_t);
+}
+
+verible::util::Status SymbolIndexView::Init(absl::string_view data) {
+  data_ = absl::string_view();
+  num_files_ = 0;
+  num_symbols_ = 0;
+  if (data.size() < sizeof(Header)) {
+    return verible::util::InvalidArgumentError("Symbol index is truncated");
+  }
+  const auto header = ReadRecord<Header>(data, 0);
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return verible::util::InvalidArgumentError(
+        "Not a symbol index, or one in an unsupported format");
+  }
+  // Computed in 64 bits, so that large counts cannot wrap around.
+  const uint64_t size =
+      StringsOffset(header.num_files, header.num_symbols) +
+      uint64_t{header.strings_size};
+  if (size != data.size()) {
+    return verible::util::InvalidArgumentError(absl::StrCat(
+        "Symbol index has ", data.size(), " bytes, but should have ", size));
+  }
+  // Check the records that queries rely on to find others.  Texts and
+  // symbols are checked as they are read.
+  uint32_t next_symbol = 0;
+  for (size_t i = 0; i < header.num_files; ++i) {
+    const auto record = ReadRecord<FileRecord>(
+        data, kFilesOffset + i * sizeof(FileRecord));
+    if (record.first_symbol != next_symbol ||
+        record.num_symbols > header.num_symbols - next_symbol) {
+      return verible::util::InvalidArgumentError(
+          absl::StrCat("Symbol index has invalid symbols for file ", i));
+    }
+    next_symbol += record.num_symbols;
+  }
+  if (next_symbol != header.num_symbols) {
+    return verible::util::InvalidArgumentError(
+        "Symbol index has symbols that belong to no file");
+  }
+  data_ = data;
+  num_files_ = header.num_files;
+  num_symbols_ = header.num_symbols;
+  return verible::util::OkStatus();
+}
+
+// Returns the text of 'ref' in the strings of an index, or an empty text if
+// it is out of range.
+static absl::string_view Text(absl::string_view data, size_t num_files,
+                              size_t num_symbols, StringRef ref) {
+  const absl::string_view strings =
+      data.substr(StringsOffset(num_files, num_symbols));
+  if (ref.offset > strings.size() || ref.size > strings.size() - ref.offset) {
+    return absl::string_view();
+  }
+  return strings.substr(ref.offset, ref.size);
+}
+
+absl::string_view SymbolIndexView::FilePath(size_t index) const {
+  const auto record = ReadRecord<FileRecord>(
+      data_, kFilesOffset + index * sizeof(FileRecord));
+  return Text(data_, num_files_, num_symbols_, record.path);
+}
+
+absl::string_view SymbolIndexView::FileDigest(size_t index) const {
+  const auto record = ReadRecord<FileRecord>(
+      data_, kFilesOffset + index * sizeof(FileRecord));
+  return Text(data_, num_files_, num_symbols_, record.digest);
+}
+
+SymbolLocation SymbolIndexView::GetSymbol(size_t index,
+                                          uint32_t* file) const {
+  const auto record = ReadRecord<SymbolRecord>(
+      data_, SymbolsOffset(num_files_) + index * sizeof(SymbolRecord));
+  SymbolLocation location;
+  location.name = std::string(Text(data_, num_files_, num_symbols_,
+                                   record.name));
+  location.kind = static_cast<IndexedSymbolKind>(record.flags & 0xff);
+  location.is_definition = (record.flags & kDefinitionFlag) != 0;
+  location.line = record.line;
+  location.column = record.column;
+  *file = record.file;
+  return location;
+}
+
+absl::string_view SymbolIndexView::SymbolName(size_t index) const {
+  const auto record = ReadRecord<SymbolRecord>(
+      data_, SymbolsOffset(num_files_) + index * sizeof(SymbolRecord));
+  return Text(data_, num_files_, num_symbols_, record.name);
+}
+
+IndexedFile SymbolIndexView::GetFile(size_t index) const {
+  const auto record = ReadRecord<FileRecord>(
+      data_, kFilesOffset + index * sizeof(FileRecord));
+  IndexedFile file;
+  file.path = std::string(FilePath(index));
+  file.digest = std::string(FileDigest(index));
+  file.symbols.reserve(record.num_symbols);
+  for (uint32_t i = 0; i < record.num_symbols; ++i) {
+    uint32_t unused_file;
+    file.symbols.push_back(GetSymbol(record.first_symbol + i, &unused_file));
+  }
+  return file;
+}
+
+int SymbolIndexView::FindFile(absl::string_view path) const {
+  size_t low = 0;
+  size_t high = num_files_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (FilePath(middle) < path) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low < num_files_ && FilePath(low) == path ? low : -1;
+}
+
+std::vector<SymbolMatch> SymbolIndexView::Lookup(
+    absl::string_view name) const {
+  const size_t by_name_offset = ByNameOffset(num_files_, num_symbols_);
+  const auto symbol_at = [this, by_name_offset](size_t position) {
+    return ReadRecord<uint32_t>(data_,
+                                by_name_offset + position * sizeof(uint32_t));
+  };
+  const auto valid = [this](uint32_t symbol) { return symbol < num_symbols_; };
+  size_t low = 0;
+  size_t high = num_symbols_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const uint32_t symbol = symbol_at(middle);
+    if (valid(symbol) && SymbolName(symbol) < name) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  std::vector<SymbolMatch> matches;
+  for (; low < num_symbols_; ++low) {
+    const uint32_t symbol = symbol_at(low);
+    if (!valid(symbol) || SymbolName(symbol) != name) break;
+    SymbolMatch match;
+    uint32_t file;
+    match.location = GetSymbol(symbol, &file);
+    if (file >= num_files_) continue;
+    match.path = FilePath(file);
+    matches.push_back(std::move(match));
+  }
+  return matches;
+}
+
+}  // namespace verilog
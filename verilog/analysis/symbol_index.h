@@ -0,0 +1,165 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// A symbol index records where modules, interfaces, packages and classes are
+// defined and referenced across the files of a project, so that tools can
+// find them without parsing every file.  An index is built on a thread pool,
+// updated incrementally (files whose contents are unchanged are not analyzed
+// again), and stored in a compact binary format that SymbolIndexView reads
+// in place, e.g. from a memory-mapped file.
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_SYMBOL_INDEX_H_
+#define VERIBLE_VERILOG_ANALYSIS_SYMBOL_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/util/status.h"
+
+namespace verilog {
+
+// Kinds of indexed design elements.
+enum class IndexedSymbolKind : uint8_t {
+  kModule,
+  kInterface,
+  kPackage,
+  kClass,
+};
+
+std::ostream& operator<<(std::ostream&, IndexedSymbolKind);
+
+// A definition of, or a reference to, a design element in one file.
+struct SymbolLocation {
+  std::string name;
+  IndexedSymbolKind kind = IndexedSymbolKind::kModule;
+
+  // True for the definition, false for references (instantiations of
+  // modules and interfaces, imports of packages, base classes).
+  bool is_definition = false;
+
+  // 1-based position of the name.
+  int line = 0;
+  int column = 0;
+
+  bool operator==(const SymbolLocation& other) const {
+    return name == other.name && kind == other.kind &&
+           is_definition == other.is_definition && line == other.line &&
+           column == other.column;
+  }
+};
+
+// Prints like "12:3: module definition foo".
+std::ostream& operator<<(std::ostream&, const SymbolLocation&);
+
+// The indexed symbols of one file.
+struct IndexedFile {
+  std::string path;
+
+  // verible::ContentHasher digest of the contents in which the symbols were
+  // found.
+  std::string digest;
+
+  std::vector<SymbolLocation> symbols;
+};
+
+// Finds the symbols in the 'contents' of the file at 'path'.  This may be
+// called concurrently.
+using SymbolExtractor = std::function<std::vector<SymbolLocation>(
+    absl::string_view path, absl::string_view contents)>;
+
+class SymbolIndexView;
+
+// Counts of files processed by IndexFiles().
+struct SymbolIndexStats {
+  // Files whose symbols were extracted.
+  size_t analyzed_files = 0;
+
+  // Files whose symbols were taken from the previous index.
+  size_t reused_files = 0;
+
+  // Files that could not be read, which are left out of the index.
+  size_t unreadable_files = 0;
+};
+
+// Returns the indexed symbols of the files at 'paths', in order, with each
+// file read and analyzed by 'extractor' on a pool of 'num_threads' threads
+// (0 means all hardware threads).  Files whose path and contents digest are
+// the same as in 'previous' (if not null) reuse its symbols without being
+// analyzed.  Files that cannot be read are left out.
+std::vector<IndexedFile> IndexFiles(const std::vector<std::string>& paths,
+                                    const SymbolExtractor& extractor,
+                                    size_t num_threads,
+                                    const SymbolIndexView* previous = nullptr,
+                                    SymbolIndexStats* stats = nullptr);
+
+// Returns the binary representation of an index of 'files', for
+// SymbolIndexView.  Only the first of files with the same path is indexed.
+std::string SerializeSymbolIndex(const std::vector<IndexedFile>& files);
+
+// A symbol found by SymbolIndexView::Lookup().
+struct SymbolMatch {
+  absl::string_view path;
+  SymbolLocation location;
+};
+
+// Read-only view of a serialized index.  Nothing is copied or decoded up
+// front: every query reads only the records it needs, so that a large index
+// in a memory-mapped file is mostly left on disk.
+class SymbolIndexView {
+ public:
+  SymbolIndexView() = default;
+
+  // Views 'data', which must outlive this view.  Returns an error, and
+  // leaves the view empty, if 'data' is not an index in the current format.
+  verible::util::Status Init(absl::string_view data);
+
+  size_t NumFiles() const { return num_files_; }
+
+  size_t NumSymbols() const { return num_symbols_; }
+
+  // Returns the path and digest of the file at 'index' (< NumFiles()).
+  // Files are ordered by path.
+  absl::string_view FilePath(size_t index) const;
+  absl::string_view FileDigest(size_t index) const;
+
+  // Returns the file at 'index', including its symbols.
+  IndexedFile GetFile(size_t index) const;
+
+  // Returns the index of the file at 'path', or -1 if it is not indexed.
+  int FindFile(absl::string_view path) const;
+
+  // Returns the definitions of, and references to, 'name', ordered by path
+  // and position.
+  std::vector<SymbolMatch> Lookup(absl::string_view name) const;
+
+ private:
+  // Returns the symbol record at 'index' (< NumSymbols()).
+  SymbolLocation GetSymbol(size_t index, uint32_t* file) const;
+
+  absl::string_view SymbolName(size_t index) const;
+
+  absl::string_view data_;
+  size_t num_files_ = 0;
+  size_t num_symbols_ = 0;
+};
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_SYMBOL_INDEX_H_
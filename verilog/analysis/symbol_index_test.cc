@@ -0,0 +1,204 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verilog/analysis/symbol_index.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "common/util/file_util.h"
+
+namespace verilog {
+namespace {
+
+namespace file = verible::file;
+
+using ::testing::ElementsAre;
+
+// Returns a fresh directory for the files of one test.
+std::string TestDir(absl::string_view name) {
+  const std::string dir = file::JoinPath(testing::TempDir(), name);
+  EXPECT_TRUE(file::CreateDir(dir));
+  return dir;
+}
+
+SymbolLocation Symbol(absl::string_view name, IndexedSymbolKind kind,
+                      bool is_definition, int line, int column) {
+  SymbolLocation symbol;
+  symbol.name = std::string(name);
+  symbol.kind = kind;
+  symbol.is_definition = is_definition;
+  symbol.line = line;
+  symbol.column = column;
+  return symbol;
+}
+
+// Extracts one symbol per line of the form "<name>" (module definition) or
+// "use <name>" (module reference), and counts the files it analyzes.
+class FakeExtractor {
+ public:
+  SymbolExtractor Get() {
+    return [this](absl::string_view, absl::string_view contents) {
+      ++calls_;
+      std::vector<SymbolLocation> symbols;
+      int line = 0;
+      for (absl::string_view text : absl::StrSplit(contents, '\n')) {
+        ++line;
+        if (text.empty()) continue;
+        const bool is_reference = absl::ConsumePrefix(&text, "use ");
+        symbols.push_back(
+            Symbol(text, IndexedSymbolKind::kModule, !is_reference, line,
+                   is_reference ? 5 : 1));
+      }
+      return symbols;
+    };
+  }
+
+  int Calls() const { return calls_; }
+
+ private:
+  std::atomic<int> calls_{0};
+};
+
+TEST(SymbolIndexViewTest, RejectsInvalidData) {
+  SymbolIndexView view;
+  EXPECT_FALSE(view.Init("").ok());
+  EXPECT_FALSE(view.Init("not an index, but long enough").ok());
+  std::string data = SerializeSymbolIndex({});
+  EXPECT_TRUE(view.Init(data).ok());
+  data.push_back('x');
+  EXPECT_FALSE(view.Init(data).ok());
+  EXPECT_EQ(view.NumFiles(), 0);
+}
+
+TEST(SymbolIndexViewTest, EmptyIndex) {
+  const std::string data = SerializeSymbolIndex({});
+  SymbolIndexView view;
+  ASSERT_TRUE(view.Init(data).ok());
+  EXPECT_EQ(view.NumFiles(), 0);
+  EXPECT_EQ(view.FindFile("a.sv"), -1);
+  EXPECT_TRUE(view.Lookup("foo").empty());
+}
+
+TEST(SymbolIndexViewTest, RoundTrip) {
+  IndexedFile b{"b.sv",
+                "digest-b",
+                {Symbol("bar", IndexedSymbolKind::kInterface, true, 1, 11),
+                 Symbol("foo", IndexedSymbolKind::kModule, false, 3, 3)}};
+  IndexedFile a{"a.sv",
+                "digest-a",
+                {Symbol("foo", IndexedSymbolKind::kModule, true, 2, 8),
+                 Symbol("pkg", IndexedSymbolKind::kPackage, false, 1, 8)}};
+  IndexedFile c{"c.sv", "digest-c", {}};
+  const std::string data = SerializeSymbolIndex({b, a, c});
+  SymbolIndexView view;
+  ASSERT_TRUE(view.Init(data).ok());
+  ASSERT_EQ(view.NumFiles(), 3);
+  EXPECT_EQ(view.NumSymbols(), 4);
+
+  // Files are ordered by path.
+  EXPECT_EQ(view.FilePath(0), "a.sv");
+  EXPECT_EQ(view.FindFile("a.sv"), 0);
+  EXPECT_EQ(view.FindFile("b.sv"), 1);
+  EXPECT_EQ(view.FindFile("c.sv"), 2);
+  EXPECT_EQ(view.FindFile("d.sv"), -1);
+  EXPECT_EQ(view.FileDigest(1), "digest-b");
+  const IndexedFile file = view.GetFile(1);
+  EXPECT_EQ(file.path, "b.sv");
+  EXPECT_EQ(file.digest, "digest-b");
+  EXPECT_EQ(file.symbols, b.symbols);
+  EXPECT_TRUE(view.GetFile(2).symbols.empty());
+
+  const auto matches = view.Lookup("foo");
+  ASSERT_EQ(matches.size(), 2);
+  EXPECT_EQ(matches[0].path, "a.sv");
+  EXPECT_EQ(matches[0].location, a.symbols[0]);
+  EXPECT_EQ(matches[1].path, "b.sv");
+  EXPECT_EQ(matches[1].location, b.symbols[1]);
+  EXPECT_EQ(view.Lookup("bar").size(), 1);
+  EXPECT_TRUE(view.Lookup("baz").empty());
+  EXPECT_TRUE(view.Lookup("").empty());
+}
+
+TEST(SymbolIndexTest, PrintSymbol) {
+  std::ostringstream stream;
+  stream << Symbol("foo", IndexedSymbolKind::kClass, false, 12, 3);
+  EXPECT_EQ(stream.str(), "12:3: class reference foo");
+}
+
+TEST(SymbolIndexTest, IndexFiles) {
+  const std::string dir = TestDir("symbol_index_files");
+  const std::string a = file::JoinPath(dir, "a.sv");
+  const std::string b = file::JoinPath(dir, "b.sv");
+  ASSERT_TRUE(file::SetContents(a, "foo\nuse bar\n"));
+  ASSERT_TRUE(file::SetContents(b, "bar\n"));
+  FakeExtractor extractor;
+  SymbolIndexStats stats;
+  const auto files =
+      IndexFiles({a, file::JoinPath(dir, "missing.sv"), b}, extractor.Get(),
+                 2, nullptr, &stats);
+  ASSERT_EQ(files.size(), 2);
+  EXPECT_EQ(files[0].path, a);
+  EXPECT_THAT(
+      files[0].symbols,
+      ElementsAre(Symbol("foo", IndexedSymbolKind::kModule, true, 1, 1),
+                  Symbol("bar", IndexedSymbolKind::kModule, false, 2, 5)));
+  EXPECT_EQ(files[1].path, b);
+  EXPECT_EQ(files[1].symbols.size(), 1);
+  EXPECT_NE(files[0].digest, files[1].digest);
+  EXPECT_EQ(stats.analyzed_files, 2);
+  EXPECT_EQ(stats.reused_files, 0);
+  EXPECT_EQ(stats.unreadable_files, 1);
+  EXPECT_EQ(extractor.Calls(), 2);
+}
+
+TEST(SymbolIndexTest, IncrementalUpdate) {
+  const std::string dir = TestDir("symbol_index_update");
+  const std::string a = file::JoinPath(dir, "a.sv");
+  const std::string b = file::JoinPath(dir, "b.sv");
+  ASSERT_TRUE(file::SetContents(a, "foo\n"));
+  ASSERT_TRUE(file::SetContents(b, "bar\n"));
+  FakeExtractor extractor;
+  const std::string first =
+      SerializeSymbolIndex(IndexFiles({a, b}, extractor.Get(), 1));
+  SymbolIndexView previous;
+  ASSERT_TRUE(previous.Init(first).ok());
+
+  // Only the changed file is analyzed again.
+  ASSERT_TRUE(file::SetContents(b, "baz\n"));
+  SymbolIndexStats stats;
+  const auto files = IndexFiles({a, b}, extractor.Get(), 1, &previous, &stats);
+  EXPECT_EQ(stats.analyzed_files, 1);
+  EXPECT_EQ(stats.reused_files, 1);
+  EXPECT_EQ(extractor.Calls(), 3);
+  const std::string second = SerializeSymbolIndex(files);
+  SymbolIndexView view;
+  ASSERT_TRUE(view.Init(second).ok());
+  ASSERT_EQ(view.Lookup("foo").size(), 1);
+  EXPECT_EQ(view.Lookup("foo").front().path, a);
+  EXPECT_TRUE(view.Lookup("bar").empty());
+  ASSERT_EQ(view.Lookup("baz").size(), 1);
+  EXPECT_EQ(view.Lookup("baz").front().path, b);
+}
+
+}  // namespace
+}  // namespace verilog
@@ -0,0 +1,116 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verilog/analysis/synthetic_verilog.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+
+namespace verilog {
+
+std::string SyntheticLongPortList(size_t n) {
+  std::string text = "module wide (\n";
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "  input logic [7:0] p", i,
+                    i + 1 < n ? ",\n" : "\n");
+  }
+  absl::StrAppend(&text, ");\nendmodule\n\nmodule top;\n  wide u_wide (\n");
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "    .p", i, "(s", i, ")", i + 1 < n ? ",\n" : "\n");
+  }
+  absl::StrAppend(&text, "  );\nendmodule\n");
+  return text;
+}
+
+std::string SyntheticManyModules(size_t n) {
+  std::string text;
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "module m", i, " (\n", "  input logic clk,\n",
+                    "  input logic [7:0] a,\n", "  output logic [7:0] y\n",
+                    ");\n", "  logic [7:0] q;\n", "  assign y = q ^ a;\n",
+                    "  always_ff @(posedge clk) begin\n",
+                    "    q <= a + 8'd", i % 256, ";\n", "  end\n");
+    if (i > 0) {
+      absl::StrAppend(&text, "  m", i - 1, " u_m", i - 1,
+                      " (.clk(clk), .a(q), .y());\n");
+    }
+    absl::StrAppend(&text, "endmodule\n\n");
+  }
+  return text;
+}
+
+std::string SyntheticDeepNesting(size_t n) {
+  // Lines are not indented, so that the text grows linearly.
+  std::string text = "module deep (\ninput logic [7:0] a,\n"
+                     "output logic [7:0] y\n);\nalways_comb begin\n";
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "if (a > 8'd", i % 256, ") begin\n");
+  }
+  absl::StrAppend(&text, "y = a;\n");
+  for (size_t i = 0; i < n; ++i) absl::StrAppend(&text, "end\n");
+  absl::StrAppend(&text, "end\nendmodule\n");
+  return text;
+}
+
+std::string SyntheticLongLines(size_t n) {
+  constexpr int kLines = 4;
+  std::string text = "module long_lines;\n";
+  for (int line = 0; line < kLines; ++line) {
+    absl::StrAppend(&text, "  assign y", line, " = a0");
+    for (size_t i = 1; i < n; ++i) absl::StrAppend(&text, " + a", i);
+    absl::StrAppend(&text, ";\n");
+  }
+  absl::StrAppend(&text, "endmodule\n");
+  return text;
+}
+
+std::string SyntheticManyMacros(size_t n) {
+  std::string text;
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "`define ADD", i, "(x, y) ((x) + (y) + ", i,
+                    ")\n");
+  }
+  absl::StrAppend(&text, "\nmodule macros;\n");
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "  assign y", i, " = `ADD", i, "(a, b);\n");
+  }
+  absl::StrAppend(&text, "endmodule\n");
+  return text;
+}
+
+std::string SyntheticSyntaxErrors(size_t n) {
+  std::string text;
+  for (size_t i = 0; i < n; ++i) {
+    absl::StrAppend(&text, "assign y", i, " = a", i, " + ;\n");
+  }
+  return text;
+}
+
+const std::vector<SyntheticVerilogShape>& SyntheticVerilogShapes() {
+  static const auto* shapes = new std::vector<SyntheticVerilogShape>{
+      {"long port list", &SyntheticLongPortList, 250},
+      {"many modules", &SyntheticManyModules, 40},
+      {"deep nesting", &SyntheticDeepNesting, 64},
+      {"long lines", &SyntheticLongLines, 250},
+      {"many macros", &SyntheticManyMacros, 200},
+      {"syntax errors", &SyntheticSyntaxErrors, 250, true},
+  };
+  return *shapes;
+}
+
+}  // namespace verilog
@@ -0,0 +1,68 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Generators of synthetic Verilog source, for tests of how analysis scales
+// with the size of its input.  Each generator stresses one dimension that
+// real code grows in; the size of its text grows linearly with 'n'.
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_SYNTHETIC_VERILOG_H_
+#define VERIBLE_VERILOG_ANALYSIS_SYNTHETIC_VERILOG_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace verilog {
+
+// One module with 'n' ports, which another module instantiates with 'n'
+// named port connections.
+std::string SyntheticLongPortList(size_t n);
+
+// 'n' small modules, each with declarations, continuous and procedural
+// assignments, and an instantiation of the one before.
+std::string SyntheticManyModules(size_t n);
+
+// 'n' nested conditional blocks in one always block.
+std::string SyntheticDeepNesting(size_t n);
+
+// A few assignments, each with an expression of 'n' terms on a single line.
+std::string SyntheticLongLines(size_t n);
+
+// 'n' macro definitions, each called in a module.
+std::string SyntheticManyMacros(size_t n);
+
+// 'n' module items outside of any module, each with a syntax error.  Parsing
+// fails at the first item, is retried as a module body, and recovers from
+// every error.
+std::string SyntheticSyntaxErrors(size_t n);
+
+// A generator, with the smallest 'n' that gives it measurable work.
+struct SyntheticVerilogShape {
+  absl::string_view name;
+  std::string (*generate)(size_t n);
+  size_t base_scale;
+
+  // True if the generated source does not parse.
+  bool syntax_errors = false;
+};
+
+// All of the above.
+const std::vector<SyntheticVerilogShape>& SyntheticVerilogShapes();
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_SYNTHETIC_VERILOG_H_
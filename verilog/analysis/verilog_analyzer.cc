@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -30,6 +31,7 @@
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "common/analysis/file_analyzer.h"
+#include "common/lexer/token_generator.h"
 #include "common/lexer/token_stream_adapter.h"
 #include "common/strings/comment_utils.h"
 #include "common/text/concrete_syntax_leaf.h"
@@ -43,6 +45,7 @@
 #include "common/util/logging.h"
 #include "common/util/status.h"
 #include "common/util/status_macros.h"
+#include "verilog/analysis/parallel_parse.h"
 #include "verilog/analysis/verilog_excerpt_parse.h"
 #include "verilog/parser/verilog_lexer.h"
 #include "verilog/parser/verilog_lexical_context.h"
@@ -126,10 +129,15 @@ static const absl::string_view FailingTokenKeywordToParsingMode(
 }
 
 std::unique_ptr<VerilogAnalyzer> VerilogAnalyzer::AnalyzeAutomaticMode(
-    absl::string_view text, absl::string_view name) {
+    absl::string_view text, absl::string_view name, size_t parse_threads,
+    verible::ResourceBudget* budget,
+    const IncludeFileLoader& include_file_loader) {
   VLOG(2) << __FUNCTION__;
   auto analyzer = absl::make_unique<VerilogAnalyzer>(text, name);
   if (analyzer == nullptr) return analyzer;
+  analyzer->SetParseThreads(parse_threads);
+  analyzer->SetBudget(budget);
+  analyzer->SetIncludeFileLoader(include_file_loader);
   const absl::string_view text_base = analyzer->Data().Contents();
   // If there is any lexical error, stop right away.
   const auto lex_status = analyzer->Tokenize();
@@ -148,6 +156,8 @@ std::unique_ptr<VerilogAnalyzer> VerilogAnalyzer::AnalyzeAutomaticMode(
 
   // In all other cases, continue to parse in normal mode.  (common path)
   const auto parse_status = analyzer->Analyze();
+  // Retrying in other modes would not fit in the budget either.
+  if (analyzer->BudgetExhausted()) return analyzer;
 
   if (!parse_status.ok()) {
     VLOG(1) << "Error analyzing verilog.";
@@ -197,6 +207,26 @@ std::unique_ptr<VerilogAnalyzer> VerilogAnalyzer::AnalyzeAutomaticMode(
   return analyzer;
 }
 
+std::unique_ptr<VerilogAnalyzer> VerilogAnalyzer::AnalyzeUpTo(
+    absl::string_view text, absl::string_view name, AnalysisArtifact artifact,
+    verible::ResourceBudget* budget,
+    const IncludeFileLoader& include_file_loader) {
+  switch (artifact) {
+    case AnalysisArtifact::kLines:
+      // Lines are split upon construction.
+      return absl::make_unique<VerilogAnalyzer>(text, name);
+    case AnalysisArtifact::kTokens: {
+      auto analyzer = absl::make_unique<VerilogAnalyzer>(text, name);
+      analyzer->SetBudget(budget);
+      analyzer->AnalyzeTokens();  // status is retained in LexStatus()
+      return analyzer;
+    }
+    case AnalysisArtifact::kSyntaxTree:
+    default:
+      return AnalyzeAutomaticMode(text, name, 1, budget, include_file_loader);
+  }
+}
+
 void VerilogAnalyzer::FilterTokensForSyntaxTree() {
   data_.FilterTokens(&VerilogLexer::KeepSyntaxTreeTokens);
 }
@@ -209,7 +239,7 @@ void VerilogAnalyzer::ContextualizeTokens() {
 // Analyzes Verilog code: lexer, filter, parser.
 // Result of parsing is stored in syntax_tree_ (if passed)
 // or rejected_token_ (if failed).
-verible::util::Status VerilogAnalyzer::Analyze() {
+verible::util::Status VerilogAnalyzer::AnalyzeTokens() {
   // Lex into tokens.
   RETURN_IF_ERROR(Tokenize());
 
@@ -218,33 +248,160 @@ verible::util::Status VerilogAnalyzer::Analyze() {
 
   // Disambiguate tokens using lexical context.
   ContextualizeTokens();
+  return verible::util::OkStatus();
+}
+
+namespace {
+// Pulls tokens through the stages of analysis that precede parsing, one
+// token at a time, as the parser asks for them: filtering out comments and
+// whitespace, contextual disambiguation, and preprocessing.
+// This avoids materializing a separate view of the token stream for each
+// stage, and touches each token while it is still in cache.
+// Tokens are contextualized in-place in the lexed token sequence, and the
+// preprocessed tokens are recorded, as usual, for later analyses.
+class PreParseTokenPipeline {
+ public:
+  // 'tokens' must end with an EOF token.  `include directives are resolved
+  // with 'include_file_loader', if set.
+  PreParseTokenPipeline(TokenSequence* tokens,
+                        const IncludeFileLoader& include_file_loader)
+      : next_token_(tokens->begin()),
+        end_(tokens->end()),
+        generator_([this]() { return NextSyntaxTreeToken(); }) {
+    CHECK(!tokens->empty());
+    if (include_file_loader != nullptr) {
+      preprocessor_.SetIncludeFileLoader(include_file_loader);
+    }
+  }
+
+  // Returns the next preprocessed token, or EOF after the end of the stream
+  // or a preprocessing error.
+  TokenInfo NextToken() {
+    const auto& preprocessed = preprocessor_.PreprocessedTokenStream();
+    while (next_preprocessed_ == preprocessed.size()) {
+      if (exhausted_ || !preprocess_status_.ok()) return TokenInfo::EOFToken();
+      preprocess_status_ = preprocessor_.ScanNextToken(generator_);
+    }
+    return *preprocessed[next_preprocessed_++];
+  }
+
+  // Preprocesses the rest of the stream (e.g. after the parser stopped
+  // early), and returns the status of preprocessing.
+  verible::util::Status Finish() {
+    while (!exhausted_ && preprocess_status_.ok()) {
+      preprocess_status_ = preprocessor_.ScanNextToken(generator_);
+    }
+    // Contextualize tokens that remain after a preprocessing error.
+    while (!exhausted_) NextSyntaxTreeToken();
+    return preprocess_status_;
+  }
+
+  VerilogPreprocessData TakePreprocessorData() {
+    return preprocessor_.TakeData();
+  }
+
+ private:
+  // Returns the next token that belongs in a syntax tree, after
+  // contextualizing it.  At the end of the stream, keeps returning the final
+  // EOF token.
+  TokenSequence::const_iterator NextSyntaxTreeToken() {
+    while (next_token_ != end_ &&
+           !VerilogLexer::KeepSyntaxTreeTokens(*next_token_)) {
+      ++next_token_;
+    }
+    if (next_token_ == end_) {
+      exhausted_ = true;
+      return std::prev(end_);
+    }
+    context_.TransformVerilogSymbol(&*next_token_);
+    const auto token = next_token_++;
+    if (next_token_ == end_) exhausted_ = true;
+    return token;
+  }
+
+  TokenSequence::iterator next_token_;
+  const TokenSequence::iterator end_;
+
+  // True after the last token has been handed to the preprocessor.
+  bool exhausted_ = false;
+
+  LexicalContext context_;
 
-  // pseudo-preprocess token stream.
+  VerilogPreprocess preprocessor_;
+  const VerilogPreprocess::StreamIteratorGenerator generator_;
+  verible::util::Status preprocess_status_;
+
+  // Index of the next preprocessed token to hand to the parser.
+  size_t next_preprocessed_ = 0;
+};
+}  // namespace
+
+verible::util::Status VerilogAnalyzer::Analyze() {
+  // Lex into tokens.
+  RETURN_IF_ERROR(Tokenize());
+
+  // Filter, contextualize, and pseudo-preprocess the token stream, on demand.
   // TODO(fangism): preprocessor_.Configure();
   //   Not all analyses will want to preprocess.
-  {
-    VerilogPreprocess preprocessor;
-    preprocessor_data_ = preprocessor.ScanStream(Data().GetTokenStreamView());
-    if (!preprocessor_data_.errors.empty()) {
-      for (const auto& error : preprocessor_data_.errors) {
-        rejected_tokens_.push_back(verible::RejectedToken{
-            error.token_info, verible::AnalysisPhase::kPreprocessPhase,
-            error.error_message});
-      }
-      parse_status_ =
-          verible::util::InvalidArgumentError("Preprocessor error.");
-      return parse_status_;
-    }
-    MutableData().MutableTokenStreamView() =
-        preprocessor_data_.preprocessed_token_stream;  // copy
-    // TODO(fangism): could we just move, swap, or directly reference?
+  PreParseTokenPipeline pipeline(&MutableData().MutableTokenStream(),
+                                 include_file_loader_);
+  const size_t num_rejected_tokens = rejected_tokens_.size();
+  bool parsed = false;
+  if (parse_threads_ == 1) {
+    // The parser pulls each token through the pipeline.
+    verible::TokenGenerator generator(
+        [&pipeline]() { return pipeline.NextToken(); });
+    VerilogParser parser(&generator, budget_);
+    parse_status_ = FileAnalyzer::Parse(&parser);
+    max_used_stack_size_ = parser.MaxUsedStackSize();
+    parsed = true;
+    // Leave the rest of the tokens unprocessed.
+    if (BudgetExhausted()) return parse_status_;
   }
+  // Preprocessor errors take precedence over syntax errors, even when
+  // they are found after the parser has stopped.
+  const auto preprocess_status = pipeline.Finish();
+  preprocessor_data_ = pipeline.TakePreprocessorData();
+  return ParsePreprocessed(preprocess_status, parsed, num_rejected_tokens);
+}
 
-  auto generator = MakeTokenViewer(Data().GetTokenStreamView());
-  VerilogParser parser(&generator);
-  parse_status_ = FileAnalyzer::Parse(&parser);
+verible::util::Status VerilogAnalyzer::ParsePreprocessed(
+    const verible::util::Status& preprocess_status, bool parsed,
+    size_t num_rejected_tokens) {
+  if (!preprocess_status.ok()) {
+    // Discard the results of parsing.
+    rejected_tokens_.erase(rejected_tokens_.begin() + num_rejected_tokens,
+                           rejected_tokens_.end());
+    MutableData().MutableSyntaxTree() = nullptr;
+    max_used_stack_size_ = 0;
+    for (const auto& error : preprocessor_data_.errors) {
+      rejected_tokens_.push_back(verible::RejectedToken{
+          error.token_info, verible::AnalysisPhase::kPreprocessPhase,
+          error.error_message});
+    }
+    // Leave the view of the tokens that would have been preprocessed.
+    FilterTokensForSyntaxTree();
+    parse_status_ = verible::util::InvalidArgumentError("Preprocessor error.");
+    return parse_status_;
+  }
+  MutableData().MutableTokenStreamView() =
+      preprocessor_data_.preprocessed_token_stream;  // copy
+  // TODO(fangism): could we just move, swap, or directly reference?
+
+  if (!parsed) {
+    if (ParseDesignUnitsConcurrently(Data().GetTokenStreamView(),
+                                     parse_threads_,
+                                     &MutableData().MutableSyntaxTree(),
+                                     &max_used_stack_size_)) {
+      parse_status_ = verible::util::OkStatus();
+    } else {
+      auto generator = MakeTokenViewer(Data().GetTokenStreamView());
+      VerilogParser parser(&generator, budget_);
+      parse_status_ = FileAnalyzer::Parse(&parser);
+      max_used_stack_size_ = parser.MaxUsedStackSize();
+    }
+  }
   // Here would be appropriate for analyzing the syntax tree.
-  max_used_stack_size_ = parser.MaxUsedStackSize();
 
   // Expand macro arguments that are parseable as expressions.
   if (parse_status_.ok() && SyntaxTree() != nullptr) {
@@ -254,6 +411,91 @@ verible::util::Status VerilogAnalyzer::Analyze() {
   return parse_status_;
 }
 
+std::unique_ptr<VerilogAnalyzer> VerilogAnalyzer::CopyLexedTokens() const {
+  auto copy = absl::make_unique<VerilogAnalyzer>(Data().Contents(), filename_);
+  copy->SetBudget(budget_);
+  copy->tokenized_ = true;
+  copy->lex_status_ = lex_status_;
+  const TokenSequence& tokens = Data().TokenStream();
+  auto& copy_data = copy->MutableData();
+  copy_data.MutableTokenStream() = tokens;
+  // Point the copied tokens at the copy's own text.
+  copy_data.RebaseTokensToSuperstring(copy_data.Contents(), Data().Contents(),
+                                      0);
+  copy_data.CalculateFirstTokensPerLine();
+  // The copy's view holds the same tokens, by position.
+  auto& copy_view = copy_data.MutableTokenStreamView();
+  copy_view.reserve(Data().GetTokenStreamView().size());
+  for (const auto& token : Data().GetTokenStreamView()) {
+    copy_view.push_back(copy_data.TokenStream().begin() +
+                        std::distance(tokens.begin(), token));
+  }
+  return copy;
+}
+
+VerilogAnalyzer::ConfigurationAnalyses VerilogAnalyzer::AnalyzeConfigurations(
+    absl::string_view text, absl::string_view name,
+    const std::vector<VerilogDefineSet>& configurations,
+    verible::ResourceBudget* budget,
+    const IncludeFileLoader& include_file_loader) {
+  ConfigurationAnalyses result;
+  auto lexed = absl::make_unique<VerilogAnalyzer>(text, name);
+  lexed->SetBudget(budget);
+  if (!lexed->AnalyzeTokens().ok()) {
+    result.analysis_of_configuration.assign(configurations.size(), 0);
+    result.analyzers.push_back(std::move(lexed));
+    return result;
+  }
+  std::vector<VerilogPreprocessData> preprocessed =
+      VerilogPreprocess::ScanConfigurations(
+          lexed->Data().GetTokenStreamView(), configurations,
+          include_file_loader);
+
+  // Identifies each distinct preprocessed stream by the positions of its
+  // tokens in the (shared) lexed token sequence.
+  const TokenSequence& tokens = lexed->Data().TokenStream();
+  std::map<std::vector<size_t>, size_t> analysis_of_stream;
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    VerilogPreprocessData& data = preprocessed[i];
+    std::vector<size_t> positions;
+    positions.reserve(data.preprocessed_token_stream.size());
+    for (const auto& token : data.preprocessed_token_stream) {
+      positions.push_back(std::distance(tokens.begin(), token));
+    }
+    // Streams that stopped at an error are not shared, because the errors
+    // may differ.
+    const bool shareable = data.errors.empty();
+    if (shareable) {
+      const auto found = analysis_of_stream.find(positions);
+      if (found != analysis_of_stream.end()) {
+        result.analysis_of_configuration.push_back(found->second);
+        continue;
+      }
+      analysis_of_stream.emplace(std::move(positions),
+                                 result.analyzers.size());
+    }
+    result.analysis_of_configuration.push_back(result.analyzers.size());
+    // Each distinct stream is analyzed in its own copy of the lexed tokens,
+    // preprocessed again so that the results refer to the copy.  Copying
+    // and preprocessing cost much less than lexing and parsing.
+    std::unique_ptr<VerilogAnalyzer> analyzer = lexed->CopyLexedTokens();
+    VerilogPreprocess preprocessor;
+    preprocessor.SetDefines(configurations[i]);
+    if (include_file_loader != nullptr) {
+      preprocessor.SetIncludeFileLoader(include_file_loader);
+    }
+    analyzer->preprocessor_data_ =
+        preprocessor.ScanStream(analyzer->Data().GetTokenStreamView());
+    analyzer->ParsePreprocessed(
+        analyzer->preprocessor_data_.errors.empty()
+            ? verible::util::OkStatus()
+            : verible::util::InvalidArgumentError("Preprocessor error."),
+        false, 0);
+    result.analyzers.push_back(std::move(analyzer));
+  }
+  return result;
+}
+
 namespace {
 using verible::MutableTreeVisitorRecursive;
 using verible::SymbolPtr;
@@ -19,15 +19,26 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "common/analysis/file_analyzer.h"
 #include "common/text/token_stream_view.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 #include "verilog/preprocessor/verilog_preprocess.h"
 
 namespace verilog {
 
+// Artifacts of analysis, ordered from cheapest to most expensive to produce.
+// Producing an artifact also produces all of the cheaper ones.
+enum class AnalysisArtifact {
+  kLines,       // Text split into lines, which requires no analysis.
+  kTokens,      // Lexed and contextualized tokens, without parsing.
+  kSyntaxTree,  // Preprocessed and parsed syntax tree (full analysis).
+};
+
 // VerilogAnalyzer analyzes Verilog and SystemVerilog code syntax.
 class VerilogAnalyzer : public verible::FileAnalyzer {
  public:
@@ -49,6 +60,19 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
   // if there are syntax errors.
   verible::util::Status Analyze();
 
+  // Sets the number of threads used to parse in Analyze() (default: 1).
+  // With more than one thread (or 0 for all hardware threads), a file with
+  // many top-level modules is parsed in concurrent pieces, which yields the
+  // same syntax tree.  When the file cannot be split safely, or has syntax
+  // errors, it is parsed serially.
+  void SetParseThreads(size_t num_threads) { parse_threads_ = num_threads; }
+
+  // Enables `include resolution during preprocessing in Analyze(), so that
+  // macros defined in included files are in PreprocessorData().
+  void SetIncludeFileLoader(IncludeFileLoader loader) {
+    include_file_loader_ = std::move(loader);
+  }
+
   verible::util::Status LexStatus() const { return lex_status_; }
 
   verible::util::Status ParseStatus() const { return parse_status_; }
@@ -57,8 +81,45 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
 
   // Automatically analyze with the correct parsing mode, as detected
   // by parser directive comments.
+  // 'parse_threads' is passed to SetParseThreads(), 'budget' to
+  // SetBudget(), and 'include_file_loader' to SetIncludeFileLoader().
+  // When the budget runs out, LexStatus() or ParseStatus() holds the
+  // budget's status, and the results of analysis are incomplete.
   static std::unique_ptr<VerilogAnalyzer> AnalyzeAutomaticMode(
-      absl::string_view text, absl::string_view name);
+      absl::string_view text, absl::string_view name,
+      size_t parse_threads = 1, verible::ResourceBudget* budget = nullptr,
+      const IncludeFileLoader& include_file_loader = nullptr);
+
+  // Analyzes only as far as needed to produce 'artifact', and skips the
+  // remaining (more expensive) stages of analysis.  For kSyntaxTree, this is
+  // the same as AnalyzeAutomaticMode().  Without parsing, ParseStatus() is
+  // always ok.
+  static std::unique_ptr<VerilogAnalyzer> AnalyzeUpTo(
+      absl::string_view text, absl::string_view name,
+      AnalysisArtifact artifact, verible::ResourceBudget* budget = nullptr,
+      const IncludeFileLoader& include_file_loader = nullptr);
+
+  // Results of AnalyzeConfigurations().
+  struct ConfigurationAnalyses {
+    // One analysis per distinct preprocessed token stream.
+    std::vector<std::unique_ptr<VerilogAnalyzer>> analyzers;
+
+    // Index into 'analyzers' of the analysis of each configuration.
+    std::vector<size_t> analysis_of_configuration;
+  };
+
+  // Analyzes 'text' once for each define set in 'configurations' (e.g. for
+  // ASIC, FPGA and simulation builds), with `ifdef and related directives
+  // evaluated (see VerilogPreprocess::SetDefines()).  The text is lexed
+  // only once, and configurations whose preprocessed token streams are
+  // identical share one parse.  Parsing mode directive comments are not
+  // honored.  If lexing fails, all configurations share the analysis that
+  // reports the lexical error.
+  static ConfigurationAnalyses AnalyzeConfigurations(
+      absl::string_view text, absl::string_view name,
+      const std::vector<VerilogDefineSet>& configurations,
+      verible::ResourceBudget* budget = nullptr,
+      const IncludeFileLoader& include_file_loader = nullptr);
 
   const VerilogPreprocessData& PreprocessorData() const {
     return preprocessor_data_;
@@ -72,6 +133,10 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
   // Apply context-based disambiguation of tokens.
   void ContextualizeTokens();
 
+  // Lex, filter, and contextualize tokens: everything before preprocessing
+  // and parsing.
+  verible::util::Status AnalyzeTokens();
+
   // Scan comments for parsing mode directives.
   // Returns a string that is first argument of the directive, e.g.:
   //     // verilog_syntax: mode-x
@@ -88,6 +153,19 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
   // syntax tree.  If parsing fails, leave the MacroArg token unexpanded.
   void ExpandMacroCallArgExpressions();
 
+  // Completes analysis once preprocessor_data_ holds the results of
+  // preprocessing, with 'preprocess_status': reports preprocessor errors,
+  // or else parses the preprocessed tokens (unless 'parsed' already).
+  // On preprocessor errors, rejected tokens past the first
+  // 'num_rejected_tokens' (from parsing) are discarded.
+  verible::util::Status ParsePreprocessed(
+      const verible::util::Status& preprocess_status, bool parsed,
+      size_t num_rejected_tokens);
+
+  // Returns an analyzer of the same text and name, with a copy of the
+  // lexed (and filtered) tokens of this one, ready to be preprocessed.
+  std::unique_ptr<VerilogAnalyzer> CopyLexedTokens() const;
+
   // Information about parser internals.
 
   // True if input text has already been lexed.
@@ -96,9 +174,15 @@ class VerilogAnalyzer : public verible::FileAnalyzer {
   // Maximum symbol stack depth.
   size_t max_used_stack_size_;
 
+  // Number of threads for parsing, see SetParseThreads().
+  size_t parse_threads_ = 1;
+
   // Preprocessor.
   VerilogPreprocessData preprocessor_data_;
 
+  // Resolves `include directives during preprocessing, if set.
+  IncludeFileLoader include_file_loader_;
+
   // If true, let comments control the parsing mode.
   bool use_parser_directive_comments_ = true;
 
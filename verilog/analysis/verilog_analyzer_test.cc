@@ -14,6 +14,7 @@
 
 #include "verilog/analysis/verilog_analyzer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -26,6 +27,8 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "common/analysis/file_analyzer.h"
 #include "common/text/concrete_syntax_leaf.h"
@@ -36,9 +39,11 @@
 #include "common/text/token_info.h"
 #include "common/text/token_info_test_util.h"
 #include "common/text/token_stream_view.h"
+#include "common/text/tree_compare.h"
 #include "common/text/tree_utils.h"
 #include "common/util/casts.h"
 #include "common/util/logging.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 #include "verilog/analysis/verilog_excerpt_parse.h"
 #include "verilog/parser/verilog_token_enum.h"
@@ -443,6 +448,63 @@ TEST(AnalyzeVerilogAutomaticMode, InferredModuleBodyModeFarthestFirstError) {
   EXPECT_EQ(token_info, expected_tokens.front());
 }
 
+// Tests that the token stream view after analysis holds exactly the
+// preprocessed tokens, without comments or whitespace.
+TEST(AnalyzeVerilogTest, TokenStreamViewIsPreprocessed) {
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(
+      "// comment\n`define FOO 1\nmodule m;  /* c */ endmodule\n", "<file>");
+  ASSERT_TRUE(analyzer->ParseStatus().ok());
+  std::vector<int> token_enums;
+  for (const auto& token : analyzer->Data().GetTokenStreamView()) {
+    token_enums.push_back(token->token_enum);
+  }
+  EXPECT_THAT(token_enums,
+              testing::ElementsAre(PP_define, PP_Identifier, PP_define_body,
+                                   TK_module, SymbolIdentifier, ';',
+                                   TK_endmodule, verible::TK_EOF));
+  EXPECT_EQ(analyzer->PreprocessorData().macro_definitions.size(), 1);
+}
+
+// Tests that a preprocessing error is reported instead of syntax errors,
+// even if the parser stopped before reaching it.
+TEST(AnalyzeVerilogTest, PreprocessorErrorAfterSyntaxError) {
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(
+      "module m endmodule\nmodule n; endmodule\n`define 789\n", "<file>");
+  EXPECT_FALSE(analyzer->ParseStatus().ok());
+  EXPECT_EQ(analyzer->SyntaxTree(), nullptr);
+  const auto& rejected_tokens = analyzer->GetRejectedTokens();
+  ASSERT_EQ(rejected_tokens.size(), 1);
+  EXPECT_EQ(rejected_tokens.front().phase,
+            verible::AnalysisPhase::kPreprocessPhase);
+}
+
+// Tests that parsing design units concurrently yields the same tree.
+TEST(AnalyzeVerilogAutomaticMode, ParallelParseSameTree) {
+  const char* kTestCases[] = {
+      // can be split
+      "module m1;\nendmodule\nmodule m2(input a);\nendmodule : m2\n"
+      "macromodule m3;\n  wire w = `FOO(1 + 2);\nendmodule\n",
+      // cannot be split: conditionals
+      "module m1;\nendmodule\n`ifdef FOO\nmodule m2;\nendmodule\n`endif\n",
+      // cannot be split: syntax error
+      "module m1;\nendmodule\nmodule m2\nendmodule\n"
+      "module m3;\nendmodule\n",
+  };
+  for (const auto* code : kTestCases) {
+    const auto serial = VerilogAnalyzer::AnalyzeAutomaticMode(code, "<file>");
+    const auto parallel =
+        VerilogAnalyzer::AnalyzeAutomaticMode(code, "<file>", 4);
+    EXPECT_EQ(serial->ParseStatus().ok(), parallel->ParseStatus().ok())
+        << code;
+    EXPECT_EQ(serial->GetRejectedTokens().size(),
+              parallel->GetRejectedTokens().size())
+        << code;
+    EXPECT_TRUE(verible::EqualTrees(serial->SyntaxTree().get(),
+                                    parallel->SyntaxTree().get()))
+        << code;
+  }
+}
+
 // The following tests cover integration between parsing Verilog
 // and verible::FileAnalyzer::FocusOnSubtreeSpanningSubstring
 // and verible::FileAnalyzer::ExpandSubtrees.
@@ -661,6 +723,96 @@ TEST(VerilogAnalyzerExpandsMacroArgsTest, MultipleMacroCalls) {
   }
 }
 
+TEST(VerilogAnalyzerBudgetTest, WithinBudget) {
+  verible::ResourceBudget budget(absl::Seconds(60), 0);
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(
+      "module m;\nendmodule\n", "<file>", 1, &budget);
+  EXPECT_OK(analyzer->LexStatus());
+  EXPECT_OK(analyzer->ParseStatus());
+  EXPECT_FALSE(analyzer->BudgetExhausted());
+  EXPECT_NE(analyzer->SyntaxTree(), nullptr);
+}
+
+TEST(VerilogAnalyzerBudgetTest, ExhaustedBudget) {
+  verible::ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(
+      "module m;\nendmodule\n", "<file>", 1, &budget);
+  EXPECT_EQ(analyzer->LexStatus().code(),
+            verible::util::StatusCode::kDeadlineExceeded);
+  EXPECT_TRUE(analyzer->BudgetExhausted());
+  // Running out of budget is not a syntax error.
+  EXPECT_TRUE(analyzer->GetRejectedTokens().empty());
+}
+
+TEST(VerilogAnalyzerBudgetTest, ExhaustedBudgetUpToTokens) {
+  verible::ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  const auto analyzer = VerilogAnalyzer::AnalyzeUpTo(
+      "module m;\nendmodule\n", "<file>", AnalysisArtifact::kTokens, &budget);
+  EXPECT_EQ(analyzer->LexStatus().code(),
+            verible::util::StatusCode::kDeadlineExceeded);
+  EXPECT_TRUE(analyzer->BudgetExhausted());
+}
+
+TEST(VerilogAnalyzerConfigurationsTest, IdenticalStreamsShareParse) {
+  constexpr absl::string_view kText =
+      "module m;\n"
+      "`ifdef FPGA\n"
+      "  wire fpga_w;\n"
+      "`elsif SIM\n"
+      "  wire sim_w;\n"
+      "`else\n"
+      "  wire asic_w;\n"
+      "`endif\n"
+      "endmodule\n";
+  const auto analyses = VerilogAnalyzer::AnalyzeConfigurations(
+      kText, "<file>", {{"FPGA"}, {"SIM"}, {}, {"FPGA", "SIM"}, {"OTHER"}});
+  ASSERT_THAT(analyses.analyzers, SizeIs(3));
+  EXPECT_THAT(analyses.analysis_of_configuration,
+              testing::ElementsAre(0, 1, 2, 0, 2));
+  const absl::string_view kWires[] = {"fpga_w", "sim_w", "asic_w"};
+  for (size_t i = 0; i < 3; ++i) {
+    const auto& analyzer = *analyses.analyzers[i];
+    EXPECT_OK(analyzer.LexStatus());
+    EXPECT_OK(analyzer.ParseStatus());
+    ASSERT_NE(analyzer.SyntaxTree(), nullptr);
+    // Each analysis refers to its own copy of the text.
+    EXPECT_EQ(analyzer.Data().Contents(), kText);
+    for (size_t j = 0; j < 3; ++j) {
+      const auto found = std::find_if(
+          analyzer.Data().GetTokenStreamView().begin(),
+          analyzer.Data().GetTokenStreamView().end(),
+          [&](const verible::TokenSequence::const_iterator token) {
+            return token->text == kWires[j];
+          });
+      EXPECT_EQ(found != analyzer.Data().GetTokenStreamView().end(), i == j)
+          << kWires[j] << " in analysis " << i;
+    }
+  }
+}
+
+TEST(VerilogAnalyzerConfigurationsTest, PreprocessorError) {
+  const auto analyses = VerilogAnalyzer::AnalyzeConfigurations(
+      "`ifdef A\nmodule m;\nendmodule\n", "<file>", {{}, {"A"}});
+  ASSERT_THAT(analyses.analyzers, SizeIs(2));
+  EXPECT_THAT(analyses.analysis_of_configuration, testing::ElementsAre(0, 1));
+  for (const auto& analyzer : analyses.analyzers) {
+    EXPECT_FALSE(analyzer->ParseStatus().ok());
+    ASSERT_THAT(analyzer->GetRejectedTokens(), SizeIs(1));
+    EXPECT_EQ(analyzer->GetRejectedTokens().front().phase,
+              AnalysisPhase::kPreprocessPhase);
+  }
+}
+
+TEST(VerilogAnalyzerConfigurationsTest, LexicalErrorShared) {
+  const auto analyses = VerilogAnalyzer::AnalyzeConfigurations(
+      "module 321foo;\nendmodule\n", "<file>", {{}, {"A"}});
+  ASSERT_THAT(analyses.analyzers, SizeIs(1));
+  EXPECT_THAT(analyses.analysis_of_configuration, testing::ElementsAre(0, 0));
+  EXPECT_FALSE(analyses.analyzers.front()->LexStatus().ok());
+}
+
 // Helper class for testing internals.
 class VerilogAnalyzerInternalsTest : public testing::Test,
                                      public VerilogAnalyzer {
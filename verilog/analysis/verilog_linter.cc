@@ -14,17 +14,22 @@
 
 #include "verilog/analysis/verilog_linter.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iomanip>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "common/analysis/line_lint_rule.h"
 #include "common/analysis/line_linter.h"
@@ -37,18 +42,25 @@
 #include "common/analysis/token_stream_lint_rule.h"
 #include "common/analysis/token_stream_linter.h"
 #include "common/text/concrete_syntax_tree.h"
+#include "common/text/flat_tree.h"
+#include "common/text/identifier_table.h"
 #include "common/text/line_column_map.h"
 #include "common/text/text_structure.h"
 #include "common/text/token_info.h"
 #include "common/util/file_util.h"
 #include "common/util/logging.h"
+#include "common/util/memory_usage.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
+#include "common/util/thread_pool.h"
 #include "verilog/analysis/default_rules.h"
 #include "verilog/analysis/lint_rule_registry.h"
 #include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/analysis/verilog_linter_configuration.h"
 #include "verilog/analysis/verilog_linter_constants.h"
 #include "verilog/parser/verilog_token_enum.h"
+#include "verilog/preprocessor/include_file_cache.h"
+#include "verilog/preprocessor/verilog_preprocess.h"
 
 ABSL_FLAG(verilog::RuleBundle, rules, {}, "List of lint rules to enable");
 ABSL_FLAG(verilog::RuleSet, ruleset, verilog::RuleSet::kDefault,
@@ -62,20 +74,58 @@ using verible::LintWaiver;
 using verible::TextStructureView;
 using verible::TokenInfo;
 
-int LintOneFile(std::ostream* stream, absl::string_view filename,
-                const LinterConfiguration& config, bool parse_fatal,
-                bool lint_fatal) {
-  std::string content;
-  if (!verible::file::GetContents(filename, &content)) return 2;
+// Runs a configured 'linter' on 'text_structure', and prints violations
+// to 'stream'.
+static void LintAndReport(std::ostream* stream, absl::string_view filename,
+                          absl::string_view contents, VerilogLinter* linter,
+                          const TextStructureView& text_structure) {
+  linter->Lint(text_structure, filename);
+
+  const absl::string_view text_base = text_structure.Contents();
+  // Each enabled lint rule yields a collection of violations.
+  const std::vector<LintRuleStatus> linter_statuses =
+      linter->ReportStatus(text_structure.GetLineColumnMap(), text_base);
+  size_t total_violations = 0;
+  for (const auto& rule_status : linter_statuses) {
+    total_violations += rule_status.violations.size();
+  }
+
+  if (total_violations == 0) {
+    VLOG(1) << "No lint violations found." << std::endl;
+  } else {
+    VLOG(1) << "Lint Violations (" << total_violations << "): " << std::endl;
+    // Output results to stream using formatter.
+    verible::LintStatusFormatter formatter(contents);
+    formatter.FormatLintRuleStatuses(stream, linter_statuses, text_base,
+                                     filename);
+  }
+}
+
+// Reports that analysis of 'filename' was cut short.
+static int ReportBudgetExhausted(std::ostream* stream,
+                                 absl::string_view filename,
+                                 const verible::ResourceBudget& budget) {
+  *stream << filename << ": analysis stopped: " << budget.status().message()
+          << std::endl;
+  return kLintBudgetExhausted;
+}
 
-  // Lex and parse the contents of the file.
-  const auto analyzer =
-      VerilogAnalyzer::AnalyzeAutomaticMode(content, filename);
-  const auto lex_status = ABSL_DIE_IF_NULL(analyzer)->LexStatus();
-  const auto parse_status = analyzer->ParseStatus();
+// Reports the syntax errors of 'analyzer', and the findings of a configured
+// 'linter' on it, and returns an exit status like LintOneFile().
+static int LintAnalyzedFile(std::ostream* stream, absl::string_view filename,
+                            absl::string_view content,
+                            const VerilogAnalyzer& analyzer,
+                            VerilogLinter* linter, bool parse_fatal,
+                            bool lint_fatal, AnalysisStats* stats,
+                            verible::ResourceBudget* budget) {
+  const auto lex_status = analyzer.LexStatus();
+  const auto parse_status = analyzer.ParseStatus();
+  if (analyzer.BudgetExhausted()) {
+    return ReportBudgetExhausted(stream, filename, *budget);
+  }
   if (!lex_status.ok() || !parse_status.ok()) {
     const std::vector<std::string> syntax_error_messages(
-        analyzer->LinterTokenErrorMessages());
+        analyzer.LinterTokenErrorMessages());
     for (const auto& message : syntax_error_messages) {
       *stream << message << std::endl;
     }
@@ -88,12 +138,15 @@ int LintOneFile(std::ostream* stream, absl::string_view filename,
 
   // Analyze the parsed structure for lint violations.
   std::ostringstream lint_stream;
-  const verible::util::Status lint_status = VerilogLintTextStructure(
-      &lint_stream, std::string(filename), content, config, analyzer->Data());
-  if (!lint_status.ok()) {
-    // Something went wrong with running the lint analysis itself.
-    LOG(ERROR) << "Fatal error: " << lint_status.message();
-    return 2;
+  const size_t resident_bytes_before_lint =
+      stats != nullptr ? verible::CurrentResidentMemoryBytes() : 0;
+  LintAndReport(&lint_stream, filename, content, linter, analyzer.Data());
+  if (stats != nullptr) {
+    stats->RecordMemoryGrowth("lint", resident_bytes_before_lint);
+  }
+  if (budget != nullptr && !budget->status().ok()) {
+    // Findings are incomplete.
+    return ReportBudgetExhausted(stream, filename, *budget);
   }
   *stream << lint_stream.str();
   if (!lint_stream.str().empty() && lint_fatal) {
@@ -102,8 +155,101 @@ int LintOneFile(std::ostream* stream, absl::string_view filename,
   return 0;
 }
 
-VerilogLinter::VerilogLinter()
-    : lint_waiver_(
+int LintOneFile(std::ostream* stream, absl::string_view filename,
+                const LinterConfiguration& config, bool parse_fatal,
+                bool lint_fatal, size_t num_threads, AnalysisStats* stats,
+                verible::ResourceBudget* budget) {
+  std::string content;
+  if (!verible::file::GetContents(filename, &content)) return 2;
+  return LintOneFileContents(stream, filename, content, config, parse_fatal,
+                             lint_fatal, num_threads, stats, budget);
+}
+
+int LintOneFileContents(std::ostream* stream, absl::string_view filename,
+                        absl::string_view content,
+                        const LinterConfiguration& config, bool parse_fatal,
+                        bool lint_fatal, size_t num_threads,
+                        AnalysisStats* stats, verible::ResourceBudget* budget) {
+  // Create the linter and add rules first, to learn how much analysis the
+  // enabled rules need.
+  VerilogLinter linter(num_threads);
+  AnalysisArtifact needed = linter.Configure(config);
+  linter.SetBudget(budget);
+  // Syntax errors can only be fatal if the file is parsed.
+  if (parse_fatal) needed = AnalysisArtifact::kSyntaxTree;
+
+  // Lex and parse the contents of the file, as far as needed.
+  // Tokens are always needed to find lint waivers in comments.
+  const size_t resident_bytes_before_analysis =
+      stats != nullptr ? verible::CurrentResidentMemoryBytes() : 0;
+  const auto analyzer = VerilogAnalyzer::AnalyzeUpTo(
+      content, filename, std::max(needed, AnalysisArtifact::kTokens), budget);
+  const VerilogAnalyzer& analyzed = *ABSL_DIE_IF_NULL(analyzer);
+  if (stats != nullptr) {
+    *stats = ComputeAnalysisStats(analyzed);
+    stats->RecordMemoryGrowth("analysis", resident_bytes_before_analysis);
+  }
+  return LintAnalyzedFile(stream, filename, content, analyzed, &linter,
+                          parse_fatal, lint_fatal, stats, budget);
+}
+
+// Returns the define set of a configuration as it would be given to a
+// simulator, e.g. "+define+FPGA+SIM".
+static std::string DefineSetLabel(const VerilogDefineSet& defines) {
+  if (defines.empty()) return "no defines";
+  return absl::StrCat("+define+", absl::StrJoin(defines, "+"));
+}
+
+int LintOneFileConfigurations(
+    std::ostream* stream, absl::string_view filename,
+    absl::string_view content,
+    const std::vector<VerilogDefineSet>& configurations,
+    const LinterConfiguration& config, bool parse_fatal, bool lint_fatal,
+    size_t num_threads, verible::ResourceBudget* budget,
+    const std::vector<std::string>& include_dirs) {
+  IncludeFileLoader include_file_loader;
+  if (!include_dirs.empty()) {
+    include_file_loader = MakeIncludeFileLoader(filename, include_dirs,
+                                                &IncludeFileCache::Global());
+  }
+  const auto analyses = VerilogAnalyzer::AnalyzeConfigurations(
+      content, filename, configurations, budget, include_file_loader);
+
+  // Lint each distinct analysis once (rules keep their findings, so each
+  // needs its own linter), and replay the results for every configuration
+  // that shares it.
+  std::vector<std::string> outputs(analyses.analyzers.size());
+  std::vector<int> exit_statuses(analyses.analyzers.size());
+  for (size_t i = 0; i < analyses.analyzers.size(); ++i) {
+    VerilogLinter linter(num_threads);
+    linter.Configure(config);
+    linter.SetBudget(budget);
+    std::ostringstream output;
+    exit_statuses[i] =
+        LintAnalyzedFile(&output, filename, content, *analyses.analyzers[i],
+                         &linter, parse_fatal, lint_fatal, nullptr, budget);
+    outputs[i] = output.str();
+    if (exit_statuses[i] == kLintBudgetExhausted) {
+      *stream << outputs[i];
+      return kLintBudgetExhausted;
+    }
+  }
+  int exit_status = 0;
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    const size_t analysis = analyses.analysis_of_configuration[i];
+    *stream << filename << ": with " << DefineSetLabel(configurations[i])
+            << std::endl
+            << outputs[analysis];
+    exit_status = std::max(exit_status, exit_statuses[analysis]);
+  }
+  return exit_status;
+}
+
+VerilogLinter::VerilogLinter(size_t num_threads)
+    : num_threads_(num_threads != 0
+                       ? num_threads
+                       : std::max(std::thread::hardware_concurrency(), 1u)),
+      lint_waiver_(
           [](const TokenInfo& t) {
             return t.token_enum == TK_COMMENT_BLOCK ||
                    t.token_enum == TK_EOL_COMMENT;
@@ -114,14 +260,20 @@ VerilogLinter::VerilogLinter()
           kLinterTrigger, kLinterWaiveLineCommand, kLinterWaiveStartCommand,
           kLinterWaiveStopCommand) {}
 
-void VerilogLinter::Configure(const LinterConfiguration& configuration) {
+AnalysisArtifact VerilogLinter::Configure(
+    const LinterConfiguration& configuration) {
   if (VLOG_IS_ON(1)) {
     for (const auto& name : configuration.ActiveRuleIds()) {
       LOG(INFO) << "active rule: '" << name << '\'';
     }
   }
+  AnalysisArtifact needed = AnalysisArtifact::kLines;
   auto text_rules = configuration.CreateTextStructureRules();
   for (auto& rule : text_rules) {
+    // Text structure rules may look at anything short of the syntax tree.
+    needed = std::max(needed, rule->NeedsSyntaxTree()
+                                  ? AnalysisArtifact::kSyntaxTree
+                                  : AnalysisArtifact::kTokens);
     text_structure_linter_.AddRule(std::move(rule));
   }
   auto line_rules = configuration.CreateLineRules();
@@ -129,34 +281,91 @@ void VerilogLinter::Configure(const LinterConfiguration& configuration) {
     line_linter_.AddRule(std::move(rule));
   }
   auto token_rules = configuration.CreateTokenStreamRules();
+  if (!token_rules.empty()) {
+    needed = std::max(needed, AnalysisArtifact::kTokens);
+  }
   for (auto& rule : token_rules) {
     token_stream_linter_.AddRule(std::move(rule));
   }
   auto syntax_rules = configuration.CreateSyntaxTreeRules();
-  for (auto& rule : syntax_rules) {
-    syntax_tree_linter_.AddRule(std::move(rule));
+  if (!syntax_rules.empty()) needed = AnalysisArtifact::kSyntaxTree;
+  // Divide rules into contiguous groups, one per thread, so that reporting
+  // groups in order reports rules in order.
+  const size_t num_groups = std::min(num_threads_, syntax_rules.size());
+  const size_t first_group = syntax_tree_linters_.size();
+  syntax_tree_linters_.resize(first_group + num_groups);
+  for (size_t i = 0; i < syntax_rules.size(); ++i) {
+    syntax_tree_linters_[first_group + i * num_groups / syntax_rules.size()]
+        .AddRule(std::move(syntax_rules[i]));
+  }
+  return needed;
+}
+
+// Returns true for tokens whose text is a name.
+static bool IsIdentifierToken(const TokenInfo& token) {
+  switch (token.token_enum) {
+    case SymbolIdentifier:
+    case EscapedIdentifier:
+    case SystemTFIdentifier:
+    case MacroIdentifier:
+    case MacroCallId:
+    case MacroIdItem:
+    case PP_Identifier:
+      return true;
+    default:
+      return false;
   }
 }
 
 void VerilogLinter::Lint(const TextStructureView& text_structure,
                          absl::string_view filename) {
-  // Collect all lint waivers in an initial pass.
-  lint_waiver_.ProcessTokenRangesByLine(text_structure);
+  // Intern identifiers at most once, so that rules classify each distinct
+  // name once.
+  identifiers_ = absl::make_unique<verible::LazyIdentifierTable>(
+      text_structure.TokenStream(), IsIdentifierToken);
+  token_stream_linter_.SetIdentifierTable(identifiers_.get());
+  for (auto& syntax_tree_linter : syntax_tree_linters_) {
+    syntax_tree_linter.SetIdentifierTable(identifiers_.get());
+  }
+
+  // Each analysis is independent of the others, and only reads
+  // 'text_structure'.
+  std::vector<std::function<void()>> analyses;
+
+  // Collect all lint waivers.
+  analyses.emplace_back(
+      [&]() { lint_waiver_.ProcessTokenRangesByLine(text_structure); });
 
   // Analyze general text structure.
-  text_structure_linter_.Lint(text_structure, filename);
+  analyses.emplace_back(
+      [&]() { text_structure_linter_.Lint(text_structure, filename); });
 
   // Analyze lines of text.
-  line_linter_.Lint(text_structure.Lines());
+  analyses.emplace_back([&]() { line_linter_.Lint(text_structure.Lines()); });
 
   // Analyze token stream.
-  token_stream_linter_.Lint(text_structure.TokenStream());
+  analyses.emplace_back(
+      [&]() { token_stream_linter_.Lint(text_structure.TokenStream()); });
 
-  // Analyze syntax tree.
+  // Analyze syntax tree, once per group of rules.  All groups traverse the
+  // same flattened tree.
   const verible::ConcreteSyntaxTree& syntax_tree = text_structure.SyntaxTree();
-  if (syntax_tree != nullptr) {
-    syntax_tree_linter_.Lint(*syntax_tree);
+  std::unique_ptr<verible::FlatSyntaxTree> flat_tree;
+  if (syntax_tree != nullptr && !syntax_tree_linters_.empty()) {
+    flat_tree = absl::make_unique<verible::FlatSyntaxTree>(syntax_tree.get());
+    for (auto& syntax_tree_linter : syntax_tree_linters_) {
+      syntax_tree_linter.SetBudget(budget_);
+      analyses.emplace_back([&]() { syntax_tree_linter.Lint(*flat_tree); });
+    }
+  }
+
+  if (num_threads_ <= 1) {
+    for (const auto& analysis : analyses) analysis();
+    return;
   }
+  verible::ThreadPool pool(num_threads_);
+  for (auto& analysis : analyses) pool.Schedule(std::move(analysis));
+  pool.Wait();
 }
 
 static void AppendLintRuleStatuses(
@@ -195,8 +404,10 @@ std::vector<LintRuleStatus> VerilogLinter::ReportStatus(
                          line_map, text_base, &statuses);
   AppendLintRuleStatuses(token_stream_linter_.ReportStatus(), waivers, line_map,
                          text_base, &statuses);
-  AppendLintRuleStatuses(syntax_tree_linter_.ReportStatus(), waivers, line_map,
-                         text_base, &statuses);
+  for (const auto& syntax_tree_linter : syntax_tree_linters_) {
+    AppendLintRuleStatuses(syntax_tree_linter.ReportStatus(), waivers,
+                           line_map, text_base, &statuses);
+  }
   return statuses;
 }
 
@@ -221,26 +432,7 @@ verible::util::Status VerilogLintTextStructure(
   // Create the linter, add rules, and run it.
   VerilogLinter linter;
   linter.Configure(config);
-  linter.Lint(text_structure, filename);
-
-  const absl::string_view text_base = text_structure.Contents();
-  // Each enabled lint rule yields a collection of violations.
-  const std::vector<LintRuleStatus> linter_statuses =
-      linter.ReportStatus(text_structure.GetLineColumnMap(), text_base);
-  size_t total_violations = 0;
-  for (const auto& rule_status : linter_statuses) {
-    total_violations += rule_status.violations.size();
-  }
-
-  if (total_violations == 0) {
-    VLOG(1) << "No lint violations found." << std::endl;
-  } else {
-    VLOG(1) << "Lint Violations (" << total_violations << "): " << std::endl;
-    // Output results to stream using formatter.
-    verible::LintStatusFormatter formatter(contents);
-    formatter.FormatLintRuleStatuses(stream, linter_statuses, text_base,
-                                     filename);
-  }
+  LintAndReport(stream, filename, contents, &linter, text_structure);
   return verible::util::OkStatus();
 }
 
@@ -269,18 +461,30 @@ verible::util::Status PrintRuleInfo(
 
 void GetLintRuleDescriptionsHelpFlag(std::ostream* os,
                                      absl::string_view flag_value) {
-  // Set up the map.
-  auto rule_map = analysis::GetAllRuleDescriptionsHelpFlag();
-  for (const auto& rule_id : analysis::kDefaultRuleSet) {
-    rule_map[rule_id].default_enabled = true;
-  }
-
   if (flag_value != "all") {
+    // Only describe the requested rule.
+    analysis::LintRuleDescriptionsMap rule_map;
+    const analysis::LintRuleId rule_id =
+        analysis::RegisteredLintRuleName(flag_value);
+    if (!rule_id.empty()) {
+      auto& info = rule_map[rule_id];
+      info.description = analysis::GetLintRuleDescription(
+          rule_id, analysis::DescriptionType::kHelpRulesFlag);
+      for (const absl::string_view default_rule : analysis::kDefaultRuleSet) {
+        if (default_rule == rule_id) info.default_enabled = true;
+      }
+    }
     const auto status = PrintRuleInfo(os, rule_map, flag_value);
     if (!status.ok()) *os << status.message();
     return;
   }
 
+  // Set up the map.
+  auto rule_map = analysis::GetAllRuleDescriptionsHelpFlag();
+  for (const auto& rule_id : analysis::kDefaultRuleSet) {
+    rule_map[rule_id].default_enabled = true;
+  }
+
   // Print all rules.
   for (const auto& rule : rule_map) {
     const auto status = PrintRuleInfo(os, rule_map, rule.first);
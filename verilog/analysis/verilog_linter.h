@@ -15,7 +15,9 @@
 #ifndef VERIBLE_VERILOG_ANALYSIS_VERILOG_LINTER_H_
 #define VERIBLE_VERILOG_ANALYSIS_VERILOG_LINTER_H_
 
+#include <cstddef>
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -26,11 +28,16 @@
 #include "common/analysis/syntax_tree_linter.h"
 #include "common/analysis/text_structure_linter.h"
 #include "common/analysis/token_stream_linter.h"
+#include "common/text/identifier_table.h"
 #include "common/text/line_column_map.h"
 #include "common/text/text_structure.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
+#include "verilog/analysis/analysis_stats.h"
 #include "verilog/analysis/lint_rule_registry.h"
+#include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/analysis/verilog_linter_configuration.h"
+#include "verilog/preprocessor/verilog_preprocess.h"
 
 namespace verilog {
 
@@ -41,21 +48,80 @@ namespace verilog {
 // 'config' controls lint rules for analysis.
 // If 'parse_fatal' is true, abort after encountering syntax errors, else
 // continue to analyze the salvaged code structure.
+// The file is only analyzed as far as the enabled rules require: when no
+// enabled rule examines the syntax tree and 'parse_fatal' is false, the file
+// is not parsed, and syntax errors (other than lexical errors) go
+// unreported.
 // If 'lint_fatal' is true, exit nonzero on finding lint violations.
+// 'num_threads' is passed to the VerilogLinter that analyzes the file.
+// If 'stats' is not null, it receives statistics about the analyzed file,
+// with the growth of memory recorded for analysis and for linting.
+// If 'budget' is not null, analysis stops once it is exhausted, and only
+// the budget's status is reported.
 // Returns an exit_code like status where 0 means success, 1 means some
-// errors were found (syntax, lint), and anything else is a fatal error.
+// errors were found (syntax, lint), kLintBudgetExhausted means that the
+// budget ran out, and anything else is a fatal error.
 int LintOneFile(std::ostream* stream, absl::string_view filename,
                 const LinterConfiguration& config, bool parse_fatal,
-                bool lint_fatal);
+                bool lint_fatal, size_t num_threads = 1,
+                AnalysisStats* stats = nullptr,
+                verible::ResourceBudget* budget = nullptr);
+
+// Same as LintOneFile(), for a file whose 'content' was already read.
+int LintOneFileContents(std::ostream* stream, absl::string_view filename,
+                        absl::string_view content,
+                        const LinterConfiguration& config, bool parse_fatal,
+                        bool lint_fatal, size_t num_threads = 1,
+                        AnalysisStats* stats = nullptr,
+                        verible::ResourceBudget* budget = nullptr);
+
+// Same as LintOneFileContents(), but analyzes the file once for each define
+// set in 'configurations', with `ifdef and related directives evaluated
+// (see VerilogAnalyzer::AnalyzeConfigurations()).  The file is lexed once,
+// and configurations whose preprocessed tokens are identical share one parse
+// and one lint pass.  The diagnostics of each configuration follow a line
+// that names it, as in "file.sv: with +define+FPGA+SIM".  The file is always
+// parsed.  If 'include_dirs' is not empty, `include directives are resolved
+// in the directory of the file and then in 'include_dirs', so that `ifdef
+// sees the macros defined by included files; included files are shared with
+// other files through IncludeFileCache.  Included files do not otherwise
+// change the analysis.  Returns the highest exit status of all
+// configurations.
+int LintOneFileConfigurations(
+    std::ostream* stream, absl::string_view filename,
+    absl::string_view content,
+    const std::vector<VerilogDefineSet>& configurations,
+    const LinterConfiguration& config, bool parse_fatal, bool lint_fatal,
+    size_t num_threads = 1, verible::ResourceBudget* budget = nullptr,
+    const std::vector<std::string>& include_dirs = {});
+
+// Exit status of LintOneFile() for a file whose analysis ran out of budget.
+constexpr int kLintBudgetExhausted = 3;
 
 // VerilogLinter analyzes a TextStructureView of Verilog source code.
 // This uses syntax-tree based analyses and lexical token-stream analyses.
+//
+// The line, token-stream, text-structure and syntax-tree analyses only read
+// the TextStructureView, and every rule keeps its own state, so they can run
+// concurrently.  Syntax-tree rules are further divided into groups, each of
+// which traverses the tree on its own.  Results are reported in the same
+// order regardless of the number of threads.
 class VerilogLinter {
  public:
-  VerilogLinter();
+  // 'num_threads' is the number of threads used to Lint(); 1 analyzes
+  // sequentially in the calling thread, and 0 uses all hardware threads.
+  // Concurrency pays off only for large files.
+  explicit VerilogLinter(size_t num_threads = 1);
 
   // Configures the internal linters, enabling select rules.
-  void Configure(const LinterConfiguration& configuration);
+  // Returns the most expensive artifact of analysis that the enabled rules
+  // need, so callers can skip analysis that no rule will look at.
+  // Note that lint waivers are found in comments, which requires tokens.
+  AnalysisArtifact Configure(const LinterConfiguration& configuration);
+
+  // Limits the time and memory spent on syntax tree analysis in Lint().
+  // 'budget' (not owned) must outlive Lint(); nullptr means unlimited.
+  void SetBudget(verible::ResourceBudget* budget) { budget_ = budget; }
 
   // Analyzes text structure.
   void Lint(const verible::TextStructureView& text_structure,
@@ -72,14 +138,25 @@ class VerilogLinter {
   // Token-based linter.
   verible::TokenStreamLinter token_stream_linter_;
 
-  // Syntax-tree based linter.
-  verible::SyntaxTreeLinter syntax_tree_linter_;
+  // Number of threads used by Lint().
+  const size_t num_threads_;
+
+  // Syntax-tree based linters, each with a disjoint group of rules.
+  // Rules are grouped in the order they were added.
+  std::vector<verible::SyntaxTreeLinter> syntax_tree_linters_;
 
   // TextStructure-based linter.
   verible::TextStructureLinter text_structure_linter_;
 
   // Tracks the set of waived lines per rule.
   verible::LintWaiverBuilder lint_waiver_;
+
+  // Limits syntax tree analysis, if not null.
+  verible::ResourceBudget* budget_ = nullptr;
+
+  // Identifiers of the file being analyzed, shared by all rules and only
+  // interned if one of them looks them up.
+  std::unique_ptr<verible::LazyIdentifierTable> identifiers_;
 };
 
 // Creates a linter configuration from global flags.
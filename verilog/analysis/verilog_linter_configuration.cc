@@ -115,7 +115,6 @@ void LinterConfiguration::UseRuleSet(const RuleSet& rules) {
 }
 
 void LinterConfiguration::UseRuleBundle(const RuleBundle& rule_bundle) {
-  const auto name_set = analysis::GetAllRegisteredLintRuleNames();
   for (const auto& rule_pair : rule_bundle.rules) {
     // This needs to use the canonical registered key string_view, which has
     // guaranteed lifetime.
@@ -295,17 +294,17 @@ bool AbslParseFlag(absl::string_view text, RuleBundle* bundle,
         stripped_rule_text = "";
     }
 
-    const auto rule_name_set = analysis::GetAllRegisteredLintRuleNames();
-    const auto rule_iter = rule_name_set.find(stripped_rule_text);
+    const analysis::LintRuleId rule_name =
+        analysis::RegisteredLintRuleName(stripped_rule_text);
 
     // Check if text is a valid lint rule.
-    if (rule_iter == rule_name_set.end()) {
+    if (rule_name.empty()) {
       *error = absl::StrCat("invalid flag \"", stripped_rule_text, "\"");
       return false;
     } else {
       // Map keys must use canonical registered string_views for guaranteed
       // lifetime, not just any string-equivalent copy.
-      bundle->rules[*rule_iter] = setting;
+      bundle->rules[rule_name] = setting;
     }
   }
 
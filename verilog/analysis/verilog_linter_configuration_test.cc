@@ -40,6 +40,7 @@
 #include "verilog/analysis/default_rules.h"
 #include "verilog/analysis/descriptions.h"
 #include "verilog/analysis/lint_rule_registry.h"
+#include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/analysis/verilog_linter.h"
 
 namespace verilog {
@@ -258,7 +259,7 @@ TEST(VerilogSyntaxTreeLinterConfigurationTest, AddsExpectedNumber) {
   EXPECT_THAT(config.ActiveRuleIds(), SizeIs(2));
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kSyntaxTree);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
@@ -266,6 +267,25 @@ TEST(VerilogSyntaxTreeLinterConfigurationTest, AddsExpectedNumber) {
   EXPECT_THAT(status, SizeIs(2));
 }
 
+// Confirms that rules yield the same set of results with multiple threads.
+TEST(VerilogSyntaxTreeLinterConfigurationTest, AddsExpectedNumberConcurrent) {
+  LinterConfiguration config;
+  config.TurnOn("test-rule-1");
+  config.TurnOn("test-rule-2");
+  config.TurnOn("test-rule-3");
+  config.TurnOn("test-rule-4");
+  config.TurnOn("test-rule-5");
+  EXPECT_THAT(config.ActiveRuleIds(), SizeIs(5));
+
+  VerilogLinter linter(4);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kSyntaxTree);
+  FakeTextStructureView text_structure;
+  linter.Lint(text_structure, filename);
+
+  auto status = linter.ReportStatus(dummy_map, text_structure.Contents());
+  EXPECT_THAT(status, SizeIs(5));
+}
+
 // Confirms that each token stream rule yields a set of results.
 TEST(VerilogTokenStreamLinterConfigurationTest, AddsExpectedNumber) {
   LinterConfiguration config;
@@ -275,7 +295,7 @@ TEST(VerilogTokenStreamLinterConfigurationTest, AddsExpectedNumber) {
   EXPECT_THAT(config.ActiveRuleIds(), SizeIs(1));
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kTokens);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
@@ -292,7 +312,7 @@ TEST(VerilogLineLinterConfigurationTest, AddsExpectedNumber) {
   EXPECT_THAT(config.ActiveRuleIds(), SizeIs(1));
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kLines);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
@@ -309,7 +329,7 @@ TEST(VerilogTextStructureLinterConfigurationTest, AddsExpectedNumber) {
   EXPECT_THAT(config.ActiveRuleIds(), SizeIs(1));
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kSyntaxTree);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
@@ -328,7 +348,7 @@ TEST(VerilogSyntaxTreeLinterConfigurationTest, TurnOnTurnOff) {
   EXPECT_THAT(config.ActiveRuleIds(), IsEmpty());
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kLines);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
@@ -399,7 +419,7 @@ TEST(VerilogSyntaxTreeLinterConfigurationTest, DefaultEmpty) {
   EXPECT_THAT(config.ActiveRuleIds(), IsEmpty());
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kLines);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
@@ -418,7 +438,7 @@ TEST(VerilogSyntaxTreeLinterConfigurationTest, UseRuleSetAll) {
   EXPECT_THAT(config.ActiveRuleIds(), SizeIs(expected_size));
 
   VerilogLinter linter;
-  linter.Configure(config);
+  EXPECT_EQ(linter.Configure(config), AnalysisArtifact::kSyntaxTree);
   FakeTextStructureView text_structure;
   linter.Lint(text_structure, filename);
 
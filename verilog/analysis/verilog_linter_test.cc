@@ -30,9 +30,14 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/util/file_util.h"
 #include "common/util/logging.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 #include "common/util/statusor.h"
 #include "verilog/analysis/default_rules.h"
@@ -110,6 +115,37 @@ TEST_F(LintOneFileTest, SyntaxError) {
   }
 }
 
+// Tests that files are not parsed when no enabled rule needs a syntax tree.
+TEST(LintOneFileWithoutTreeRulesTest, SyntaxErrorParsedOnlyIfFatal) {
+  LinterConfiguration config;
+  config.UseRuleSet(RuleSet::kNone);
+  config.TurnOn("no-trailing-spaces");
+  const ScopedTestFile temp_file(testing::TempDir(),
+                                 "class foo;\n"  // no endclass
+                                 "  wire w; \n"  // trailing space
+  );
+  {  // syntax errors go unnoticed without parsing
+    std::ostringstream output;
+    const int exit_code =
+        LintOneFile(&output, temp_file.filename(), config, false, false);
+    EXPECT_EQ(exit_code, 0) << "output:\n" << output.str();
+  }
+  {  // but the file is parsed when syntax errors are fatal
+    std::ostringstream output;
+    const int exit_code =
+        LintOneFile(&output, temp_file.filename(), config, true, false);
+    EXPECT_NE(exit_code, 0) << "output:\n" << output.str();
+  }
+  {  // lint violations are still found
+    std::ostringstream output;
+    const int exit_code =
+        LintOneFile(&output, temp_file.filename(), config, false, true);
+    EXPECT_EQ(exit_code, 1) << "output:\n" << output.str();
+    EXPECT_TRUE(absl::StrContains(output.str(), "no-trailing-spaces"))
+        << "output:\n" << output.str();
+  }
+}
+
 TEST_F(LintOneFileTest, LintError) {
   const absl::string_view kTestCases[] = {
       "task automatic foo;\n"
@@ -132,6 +168,114 @@ TEST_F(LintOneFileTest, LintError) {
   }
 }
 
+// Tests that running out of budget is reported instead of findings.
+TEST_F(LintOneFileTest, BudgetExhausted) {
+  const absl::string_view test_code =
+      "task automatic foo;\n"
+      "  $psprintf(\"blah\");\n"  // forbidden function
+      "endtask\n";
+  verible::ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  std::ostringstream output;
+  const int exit_code =
+      LintOneFileContents(&output, "foo.sv", test_code, config_, false, true,
+                          1, nullptr, &budget);
+  EXPECT_EQ(exit_code, kLintBudgetExhausted);
+  EXPECT_TRUE(absl::StrContains(output.str(), "foo.sv: analysis stopped:"))
+      << "output:\n" << output.str();
+  EXPECT_FALSE(absl::StrContains(output.str(), "psprintf"))
+      << "output:\n" << output.str();
+}
+
+// Tests that a sufficient budget does not change the results.
+TEST_F(LintOneFileTest, WithinBudget) {
+  const absl::string_view test_code =
+      "task automatic foo;\n"
+      "  $psprintf(\"blah\");\n"  // forbidden function
+      "endtask\n";
+  verible::ResourceBudget budget(absl::Seconds(60), 0);
+  std::ostringstream output;
+  const int exit_code =
+      LintOneFileContents(&output, "foo.sv", test_code, config_, false, true,
+                          1, nullptr, &budget);
+  EXPECT_EQ(exit_code, 1);
+  EXPECT_TRUE(absl::StrContains(output.str(), "psprintf"))
+      << "output:\n" << output.str();
+}
+
+// Tests that linting already-read contents is the same as linting the file.
+TEST_F(LintOneFileTest, ContentsSameAsFile) {
+  const absl::string_view test_code =
+      "task automatic foo;\n"
+      "  $psprintf(\"blah\");\n"  // forbidden function
+      "endtask\n";
+  const ScopedTestFile temp_file(testing::TempDir(), test_code);
+  for (const bool lint_fatal : {false, true}) {
+    std::ostringstream file_output, contents_output;
+    const int file_exit_code = LintOneFile(
+        &file_output, temp_file.filename(), config_, false, lint_fatal);
+    const int contents_exit_code =
+        LintOneFileContents(&contents_output, temp_file.filename(), test_code,
+                            config_, false, lint_fatal);
+    EXPECT_EQ(contents_exit_code, file_exit_code);
+    EXPECT_EQ(contents_output.str(), file_output.str());
+    EXPECT_FALSE(contents_output.str().empty());
+  }
+}
+
+// Tests that findings are reported for each configuration of defines.
+TEST_F(LintOneFileTest, Configurations) {
+  const absl::string_view test_code =
+      "task automatic foo;\n"
+      "`ifdef SIM\n"
+      "  $psprintf(\"blah\");\n"  // forbidden function
+      "`endif\n"
+      "endtask\n";
+  std::ostringstream output;
+  const int exit_code = LintOneFileConfigurations(
+      &output, "foo.sv", test_code, {{}, {"SIM"}, {"SIM", "FPGA"}}, config_,
+      false, true);
+  EXPECT_EQ(exit_code, 1);
+  const std::vector<absl::string_view> sections =
+      absl::StrSplit(output.str(), "foo.sv: with ");
+  ASSERT_EQ(sections.size(), 4) << "output:\n" << output.str();
+  EXPECT_TRUE(absl::StartsWith(sections[1], "no defines\n"));
+  EXPECT_FALSE(absl::StrContains(sections[1], "psprintf"));
+  EXPECT_TRUE(absl::StartsWith(sections[2], "+define+SIM\n"));
+  EXPECT_TRUE(absl::StrContains(sections[2], "psprintf"));
+  EXPECT_TRUE(absl::StartsWith(sections[3], "+define+FPGA+SIM\n"));
+  EXPECT_TRUE(absl::StrContains(sections[3], "psprintf"));
+}
+
+// Tests that concurrent linting reports the same findings in the same order.
+TEST(LintOneFileConcurrentTest, SameAsSequential) {
+  LinterConfiguration config;
+  config.UseRuleSet(RuleSet::kAll);
+  const ScopedTestFile temp_file(testing::TempDir(),
+                                 "module Bad_Name;\n"
+                                 "\talways @* begin  \n"
+                                 "    x = $psprintf(\"blah\");\n"
+                                 "  end\n"
+                                 "  // verilog_lint: waive line-length\n"
+                                 "  wire "
+                                 "a_very_long_name_to_exceed_the_line_length_"
+                                 "limit_of_the_line_length_rule_xxxxxxxxxx;\n"
+                                 "endmodule");
+  std::ostringstream sequential_output;
+  const int sequential_exit_code = LintOneFile(
+      &sequential_output, temp_file.filename(), config, false, true, 1);
+  EXPECT_EQ(sequential_exit_code, 1);
+  EXPECT_FALSE(sequential_output.str().empty());
+  for (const size_t num_threads : {2, 3, 4, 16}) {
+    std::ostringstream output;
+    const int exit_code = LintOneFile(&output, temp_file.filename(), config,
+                                      false, true, num_threads);
+    EXPECT_EQ(exit_code, sequential_exit_code) << "threads: " << num_threads;
+    EXPECT_EQ(output.str(), sequential_output.str())
+        << "threads: " << num_threads;
+  }
+}
+
 class VerilogLinterTest : public DefaultLinterConfigTestFixture,
                           public testing::Test {
  public:
@@ -0,0 +1,149 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Tests that lexing, parsing and each phase of linting scale linearly with
+// the size of their input, for synthetic sources that grow in different
+// dimensions.  Superlinear work would show as growth exponents above the
+// limits; see common/util/scaling_test_util.h.  By default, timings are only
+// checked against a loose limit that rejects quadratic growth; their tighter
+// limits are checked when VERIBLE_CHECK_SCALING_TIME=1.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/util/scaling_test_util.h"
+#include "verilog/analysis/lint_rule_registry.h"
+#include "verilog/analysis/synthetic_verilog.h"
+#include "verilog/analysis/verilog_analyzer.h"
+#include "verilog/analysis/verilog_linter.h"
+#include "verilog/analysis/verilog_linter_configuration.h"
+#include "verilog/parser/verilog_lexer.h"
+
+namespace verilog {
+namespace {
+
+using verible::testing::ExpectGrowthWithin;
+using verible::testing::GeometricScales;
+using verible::testing::kLinearGrowth;
+using verible::testing::kLinearithmicGrowth;
+using verible::testing::MeasureScaling;
+using verible::testing::ScalingWork;
+
+constexpr absl::string_view kFilename = "synthetic.sv";
+
+// Four sizes, over a range of 8x.
+std::vector<size_t> Scales(const SyntheticVerilogShape& shape) {
+  return GeometricScales(shape.base_scale, 2, 4);
+}
+
+// Measurements are only meaningful for sources that parse as intended.
+TEST(SyntheticVerilogTest, Parses) {
+  for (const auto& shape : SyntheticVerilogShapes()) {
+    const std::string text = shape.generate(shape.base_scale);
+    const auto analyzer =
+        VerilogAnalyzer::AnalyzeAutomaticMode(text, kFilename);
+    const auto status = analyzer->ParseStatus();
+    if (shape.syntax_errors) {
+      EXPECT_FALSE(status.ok()) << shape.name;
+      // Parsing recovered, and built a partial syntax tree.
+      EXPECT_NE(analyzer->Data().SyntaxTree(), nullptr) << shape.name;
+    } else {
+      EXPECT_TRUE(status.ok()) << shape.name << ": " << status.message();
+    }
+  }
+}
+
+TEST(VerilogScalingTest, Lexer) {
+  for (const auto& shape : SyntheticVerilogShapes()) {
+    const auto samples = MeasureScaling(
+        [&shape](size_t n) {
+          auto text = std::make_shared<std::string>(shape.generate(n));
+          return ScalingWork{text->size(), [text]() {
+                               VerilogLexer lexer(*text);
+                               while (!lexer.DoNextToken().isEOF()) {
+                               }
+                             }};
+        },
+        Scales(shape));
+    ExpectGrowthWithin(absl::StrCat("lexer, ", shape.name), samples,
+                       kLinearGrowth);
+  }
+}
+
+// Lexes, preprocesses and parses, retrying in another mode after syntax
+// errors, as the tools do.
+TEST(VerilogScalingTest, Analyzer) {
+  for (const auto& shape : SyntheticVerilogShapes()) {
+    const auto samples = MeasureScaling(
+        [&shape](size_t n) {
+          auto text = std::make_shared<std::string>(shape.generate(n));
+          return ScalingWork{text->size(), [text]() {
+                               VerilogAnalyzer::AnalyzeAutomaticMode(
+                                   *text, kFilename);
+                             }};
+        },
+        Scales(shape));
+    ExpectGrowthWithin(absl::StrCat("analyzer, ", shape.name), samples,
+                       kLinearGrowth);
+  }
+}
+
+// Rules of one kind, which VerilogLinter runs as one phase.
+struct LintPhase {
+  absl::string_view name;
+  std::vector<analysis::LintRuleId> (*rules)();
+};
+
+TEST(VerilogScalingTest, LinterPhases) {
+  const LintPhase phases[] = {
+      {"line rules", &analysis::RegisteredLineRulesNames},
+      {"token stream rules", &analysis::RegisteredTokenStreamRulesNames},
+      {"syntax tree rules", &analysis::RegisteredSyntaxTreeRulesNames},
+      {"text structure rules", &analysis::RegisteredTextStructureRulesNames},
+  };
+  for (const auto& phase : phases) {
+    LinterConfiguration config;
+    config.UseRuleSet(RuleSet::kNone);
+    for (const auto& rule : phase.rules()) config.TurnOn(rule);
+    for (const auto& shape : SyntheticVerilogShapes()) {
+      const auto samples = MeasureScaling(
+          [&shape, &config](size_t n) {
+            auto text = std::make_shared<std::string>(shape.generate(n));
+            std::shared_ptr<VerilogAnalyzer> analyzer =
+                VerilogAnalyzer::AnalyzeAutomaticMode(*text, kFilename);
+            return ScalingWork{
+                text->size(), [text, analyzer, &config]() {
+                  const auto& data = analyzer->Data();
+                  VerilogLinter linter;
+                  linter.Configure(config);
+                  linter.Lint(data, kFilename);
+                  linter.ReportStatus(data.GetLineColumnMap(),
+                                      data.Contents());
+                }};
+          },
+          Scales(shape));
+      // Violations are reported in sorted order.
+      ExpectGrowthWithin(absl::StrCat(phase.name, ", ", shape.name), samples,
+                         kLinearithmicGrowth);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace verilog
@@ -0,0 +1,94 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verilog/analysis/verilog_symbols.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/analysis/syntax_tree_search.h"
+#include "common/text/line_column_map.h"
+#include "common/text/token_info.h"
+#include "verilog/CST/class.h"
+#include "verilog/CST/module.h"
+#include "verilog/CST/package.h"
+#include "verilog/analysis/symbol_index.h"
+#include "verilog/analysis/verilog_analyzer.h"
+
+namespace verilog {
+
+using verible::TokenInfo;
+
+std::vector<SymbolLocation> ExtractVerilogSymbols(absl::string_view path,
+                                                  absl::string_view contents) {
+  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(contents, path);
+  const auto& data = analyzer->Data();
+  const auto& tree = data.SyntaxTree();
+  std::vector<SymbolLocation> symbols;
+  if (tree == nullptr) return symbols;
+
+  const absl::string_view base = data.Contents();
+  const verible::LineColumnMap& line_column_map = data.GetLineColumnMap();
+  const auto add = [&](const TokenInfo& token, IndexedSymbolKind kind,
+                       bool is_definition) {
+    SymbolLocation symbol;
+    symbol.name = std::string(token.text);
+    symbol.kind = kind;
+    symbol.is_definition = is_definition;
+    const auto position = line_column_map(token.left(base));
+    symbol.line = position.line + 1;
+    symbol.column = position.column + 1;
+    symbols.push_back(std::move(symbol));
+  };
+
+  for (const auto& match : FindAllModuleDeclarations(*tree)) {
+    add(GetModuleNameToken(*match.match), IndexedSymbolKind::kModule, true);
+  }
+  for (const auto& match : FindAllInterfaceDeclarations(*tree)) {
+    add(GetInterfaceNameToken(*match.match), IndexedSymbolKind::kInterface,
+        true);
+  }
+  for (const auto& match : FindAllPackageDeclarations(*tree)) {
+    add(GetPackageNameToken(*match.match), IndexedSymbolKind::kPackage, true);
+  }
+  for (const auto& match : FindAllClassDeclarations(*tree)) {
+    add(GetClassNameToken(*match.match), IndexedSymbolKind::kClass, true);
+    const TokenInfo* base_class = GetClassExtendsNameToken(*match.match);
+    if (base_class != nullptr) {
+      add(*base_class, IndexedSymbolKind::kClass, false);
+    }
+  }
+  // Syntax alone does not tell instantiated modules from interfaces.
+  for (const auto& match : FindAllModuleInstantiations(*tree)) {
+    add(GetModuleInstantiationTypeToken(*match.match),
+        IndexedSymbolKind::kModule, false);
+  }
+  for (const auto& match : FindAllPackageImportItems(*tree)) {
+    const TokenInfo& package = GetImportedPackageNameToken(*match.match);
+    // "export *::*" names no package.
+    if (package.text != "*") add(package, IndexedSymbolKind::kPackage, false);
+  }
+
+  std::sort(symbols.begin(), symbols.end(),
+            [](const SymbolLocation& left, const SymbolLocation& right) {
+              return left.line != right.line ? left.line < right.line
+                                             : left.column < right.column;
+            });
+  return symbols;
+}
+
+}  // namespace verilog
@@ -0,0 +1,36 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VERIBLE_VERILOG_ANALYSIS_VERILOG_SYMBOLS_H_
+#define VERIBLE_VERILOG_ANALYSIS_VERILOG_SYMBOLS_H_
+
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "verilog/analysis/symbol_index.h"
+
+namespace verilog {
+
+// Returns the definitions of modules, interfaces, packages and classes in
+// Verilog source 'contents', and the references to them: module and
+// interface instantiations, package imports, and base classes.  Symbols are
+// ordered by position.  Files with syntax errors yield the symbols of the
+// recovered syntax tree.  This is a SymbolExtractor, for IndexFiles().
+std::vector<SymbolLocation> ExtractVerilogSymbols(absl::string_view path,
+                                                  absl::string_view contents);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_ANALYSIS_VERILOG_SYMBOLS_H_
@@ -0,0 +1,83 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verilog/analysis/verilog_symbols.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "verilog/analysis/symbol_index.h"
+
+namespace verilog {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+SymbolLocation Symbol(absl::string_view name, IndexedSymbolKind kind,
+                      bool is_definition, int line, int column) {
+  SymbolLocation symbol;
+  symbol.name = std::string(name);
+  symbol.kind = kind;
+  symbol.is_definition = is_definition;
+  symbol.line = line;
+  symbol.column = column;
+  return symbol;
+}
+
+TEST(ExtractVerilogSymbolsTest, Empty) {
+  EXPECT_THAT(ExtractVerilogSymbols("empty.sv", ""), IsEmpty());
+}
+
+TEST(ExtractVerilogSymbolsTest, Definitions) {
+  const auto symbols = ExtractVerilogSymbols("defs.sv",
+                                             "package p;\n"
+                                             "endpackage\n"
+                                             "interface i;\n"
+                                             "endinterface\n"
+                                             "module m;\n"
+                                             "endmodule\n"
+                                             "class c;\n"
+                                             "endclass\n");
+  EXPECT_THAT(
+      symbols,
+      ElementsAre(Symbol("p", IndexedSymbolKind::kPackage, true, 1, 9),
+                  Symbol("i", IndexedSymbolKind::kInterface, true, 3, 11),
+                  Symbol("m", IndexedSymbolKind::kModule, true, 5, 8),
+                  Symbol("c", IndexedSymbolKind::kClass, true, 7, 7)));
+}
+
+TEST(ExtractVerilogSymbolsTest, References) {
+  const auto symbols = ExtractVerilogSymbols("refs.sv",
+                                             "module top;\n"
+                                             "  import pkg::*;\n"
+                                             "  sub u_sub(.a(b));\n"
+                                             "endmodule\n"
+                                             "class d extends base;\n"
+                                             "endclass\n");
+  EXPECT_THAT(
+      symbols,
+      ElementsAre(Symbol("top", IndexedSymbolKind::kModule, true, 1, 8),
+                  Symbol("pkg", IndexedSymbolKind::kPackage, false, 2, 10),
+                  Symbol("sub", IndexedSymbolKind::kModule, false, 3, 3),
+                  Symbol("d", IndexedSymbolKind::kClass, true, 5, 7),
+                  Symbol("base", IndexedSymbolKind::kClass, false, 5, 17)));
+}
+
+}  // namespace
+}  // namespace verilog
@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/strip.h"
 #include "common/strings/comment_utils.h"
@@ -103,5 +105,34 @@ ByteOffsetSet EnabledLinesToDisabledByteRanges(
   return byte_offsets;
 }
 
+bool ParseInclusiveLineRanges(absl::string_view text, LineNumberSet* lines,
+                              std::string* error) {
+  for (const absl::string_view range :
+       absl::StrSplit(text, ',', absl::SkipWhitespace())) {
+    const std::pair<absl::string_view, absl::string_view> bounds =
+        absl::StrSplit(range, absl::MaxSplits('-', 1));
+    int first, last;
+    if (!absl::SimpleAtoi(bounds.first, &first)) {
+      *error = absl::StrCat("Expected a line number, but got \"", range, "\"");
+      return false;
+    }
+    if (bounds.second.empty() && !absl::EndsWith(range, "-")) {
+      last = first;  // "N" is short for "N-N"
+    } else if (!absl::SimpleAtoi(bounds.second, &last)) {
+      *error = absl::StrCat("Expected a line range N-M, but got \"", range,
+                            "\"");
+      return false;
+    }
+    if (first < 1 || last < first) {
+      *error = absl::StrCat("Invalid line range \"", range,
+                            "\": lines are 1-based, and N-M requires N <= M.");
+      return false;
+    }
+    // Convert inclusive range to half-open interval.
+    lines->Add({first, last + 1});
+  }
+  return true;
+}
+
 }  // namespace formatter
 }  // namespace verilog
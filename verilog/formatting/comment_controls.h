@@ -15,6 +15,8 @@
 #ifndef VERIBLE_VERILOG_FORMATTING_COMMENT_CONTROLS_H_
 #define VERIBLE_VERILOG_FORMATTING_COMMENT_CONTROLS_H_
 
+#include <string>
+
 #include "absl/strings/string_view.h"
 #include "common/text/line_column_map.h"
 #include "common/text/token_stream_view.h"
@@ -39,6 +41,12 @@ ByteOffsetSet EnabledLinesToDisabledByteRanges(
     const LineNumberSet& line_numbers,
     const verible::LineColumnMap& line_column_map);
 
+// Parses a comma-separated list of 1-based, inclusive line ranges, like
+// "1-5,8,10-12" (where "N" is short for "N-N"), and adds them to 'lines'.
+// Returns false and sets 'error' if the text is malformed.
+bool ParseInclusiveLineRanges(absl::string_view text, LineNumberSet* lines,
+                              std::string* error);
+
 }  // namespace formatter
 }  // namespace verilog
 
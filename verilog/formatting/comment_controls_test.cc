@@ -311,6 +311,37 @@ TEST(EnabledLinesToDisabledByteRangesTest, AllCases) {
   }
 }
 
+TEST(ParseInclusiveLineRangesTest, Valid) {
+  const std::initializer_list<std::pair<absl::string_view, LineNumberSet>>
+      kTestCases = {
+          {"", {}},
+          {"1", {{1, 2}}},
+          {"3-5", {{3, 6}}},
+          {"3-3", {{3, 4}}},
+          {"1,3", {{1, 2}, {3, 4}}},
+          {"1,2", {{1, 3}}},  // abutting ranges are fused
+          {"10-12,2-4", {{2, 5}, {10, 13}}},
+          {"2-8,4-5", {{2, 9}}},  // overlapping
+      };
+  for (const auto& test : kTestCases) {
+    LineNumberSet lines;
+    std::string error;
+    EXPECT_TRUE(ParseInclusiveLineRanges(test.first, &lines, &error))
+        << test.first << ": " << error;
+    EXPECT_EQ(lines, test.second) << test.first;
+  }
+}
+
+TEST(ParseInclusiveLineRangesTest, Invalid) {
+  for (const absl::string_view text :
+       {"x", "1-", "-2", "0", "0-3", "5-4", "1-2-3", "1,,a", "1:3"}) {
+    LineNumberSet lines;
+    std::string error;
+    EXPECT_FALSE(ParseInclusiveLineRanges(text, &lines, &error)) << text;
+    EXPECT_FALSE(error.empty()) << text;
+  }
+}
+
 }  // namespace
 }  // namespace formatter
 }  // namespace verilog
@@ -20,6 +20,8 @@
 #include <iterator>
 #include <vector>
 
+#include "absl/strings/ascii.h"
+#include "common/formatting/flat_line_wrapper.h"
 #include "common/formatting/format_token.h"
 #include "common/formatting/line_wrap_searcher.h"
 #include "common/formatting/token_partition_tree.h"
@@ -31,9 +33,11 @@
 #include "common/util/expandable_tree_view.h"
 #include "common/util/iterator_range.h"
 #include "common/util/logging.h"
+#include "common/util/memory_usage.h"
 #include "common/util/spacer.h"
 #include "common/util/status.h"
 #include "common/util/vector_tree.h"
+#include "verilog/analysis/analysis_stats.h"
 #include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/formatting/comment_controls.h"
 #include "verilog/formatting/format_style.h"
@@ -62,13 +66,13 @@ class Formatter {
             const FormatStyle& style)
       : text_structure_(text_structure), style_(style) {}
 
-  // Formats the source code
-  Status Format(const ExecutionControl&);
+  // Formats the source code, restricted to the given lines (if non-empty).
+  Status Format(const ExecutionControl&, const LineNumberSet& lines);
 
-  Status Format() { return Format(ExecutionControl()); }
+  Status Format() { return Format(ExecutionControl(), LineNumberSet()); }
 
-  // Outputs all of the FormattedExcerpt lines to stream.
-  void Emit(std::ostream& stream) const;
+  // Appends all of the FormattedExcerpt lines to 'output'.
+  void Emit(std::string* output) const;
 
  private:
   absl::string_view TrailingWhiteSpaces() const;
@@ -82,7 +86,8 @@ class Formatter {
   // The style configuration for the formatter
   FormatStyle style_;
 
-  // Ranges of text where formatter is disabled (by comment directives).
+  // Ranges of text where formatter is disabled (by comment directives,
+  // or because those lines were not selected for formatting).
   ByteOffsetSet disabled_ranges_;
 
   // Set of formatted lines, populated by calling Format().
@@ -139,8 +144,29 @@ Status VerifyFormatting(const verible::TextStructureView& text_structure,
 
 Status FormatVerilog(absl::string_view text, absl::string_view filename,
                      const FormatStyle& style, std::ostream& formatted_stream,
-                     const ExecutionControl& control) {
-  const auto analyzer = VerilogAnalyzer::AnalyzeAutomaticMode(text, filename);
+                     const ExecutionControl& control,
+                     const LineNumberSet& lines) {
+  std::string formatted_text;
+  const Status format_status =
+      FormatVerilog(text, filename, style, &formatted_text, control, lines);
+  // Only commit verified formatted text to the output stream.
+  if (format_status.ok() ||
+      format_status.code() == StatusCode::kResourceExhausted) {
+    formatted_stream << formatted_text;
+  }
+  return format_status;
+}
+
+Status FormatVerilog(absl::string_view text, absl::string_view filename,
+                     const FormatStyle& style, std::string* formatted_text,
+                     const ExecutionControl& control,
+                     const LineNumberSet& lines) {
+  formatted_text->clear();
+  const size_t resident_bytes_before_analysis =
+      control.stats != nullptr ? verible::CurrentResidentMemoryBytes() : 0;
+  const auto analyzer =
+      VerilogAnalyzer::AnalyzeAutomaticMode(text, filename, 1, control.budget);
+  if (control.BudgetExhausted()) return control.budget->status();
   {
     // Lex and parse code.  Exit on failure.
     const auto lex_status = ABSL_DIE_IF_NULL(analyzer)->LexStatus();
@@ -157,11 +183,25 @@ Status FormatVerilog(absl::string_view text, absl::string_view filename,
     }
   }
 
+  if (control.stats != nullptr) {
+    control.stats->analysis = ComputeAnalysisStats(*analyzer);
+    control.stats->analysis.RecordMemoryGrowth(
+        "analysis", resident_bytes_before_analysis);
+  }
+
   const verible::TextStructureView& text_structure = analyzer->Data();
   Formatter fmt(text_structure, style);
 
   // Format code.
-  const Status format_status = fmt.Format(control);
+  const size_t resident_bytes_before_formatting =
+      control.stats != nullptr ? verible::CurrentResidentMemoryBytes() : 0;
+  const Status format_status = fmt.Format(control, lines);
+  if (control.stats != nullptr) {
+    control.stats->analysis.RecordMemoryGrowth(
+        "formatting", resident_bytes_before_formatting);
+  }
+  // Partial results of running out of budget are not worth emitting.
+  if (control.BudgetExhausted()) return control.budget->status();
   if (!format_status.ok()) {
     if (format_status.code() != StatusCode::kResourceExhausted) {
       // Some more fatal error, halt immediately.
@@ -176,27 +216,65 @@ Status FormatVerilog(absl::string_view text, absl::string_view filename,
     return Status(StatusCode::kCancelled, "Halting for diagnostic operation.");
   }
 
-  // Render formatted text to a temporary buffer, so that it can be verified.
-  std::ostringstream output_buffer;
-  fmt.Emit(output_buffer);
-  const std::string& formatted_text(output_buffer.str());
+  // Render formatted text once into the output buffer, so that it can be
+  // verified without further copies.  Formatted output is usually close in
+  // size to the original text.
+  formatted_text->reserve(text.size() + text.size() / 8);
+  fmt.Emit(formatted_text);
 
   // For now, unconditionally verify.
   const Status verify_status =
-      VerifyFormatting(text_structure, formatted_text, filename);
+      VerifyFormatting(text_structure, *formatted_text, filename);
   if (!verify_status.ok()) {
     return verify_status;
   }
 
-  // Commit verified formatted text to the output stream.
-  formatted_stream << formatted_text;
   return format_status;
 }
 
+// Returns true if every token in the partition is marked to preserve its
+// original spacing, e.g. because formatting is disabled over its range.
+static bool AllTokensPreserveSpaces(const UnwrappedLine& uwline) {
+  const auto range = uwline.TokensRange();
+  return !range.empty() &&
+         std::all_of(range.begin(), range.end(),
+                     [](const verible::PreFormatToken& ftoken) {
+                       return ftoken.before.break_decision ==
+                              verible::SpacingOptions::Preserve;
+                     });
+}
+
+// Measures the tokens of a partition as a single line.
+// 'subtree_widths' holds the measurements of the subtrees visited so far that
+// have not yet been combined into their parents' measurements.  Visiting the
+// tree in post-order, the children of 'node' are at the back of this stack,
+// and are replaced by the measurement of 'node'.
+// Thus every token is measured only once for the whole tree.
+static const verible::SingleLineWidth& MeasurePartition(
+    const partition_node_type& node,
+    std::vector<verible::SingleLineWidth>* subtree_widths) {
+  const size_t num_children = node.Children().size();
+  if (num_children == 0) {
+    subtree_widths->emplace_back(node.Value().Value());
+    return subtree_widths->back();
+  }
+  // A parent's tokens are the concatenation of its children's tokens.
+  CHECK_GE(subtree_widths->size(), num_children);
+  const auto first_child = subtree_widths->end() - num_children;
+  for (auto iter = first_child + 1; iter != subtree_widths->end(); ++iter) {
+    first_child->Append(*iter);
+  }
+  subtree_widths->erase(first_child + 1, subtree_widths->end());
+  return subtree_widths->back();
+}
+
 // Decided at each node in UnwrappedLine partition tree whether or not
 // it should be expanded or unexpanded.
-static void DeterminePartitionExpansion(partition_node_type* node,
-                                        const FormatStyle& style) {
+static void DeterminePartitionExpansion(
+    partition_node_type* node, const FormatStyle& style,
+    std::vector<verible::SingleLineWidth>* subtree_widths) {
+  const verible::SingleLineWidth& width =
+      MeasurePartition(*node, subtree_widths);
   auto& node_view = node->Value();
   const auto& children = node->Children();
 
@@ -222,6 +300,14 @@ static void DeterminePartitionExpansion(partition_node_type* node,
 
   // Expand or not, depending on partition policy and other conditions.
   const auto& uwline = node_view.Value();
+
+  // Partitions where formatting is entirely disabled are rendered with their
+  // original spacing, so there is no need to measure them.
+  if (AllTokensPreserveSpaces(uwline)) {
+    VLOG(3) << "Formatting disabled, un-expanding.";
+    node_view.Unexpand();
+    return;
+  }
   const auto partition_policy = uwline.PartitionPolicy();
   VLOG(3) << "partition policy: " << partition_policy;
   switch (partition_policy) {
@@ -230,7 +316,7 @@ static void DeterminePartitionExpansion(partition_node_type* node,
       break;
     }
     case PartitionPolicyEnum::kFitOnLineElseExpand: {
-      if (verible::FitsOnLine(uwline, style)) {
+      if (width.Fits(uwline, style)) {
         VLOG(3) << "Fits, un-expanding.";
         node_view.Unexpand();
       } else {
@@ -252,9 +338,10 @@ static std::vector<UnwrappedLine> MakeUnwrappedLinesWorklist(
   // For unwrapped lines that fit, don't bother expanding their partitions.
   // Post-order traversal: if a child doesn't 'fit' and needs to be expanded,
   // so must all of its parents (and transitively, ancestors).
+  std::vector<verible::SingleLineWidth> subtree_widths;
   format_tokens_partition_view.ApplyPostOrder(
-      [&style](partition_node_type& node) {
-        DeterminePartitionExpansion(&node, style);
+      [&style, &subtree_widths](partition_node_type& node) {
+        DeterminePartitionExpansion(&node, style, &subtree_widths);
       });
 
   // Remove trailing blank lines.
@@ -291,6 +378,18 @@ std::ostream& ExecutionControl::Stream() const {
   return (stream != nullptr) ? *stream : std::cout;
 }
 
+std::ostream& operator<<(std::ostream& stream, const FormatStats& stats) {
+  return stream << stats.analysis << "partitions: " << stats.partitions
+                << "\nflat_partitions: " << stats.flat_partitions
+                << "\nsearched_partitions: " << stats.searched_partitions
+                << "\ntotal_search_states: " << stats.total_search_states
+                << "\nlargest_search_states: " << stats.largest_search_states
+                << "\nincomplete_searches: " << stats.incomplete_searches
+                << "\ntime_limited_searches: " << stats.time_limited_searches
+                << "\nlargest_optimality_gap: " << stats.largest_optimality_gap
+                << '\n';
+}
+
 static verible::iterator_range<std::vector<verible::PreFormatToken>::iterator>
 FindFormatTokensInByteOffsetRange(
     std::vector<verible::PreFormatToken>::iterator begin,
@@ -334,17 +433,17 @@ static void PreserveSpacesOnDisabledTokenRanges(
       ft.before.break_decision = verible::SpacingOptions::Preserve;
     }
 
-    // kludge: When the disabled range immediately follows a //-style
-    // comment, skip past the trailing '\n' (not included in the comment
-    // token), which will be printed by the Emit() method, and preserve the
-    // whitespaces *beyond* that point up to the start of the following
-    // token's text.  This way, rendering the start of the format-disabled
-    // excerpt won't get redundant '\n's.
-    if (begin_disable != ftokens->begin() && begin_disable != end_disable) {
-      const auto prev_ftoken = std::prev(begin_disable);
-      if (prev_ftoken->token->token_enum == TK_EOL_COMMENT) {
-        // consume the trailing '\n' from the preceding //-comment
-        ++begin_disable->before.preserved_space_start;
+    // kludge: When the disabled range starts after the end of the preceding
+    // token, e.g. past the trailing '\n' of a //-style comment, or at the
+    // start of a line, that '\n' will be printed by the Emit() method, so
+    // only preserve the whitespaces *beyond* that point up to the start of
+    // the following token's text.  This way, rendering the start of the
+    // format-disabled excerpt won't get redundant '\n's.
+    if (begin_disable != end_disable) {
+      const char* range_start = base_text.begin() + range.first;
+      auto& space_start = begin_disable->before.preserved_space_start;
+      if (space_start != nullptr && space_start < range_start) {
+        space_start = range_start;
       }
     }
     // start next iteration search from previous iteration's end
@@ -352,7 +451,38 @@ static void PreserveSpacesOnDisabledTokenRanges(
   }
 }
 
-Status Formatter::Format(const ExecutionControl& control) {
+// Returns the byte ranges of lines that are not selected for formatting.
+// Whitespace that trails each disabled range of lines is left enabled, so
+// that a following (formatted) line starts on a new line, just like after a
+// "verilog_format: on" comment.
+static ByteOffsetSet UnselectedLineRanges(
+    const LineNumberSet& lines, const verible::LineColumnMap& line_column_map,
+    absl::string_view base_text) {
+  const int text_length = base_text.length();
+  ByteOffsetSet unselected_ranges(
+      EnabledLinesToDisabledByteRanges(lines, line_column_map));
+  // The last line is not covered above when it lacks a terminating '\n'.
+  const int end_offset = line_column_map.EndOffset();
+  const int last_line = line_column_map.GetBeginningOfLineOffsets().size();
+  if (!lines.empty() && end_offset < text_length &&
+      !lines.Contains(last_line)) {
+    unselected_ranges.Add({end_offset, text_length});
+  }
+  ByteOffsetSet disabled_ranges;
+  for (const auto& range : unselected_ranges) {
+    int end = range.second;
+    if (end < text_length) {
+      while (end > range.first && absl::ascii_isspace(base_text[end - 1])) {
+        --end;
+      }
+    }
+    if (range.first < end) disabled_ranges.Add({range.first, end});
+  }
+  return disabled_ranges;
+}
+
+Status Formatter::Format(const ExecutionControl& control,
+                         const LineNumberSet& lines) {
   const absl::string_view full_text(text_structure_.Contents());
   const auto& token_stream(text_structure_.TokenStream());
 
@@ -362,6 +492,7 @@ Status Formatter::Format(const ExecutionControl& control) {
   // Partition input token stream into hierarchical set of UnwrappedLines.
   TreeUnwrapper tree_unwrapper(text_structure_, style_,
                                unwrapper_data.preformatted_tokens);
+  tree_unwrapper.SetBudget(control.budget);
 
   const TokenPartitionTree* format_tokens_partitions = nullptr;
   // TODO(fangism): The following block could be parallelized because
@@ -374,13 +505,20 @@ Status Formatter::Format(const ExecutionControl& control) {
                                   unwrapper_data.preformatted_tokens.begin(),
                                   unwrapper_data.preformatted_tokens.end());
 
-    // Determine ranges of disabling the formatter.
+    // Determine ranges of disabling the formatter, from comment controls
+    // and from lines that were not selected for formatting.
+    // Annotation and unwrapping cover the whole file regardless: they give
+    // the selected lines their context, and both are linear passes.  Only
+    // the line-wrap search below is skipped for disabled partitions.
     disabled_ranges_ = DisableFormattingRanges(full_text, token_stream);
+    disabled_ranges_.Union(UnselectedLineRanges(
+        lines, text_structure_.GetLineColumnMap(), full_text));
     PreserveSpacesOnDisabledTokenRanges(&unwrapper_data.preformatted_tokens,
                                         disabled_ranges_, full_text);
 
     // Partition PreFormatTokens into candidate unwrapped lines.
     format_tokens_partitions = tree_unwrapper.Unwrap();
+    if (format_tokens_partitions == nullptr) return control.budget->status();
   }
 
   {
@@ -410,11 +548,48 @@ Status Formatter::Format(const ExecutionControl& control) {
   // to their own 'slots'.
   std::vector<const UnwrappedLine*> partially_formatted_lines;
   formatted_lines_.reserve(unwrapped_lines.size());
+  if (control.stats != nullptr) {
+    control.stats->partitions = unwrapped_lines.size();
+  }
   for (const auto& uwline : unwrapped_lines) {
+    // Partitions where formatting is entirely disabled keep their original
+    // spacing, so there is nothing to search.
+    if (AllTokensPreserveSpaces(uwline)) {
+      formatted_lines_.emplace_back(uwline);
+      continue;
+    }
+    // Partitions without nested groups are solved directly, unless all
+    // equally good wrappings were requested.
+    if (!control.show_equally_optimal_wrappings &&
+        verible::IsFlatPartition(uwline)) {
+      formatted_lines_.push_back(verible::WrapFlatLine(uwline, style_));
+      if (control.stats != nullptr) ++control.stats->flat_partitions;
+      continue;
+    }
     // TODO(fangism): Use different formatting strategies depending on
     // uwline.PartitionPolicy().
-    const auto optimal_solutions =
-        verible::SearchLineWraps(uwline, style_, control.max_search_states);
+    verible::LineWrapSearchLimits search_limits;
+    search_limits.max_search_states = control.max_search_states;
+    search_limits.time_limit = control.search_time_limit;
+    search_limits.budget = control.budget;
+    verible::LineWrapSearchStats search_stats;
+    const auto optimal_solutions = verible::SearchLineWraps(
+        uwline, style_, search_limits, &search_stats);
+    const bool time_limited = search_stats.outcome ==
+                              verible::LineWrapSearchStats::Outcome::kTimeLimit;
+    if (control.stats != nullptr) {
+      FormatStats& stats = *control.stats;
+      ++stats.searched_partitions;
+      stats.total_search_states += search_stats.explored_states;
+      stats.largest_search_states = std::max(stats.largest_search_states,
+                                             search_stats.explored_states);
+      if (!optimal_solutions.front().CompletedFormatting()) {
+        ++stats.incomplete_searches;
+        stats.largest_optimality_gap = std::max(
+            stats.largest_optimality_gap, search_stats.OptimalityGap());
+      }
+      if (time_limited) ++stats.time_limited_searches;
+    }
     if (control.show_equally_optimal_wrappings &&
         optimal_solutions.size() > 1) {
       verible::DisplayEquallyOptimalWrappings(control.Stream(), uwline,
@@ -422,12 +597,16 @@ Status Formatter::Format(const ExecutionControl& control) {
     }
     // Arbitrarily choose the first solution, if there are multiple.
     formatted_lines_.push_back(optimal_solutions.front());
-    if (!formatted_lines_.back().CompletedFormatting()) {
+    if (!formatted_lines_.back().CompletedFormatting() && !time_limited) {
       // Copy over any lines that did not finish wrap searching.
+      // Running out of time is expected, and not reported.
       partially_formatted_lines.push_back(&uwline);
     }
   }
 
+  // Searches that ran out of budget are not worth reporting individually.
+  if (control.BudgetExhausted()) return control.budget->status();
+
   // Report any unwrapped lines that failed to complete wrap searching.
   if (!partially_formatted_lines.empty()) {
     std::ostringstream err_stream;
@@ -465,37 +644,62 @@ absl::string_view Formatter::TrailingWhiteSpaces() const {
   }
 }
 
-void Formatter::Emit(std::ostream& stream) const {
+void Formatter::Emit(std::string* output) const {
   const absl::string_view full_text(text_structure_.Contents());
   switch (style_.preserve_vertical_spaces) {
     case PreserveSpaces::None: {
       for (const auto& line : formatted_lines_) {
-        stream << line;
+        line.AppendFormattedText(output);
         // Normally, print a '\n' after this FormattedExcerpt.
         // The exception is when the space that follows the last token
         // on this line is covered by one of the formatting-disabled
         // intervals.  In that case, print the original spacing instead.
         const auto back_offset = line.Tokens().back().token->right(full_text);
-        if (!disabled_ranges_.Contains(back_offset)) stream << '\n';
+        if (!disabled_ranges_.Contains(back_offset)) output->push_back('\n');
       }
       // possibly preserve spaces after the last token
       if (disabled_ranges_.Contains(full_text.length() - 1)) {
-        stream << TrailingWhiteSpaces();
+        const absl::string_view trailing_spaces(TrailingWhiteSpaces());
+        output->append(trailing_spaces.data(), trailing_spaces.size());
       }
       break;
     }
     case PreserveSpaces::All:
     case PreserveSpaces::UnhandledCasesOnly:
       bool is_first_line = true;
+      const char* previous_end = full_text.begin();
       for (const auto& line : formatted_lines_) {
-        line.FormatLinePreserveLeadingNewlines(stream, is_first_line);
+        const auto& tokens = line.Tokens();
+        if (tokens.empty()) continue;
+        const auto& front = tokens.front();
+        if (disabled_ranges_.Contains(front.token->left(full_text))) {
+          // Formatting is disabled here: keep the original indentation
+          // instead of re-indenting.
+          const absl::string_view original_spacing =
+              verible::make_string_view_range(previous_end,
+                                              front.token->text.begin());
+          output->append(verible::FormattedExcerpt::PreservedNewlinesCount(
+                             original_spacing, is_first_line),
+                         '\n');
+          const absl::string_view indentation = original_spacing.substr(
+              original_spacing.find_last_of('\n') + 1);
+          output->append(indentation.data(), indentation.size());
+          output->append(front.token->text.data(), front.token->text.size());
+          for (const auto& ftoken :
+               verible::make_range(tokens.begin() + 1, tokens.end())) {
+            ftoken.AppendFormattedText(output);
+          }
+        } else {
+          line.AppendLinePreserveLeadingNewlines(output, is_first_line);
+        }
+        previous_end = tokens.back().token->text.end();
         is_first_line = false;
       }
       // Handle trailing spaces after last token.
       const size_t newline_count =
           verible::FormattedExcerpt::PreservedNewlinesCount(
               TrailingWhiteSpaces(), is_first_line);
-      stream << verible::Spacer(newline_count, '\n');
+      output->append(newline_count, '\n');
       break;
   }
   // TODO(fangism): This currently doesn't adequately handle anything betweeen
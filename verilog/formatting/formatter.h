@@ -15,16 +15,52 @@
 #ifndef VERIBLE_VERILOG_FORMATTING_FORMATTER_H_
 #define VERIBLE_VERILOG_FORMATTING_FORMATTER_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <string>
 #include <vector>
 
+#include "absl/time/time.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
+#include "verilog/analysis/analysis_stats.h"
 #include "verilog/formatting/comment_controls.h"
 #include "verilog/formatting/format_style.h"
 
 namespace verilog {
 namespace formatter {
 
+// Statistics about one run of the formatter.
+struct FormatStats {
+  // Size and shape of the analyzed input, and the growth of memory during
+  // analysis and during formatting.
+  AnalysisStats analysis;
+
+  // Number of token partitions, how many of them were wrapped by dynamic
+  // programming (see verible::WrapFlatLine()), and how many needed a line-wrap
+  // search (the others had formatting disabled).
+  size_t partitions = 0;
+  size_t flat_partitions = 0;
+  size_t searched_partitions = 0;
+
+  // Number of states explored by all line-wrap searches, and by the largest.
+  int64_t total_search_states = 0;
+  int largest_search_states = 0;
+
+  // Number of searches that stopped before finding an optimal wrapping, and
+  // how many of those ran out of time (see ExecutionControl).
+  size_t incomplete_searches = 0;
+  size_t time_limited_searches = 0;
+
+  // Largest difference, among incomplete searches, between the penalty of the
+  // wrapping used and the proven lower bound on the optimal penalty.
+  int largest_optimality_gap = 0;
+};
+
+// Prints one "name: value" line per statistic.
+std::ostream& operator<<(std::ostream&, const FormatStats&);
+
 // Control over formatter's internal execution phases, mostly for debugging
 // and development.
 struct ExecutionControl {
@@ -43,11 +79,29 @@ struct ExecutionControl {
   // If this limit is exceeded, error out with a diagnostic message.
   int max_search_states = 10000;
 
+  // Limits the wall-clock time of each line-wrap search.  A search that runs
+  // out of time keeps the best wrapping it found so far, which is not an
+  // error, so that the time to format stays predictable.
+  absl::Duration search_time_limit = absl::InfiniteDuration();
+
   // Output stream for diagnostic feedback (not formatting output).
   // This is useful for seeing diagnostics without waiting for a Status
   // to be returned.
   std::ostream* stream = nullptr;
 
+  // If not null, receives statistics about the run.
+  FormatStats* stats = nullptr;
+
+  // If not null, limits the time and memory spent on analysis and
+  // formatting.  Once it is exhausted, formatting stops, and returns the
+  // budget's status without any output.
+  verible::ResourceBudget* budget = nullptr;
+
+  // Returns true if the budget ran out.
+  bool BudgetExhausted() const {
+    return budget != nullptr && !budget->status().ok();
+  }
+
   // Returns *stream or a default stream like std::cout.
   std::ostream& Stream() const;
 
@@ -57,12 +111,27 @@ struct ExecutionControl {
 };
 
 // Formats Verilog/SystemVerilog source code.
-// TODO(b/122330156): specify formatting line ranges
+// 'lines' restricts formatting to the given (1-based) line numbers;
+// the original spacing of all other lines is preserved.  An empty set
+// means format all lines.  Partitions outside of 'lines' skip line-wrap
+// search, but the whole file is still parsed, annotated and partitioned.
 verible::util::Status FormatVerilog(absl::string_view text,
                                     absl::string_view filename,
                                     const FormatStyle& style,
                                     std::ostream& formatted_stream,
-                                    const ExecutionControl& control = {});
+                                    const ExecutionControl& control = {},
+                                    const LineNumberSet& lines = {});
+
+// Same as above, but renders the result directly into 'formatted_text'
+// (replacing its contents), avoiding intermediate stream buffers.
+// On a verification failure (kDataLoss), 'formatted_text' holds the rejected
+// output for diagnostic purposes.
+verible::util::Status FormatVerilog(absl::string_view text,
+                                    absl::string_view filename,
+                                    const FormatStyle& style,
+                                    std::string* formatted_text,
+                                    const ExecutionControl& control = {},
+                                    const LineNumberSet& lines = {});
 
 }  // namespace formatter
 }  // namespace verilog
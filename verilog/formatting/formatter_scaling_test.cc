@@ -0,0 +1,62 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Tests that formatting scales with the size of its input, for synthetic
+// sources that grow in different dimensions.  See
+// verilog/analysis/verilog_scaling_test.cc for the other pipeline stages.
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "common/util/scaling_test_util.h"
+#include "verilog/analysis/synthetic_verilog.h"
+#include "verilog/formatting/format_style.h"
+#include "verilog/formatting/formatter.h"
+
+namespace verilog {
+namespace formatter {
+namespace {
+
+using verible::testing::ExpectGrowthWithin;
+using verible::testing::GeometricScales;
+using verible::testing::kLinearithmicGrowth;
+using verible::testing::MeasureScaling;
+using verible::testing::ScalingWork;
+
+TEST(FormatterScalingTest, SyntheticSources) {
+  const FormatStyle style;
+  for (const auto& shape : SyntheticVerilogShapes()) {
+    const auto samples = MeasureScaling(
+        [&shape, &style](size_t n) {
+          auto text = std::make_shared<std::string>(shape.generate(n));
+          return ScalingWork{text->size(), [text, &style]() {
+                               std::string formatted;
+                               FormatVerilog(*text, "synthetic.sv", style,
+                                             &formatted);
+                             }};
+        },
+        // Fewer repetitions, because formatting takes longer.
+        GeometricScales(shape.base_scale, 2, 4), 2);
+    // Wrapping search is bounded per partition, not constant: allow n log n.
+    ExpectGrowthWithin(absl::StrCat("formatter, ", shape.name), samples,
+                       kLinearithmicGrowth);
+  }
+}
+
+}  // namespace
+}  // namespace formatter
+}  // namespace verilog
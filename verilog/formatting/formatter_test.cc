@@ -24,8 +24,11 @@
 #include "gtest/gtest.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "common/text/text_structure.h"
 #include "common/util/logging.h"
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
 #include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/formatting/format_style.h"
@@ -2689,6 +2692,126 @@ TEST(FormatterEndToEndTest, VerilogFormatTest) {
   }
 }
 
+// Tests that rendering into a string buffer matches the stream interface.
+TEST(FormatterEndToEndTest, VerilogFormatToStringTest) {
+  FormatStyle style;
+  style.column_limit = 40;
+  style.indentation_spaces = 2;
+  style.wrap_spaces = 4;
+  style.over_column_limit_penalty = 50;
+  for (const auto preserve : {PreserveSpaces::None, PreserveSpaces::All}) {
+    style.preserve_vertical_spaces = preserve;
+    for (const auto& test_case : kFormatterTestCases) {
+      std::ostringstream stream;
+      const auto stream_status =
+          FormatVerilog(test_case.input, "<filename>", style, stream);
+      std::string buffer("stale contents");
+      const auto buffer_status =
+          FormatVerilog(test_case.input, "<filename>", style, &buffer);
+      EXPECT_OK(buffer_status) << "code:\n" << test_case.input;
+      EXPECT_EQ(buffer_status.code(), stream_status.code());
+      if (buffer_status.ok()) {
+        EXPECT_EQ(buffer, stream.str()) << "code:\n" << test_case.input;
+      }
+    }
+  }
+}
+
+// Tests that output rejected by verification is kept in the string buffer,
+// but never written to the stream.
+TEST(FormatterEndToEndTest, VerilogFormatToStringDataLoss) {
+  // Binding the unary operators together forms the different token "~&",
+  // so the formatted output is lexically different from the input.
+  // If the formatter learns to keep them apart, find another such input.
+  const absl::string_view code = "module m;\n  assign a = ~ &b;\nendmodule\n";
+  const FormatStyle style;
+  std::ostringstream stream;
+  const auto stream_status = FormatVerilog(code, "<filename>", style, stream);
+  EXPECT_EQ(stream_status.code(), StatusCode::kDataLoss);
+  EXPECT_TRUE(stream.str().empty());
+
+  std::string buffer("stale contents");
+  const auto buffer_status = FormatVerilog(code, "<filename>", style, &buffer);
+  EXPECT_EQ(buffer_status.code(), StatusCode::kDataLoss);
+  EXPECT_NE(buffer.find("~&b"), std::string::npos) << buffer;
+}
+
+struct SelectLinesTestCase {
+  LineNumberSet lines;  // lines to format, empty means all lines
+  absl::string_view input;
+  absl::string_view expected;
+};
+
+// Tests that formatting can be restricted to selected lines.
+TEST(FormatterEndToEndTest, SelectLines) {
+  const std::initializer_list<SelectLinesTestCase> kTestCases = {
+      {{},  // all lines
+       "module   m;\n"
+       "wire   w;\n"
+       "    wire   x;\n"
+       "endmodule\n",
+       "module m;\n"
+       "  wire w;\n"
+       "  wire x;\n"
+       "endmodule\n"},
+      {{{1, 5}},  // all lines
+       "module   m;\n"
+       "wire   w;\n"
+       "    wire   x;\n"
+       "endmodule\n",
+       "module m;\n"
+       "  wire w;\n"
+       "  wire x;\n"
+       "endmodule\n"},
+      {{{2, 3}},  // only line 2
+       "module   m;\n"
+       "wire   w;\n"
+       "    wire   x;\n"
+       "endmodule\n",
+       "module   m;\n"
+       "  wire w;\n"
+       "    wire   x;\n"
+       "endmodule\n"},
+      {{{3, 4}},  // only line 3
+       "module   m;\n"
+       "wire   w;\n"
+       "    wire   x;\n"
+       "endmodule\n",
+       "module   m;\n"
+       "wire   w;\n"
+       "  wire x;\n"
+       "endmodule\n"},
+      {{{1, 2}, {4, 5}},  // lines 1 and 4
+       "module   m;\n"
+       "wire   w;\n"
+       "    wire   x;\n"
+       "endmodule\n",
+       "module m;\n"
+       "wire   w;\n"
+       "    wire   x;\n"
+       "endmodule\n"},
+      {{{1, 2}},  // last line lacks a terminating newline
+       "module   m;\n"
+       "endmodule",
+       "module m;\n"
+       "endmodule"},
+  };
+  FormatStyle style;
+  for (const auto preserve : {PreserveSpaces::None, PreserveSpaces::All}) {
+    style.preserve_vertical_spaces = preserve;
+    for (const auto& test_case : kTestCases) {
+      std::ostringstream stream;
+      const auto status = FormatVerilog(test_case.input, "<filename>", style,
+                                        stream, ExecutionControl(),
+                                        test_case.lines);
+      EXPECT_OK(status);
+      EXPECT_EQ(stream.str(), test_case.expected)
+          << "code:\n"
+          << test_case.input;
+    }
+  }
+}
+
 // These tests verify the mode where horizontal spacing is discarded while
 // vertical spacing is preserved.
 TEST(FormatterEndToEndTest, PreserveVSpacesOnly) {
@@ -3081,6 +3204,99 @@ TEST(FormatterEndToEndTest, UnfinishedLineWrapSearching) {
   EXPECT_TRUE(absl::StartsWith(status.message(), "***"));
 }
 
+TEST(FormatterEndToEndTest, StatsCountIncompleteSearches) {
+  FormatStyle style;
+  style.column_limit = 40;
+  const absl::string_view code("parameter int x = 1+1;\n");
+
+  std::ostringstream stream, debug_stream;
+  FormatStats stats;
+  ExecutionControl control;
+  control.max_search_states = 2;
+  control.stream = &debug_stream;
+  control.stats = &stats;
+  const auto status = FormatVerilog(code, "<filename>", style, stream, control);
+  EXPECT_EQ(status.code(), StatusCode::kResourceExhausted);
+  EXPECT_EQ(stats.incomplete_searches, 1);
+  EXPECT_EQ(stats.largest_search_states, 2);
+}
+
+TEST(FormatterEndToEndTest, CollectsStats) {
+  FormatStyle style;
+  style.column_limit = 40;
+  const absl::string_view code(
+      "module m;\n"
+      "parameter int x = 1+1;\n"
+      "endmodule\n");
+
+  std::ostringstream stream;
+  FormatStats stats;
+  ExecutionControl control;
+  control.stats = &stats;
+  EXPECT_OK(FormatVerilog(code, "<filename>", style, stream, control));
+  EXPECT_EQ(stats.analysis.bytes, code.size());
+  EXPECT_GT(stats.analysis.tree_nodes, 0);
+  EXPECT_GE(stats.partitions, stats.searched_partitions);
+  EXPECT_GT(stats.searched_partitions, 0);
+  EXPECT_GE(stats.total_search_states, stats.largest_search_states);
+  EXPECT_GT(stats.largest_search_states, 0);
+  EXPECT_EQ(stats.incomplete_searches, 0);
+  ASSERT_EQ(stats.analysis.memory_growth_bytes.size(), 2);
+  EXPECT_EQ(stats.analysis.memory_growth_bytes[0].first, "analysis");
+  EXPECT_EQ(stats.analysis.memory_growth_bytes[1].first, "formatting");
+}
+
+TEST(FormatterEndToEndTest, ExhaustedBudgetStopsWithoutOutput) {
+  const absl::string_view code(
+      "module m;\n"
+      "parameter int x = 1+1;\n"
+      "endmodule\n");
+  verible::ResourceBudget budget(absl::Microseconds(1), 0);
+  absl::SleepFor(absl::Milliseconds(1));
+  std::ostringstream stream;
+  ExecutionControl control;
+  control.budget = &budget;
+  const auto status =
+      FormatVerilog(code, "<filename>", FormatStyle(), stream, control);
+  EXPECT_EQ(status.code(), StatusCode::kDeadlineExceeded);
+  EXPECT_TRUE(control.BudgetExhausted());
+  EXPECT_TRUE(stream.str().empty());
+}
+
+TEST(FormatterEndToEndTest, WithinBudget) {
+  const absl::string_view code(
+      "module m;\n"
+      "parameter int x = 1+1;\n"
+      "endmodule\n");
+  verible::ResourceBudget budget(absl::Seconds(60), 0);
+  std::ostringstream stream;
+  ExecutionControl control;
+  control.budget = &budget;
+  EXPECT_OK(FormatVerilog(code, "<filename>", FormatStyle(), stream, control));
+  EXPECT_FALSE(control.BudgetExhausted());
+  EXPECT_FALSE(stream.str().empty());
+}
+
+TEST(FormatterEndToEndTest, SearchTimeLimitIsNotAnError) {
+  const absl::string_view code(
+      "module m;\n"
+      "parameter int x = 1+1;\n"
+      "endmodule\n");
+  std::ostringstream stream;
+  FormatStats stats;
+  ExecutionControl control;
+  control.search_time_limit = absl::Nanoseconds(1);
+  control.stats = &stats;
+  EXPECT_OK(FormatVerilog(code, "<filename>", FormatStyle(), stream, control));
+  // Every line fits, so even the quickest search finds the expected result.
+  EXPECT_EQ(stream.str(),
+            "module m;\n"
+            "  parameter int x = 1 + 1;\n"
+            "endmodule\n");
+  EXPECT_EQ(stats.incomplete_searches, stats.time_limited_searches);
+  EXPECT_GT(stats.time_limited_searches, 0);
+}
+
 // TODO(fangism): directed tests using style variations
 
 }  // namespace
@@ -244,6 +244,14 @@ class LexicalContext {
     }
   }
 
+  // Re-writes the enum of the next token of a stream in-place, for tokens
+  // that arrive one at a time, like TransformVerilogSymbols().
+  // Tokens must remain at the same address for the rest of the stream,
+  // because some are retained as context.
+  void TransformVerilogSymbol(verible::TokenInfo* token) {
+    _AdvanceToken(token);
+  }
+
  protected:  // Allow direct testing of some methods.
   // Reads a single token, and may alter it depending on internal state.
   void _AdvanceToken(verible::TokenInfo*);
@@ -35,7 +35,15 @@ extern int verilog_debug;  // symbol defined in bison-generated verilog.tab.cc
 
 // parser wrapper to enable debug traces
 int verilog_parse_wrapper(::verible::ParserParam* param) {
-  verilog_debug = absl::GetFlag(FLAGS_verilog_trace_parser) ? 1 : 0;
+  // verilog_debug is shared by all parsers, which may run concurrently, so
+  // it is set only once, before the first parse.  (Initialization of a
+  // function-local static is thread-safe.)  Changes of
+  // --verilog_trace_parser after the first parse have no effect.
+  static const bool debug_initialized = []() {
+    verilog_debug = absl::GetFlag(FLAGS_verilog_trace_parser) ? 1 : 0;
+    return true;
+  }();
+  (void)debug_initialized;
   return verilog_parse(param);
 }
 
@@ -0,0 +1,215 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/preprocessor/include_file_cache.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
+#include "common/util/content_cache.h"
+#include "common/util/file_util.h"
+#include "common/util/status.h"
+#include "verilog/parser/verilog_lexer.h"
+#include "verilog/preprocessor/verilog_preprocess.h"
+
+namespace verilog {
+
+// Files may not be nested deeper than this, which also stops cycles that go
+// through different spellings of the same path.
+static constexpr size_t kMaxIncludeDepth = 64;
+
+// Returns a loader like MakeIncludeFileLoader(), for files included by the
+// last file of 'include_stack'.
+static IncludeFileLoader MakeLoader(std::vector<std::string> include_stack,
+                                    std::vector<std::string> include_dirs,
+                                    IncludeFileCache* cache) {
+  return [include_stack, include_dirs, cache](
+             absl::string_view name,
+             std::shared_ptr<const VerilogIncludedFile>* file)
+             -> verible::util::Status {
+    *file = nullptr;
+    if (include_stack.size() > kMaxIncludeDepth) {
+      return verible::util::InvalidArgumentError(absl::StrCat(
+          "`include files nested more than ", kMaxIncludeDepth, " deep"));
+    }
+    std::vector<std::string> candidates;
+    if (absl::StartsWith(name, "/")) {
+      candidates.emplace_back(name);
+    } else {
+      const absl::string_view dir =
+          verible::file::Dirname(include_stack.back());
+      candidates.push_back(dir == "." ? std::string(name)
+                                      : verible::file::JoinPath(dir, name));
+      for (const auto& include_dir : include_dirs) {
+        candidates.push_back(verible::file::JoinPath(include_dir, name));
+      }
+    }
+    for (const auto& path : candidates) {
+      if (std::find(include_stack.begin(), include_stack.end(), path) !=
+          include_stack.end()) {
+        return verible::util::InvalidArgumentError(
+            absl::StrCat("`include cycle through ", path));
+      }
+      const auto status = cache->Load(path, include_dirs, include_stack, file);
+      if (!status.ok() || *file != nullptr) return status;
+    }
+    return verible::util::OkStatus();
+  };
+}
+
+IncludeFileLoader MakeIncludeFileLoader(absl::string_view including_file,
+                                        std::vector<std::string> include_dirs,
+                                        IncludeFileCache* cache) {
+  return MakeLoader({std::string(including_file)}, std::move(include_dirs),
+                    cache);
+}
+
+IncludeFileCache& IncludeFileCache::Global() {
+  static auto* cache = new IncludeFileCache();
+  return *cache;
+}
+
+IncludeFileCache::Stats IncludeFileCache::GetStats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+static int64_t ModificationTimeNs(const struct stat& file_stat) {
+  return static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 +
+         file_stat.st_mtim.tv_nsec;
+}
+
+static std::string Digest(absl::string_view contents) {
+  return verible::ContentHasher().Add(contents).HexDigest();
+}
+
+bool IncludeFileCache::IsUpToDate(const std::vector<Dependency>& dependencies) {
+  for (const auto& dependency : dependencies) {
+    struct stat file_stat;
+    if (stat(dependency.path.c_str(), &file_stat) != 0) return false;
+    if (ModificationTimeNs(file_stat) == dependency.modification_time_ns &&
+        file_stat.st_size == dependency.size) {
+      continue;
+    }
+    // Touched or rewritten files may still have the same contents.
+    std::string contents;
+    if (!verible::file::GetContents(dependency.path, &contents) ||
+        Digest(contents) != dependency.digest) {
+      return false;
+    }
+  }
+  return true;
+}
+
+verible::util::Status IncludeFileCache::Load(
+    const std::string& path, const std::vector<std::string>& include_dirs,
+    const std::vector<std::string>& include_stack,
+    std::shared_ptr<const VerilogIncludedFile>* file) {
+  *file = nullptr;
+  struct stat file_stat;
+  if (stat(path.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+    return verible::util::OkStatus();
+  }
+  std::string key = path;
+  for (const auto& dir : include_dirs) absl::StrAppend(&key, "\n", dir);
+  std::shared_ptr<const LoadedFile> cached;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto found = entries_.find(key);
+    if (found != entries_.end()) cached = found->second;
+  }
+  // Check the files without holding the lock.
+  if (cached != nullptr && IsUpToDate(cached->dependencies)) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++stats_.hits;
+    *file = std::move(cached);
+    return verible::util::OkStatus();
+  }
+
+  // Read, lex and preprocess the file without holding the lock, so that the
+  // files it includes can be loaded too.
+  auto loaded = std::make_shared<LoadedFile>();
+  loaded->path = path;
+  if (!verible::file::GetContents(path, &loaded->contents)) {
+    return verible::util::InvalidArgumentError(
+        absl::StrCat("Cannot read `include file ", path));
+  }
+  VerilogLexer lexer(loaded->contents);
+  verible::TokenSequence& tokens = loaded->tokens;
+  verible::TokenStreamView tokens_view;
+  do {
+    tokens.push_back(lexer.DoNextToken());
+    if (lexer.TokenIsError(tokens.back())) {
+      return verible::util::InvalidArgumentError(absl::StrCat(
+          path, ": lexical error at \"", tokens.back().text, "\""));
+    }
+  } while (!tokens.back().isEOF());
+  for (auto iter = tokens.cbegin(); iter != tokens.cend(); ++iter) {
+    if (VerilogLexer::KeepSyntaxTreeTokens(*iter)) tokens_view.push_back(iter);
+  }
+  std::vector<std::string> nested_stack(include_stack);
+  nested_stack.push_back(path);
+  VerilogPreprocess preprocessor;
+  preprocessor.SetIncludeFileLoader(
+      MakeLoader(std::move(nested_stack), include_dirs, this));
+  loaded->data = preprocessor.ScanStream(tokens_view);
+  if (!loaded->data.errors.empty()) {
+    return verible::util::InvalidArgumentError(
+        absl::StrCat(path, ": ", loaded->data.errors.front().error_message));
+  }
+
+  // 'file_stat' was taken before reading, so any later change of the file
+  // changes its modification time.
+  loaded->dependencies.push_back({path, ModificationTimeNs(file_stat),
+                                  file_stat.st_size,
+                                  Digest(loaded->contents)});
+  loaded->complete = loaded->data.include_warnings.empty();
+  for (const auto& included : loaded->data.included_files) {
+    // Included files were loaded through MakeLoader(), by this cache.
+    const auto& nested = static_cast<const LoadedFile&>(*included);
+    loaded->complete = loaded->complete && nested.complete;
+    for (const auto& dependency : nested.dependencies) {
+      const auto& dependencies = loaded->dependencies;
+      if (std::none_of(dependencies.begin(), dependencies.end(),
+                       [&dependency](const Dependency& known) {
+                         return known.path == dependency.path;
+                       })) {
+        loaded->dependencies.push_back(dependency);
+      }
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  ++stats_.loads;
+  if (loaded->complete) {
+    entries_[key] = loaded;
+  } else {
+    entries_.erase(key);
+  }
+  *file = std::move(loaded);
+  return verible::util::OkStatus();
+}
+
+}  // namespace verilog
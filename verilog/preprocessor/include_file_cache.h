@@ -0,0 +1,120 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// IncludeFileCache shares `include files between all the files that include
+// them.  In a batch run, the same headers (such as uvm_macros.svh, or a
+// project's defines) are included by most files; with the cache, each one is
+// read, lexed and preprocessed only once.
+
+#ifndef VERIBLE_VERILOG_PREPROCESSOR_INCLUDE_FILE_CACHE_H_
+#define VERIBLE_VERILOG_PREPROCESSOR_INCLUDE_FILE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "common/util/status.h"
+#include "verilog/preprocessor/verilog_preprocess.h"
+
+namespace verilog {
+
+// Thread-safe cache of preprocessed files, by path.  A cached file is used
+// again as long as neither it nor any file that it includes has changed.
+// Files whose preprocessing hit an include problem (see
+// VerilogPreprocessData::include_warnings) are not cached, because the
+// result may depend on the include stack, or on files that could not be
+// read.
+class IncludeFileCache {
+ public:
+  IncludeFileCache() = default;
+
+  IncludeFileCache(const IncludeFileCache&) = delete;
+  IncludeFileCache& operator=(const IncludeFileCache&) = delete;
+
+  // The cache shared by the whole process.
+  static IncludeFileCache& Global();
+
+  struct Stats {
+    // Number of files that were read and preprocessed.
+    size_t loads = 0;
+
+    // Number of requests served from the cache.
+    size_t hits = 0;
+  };
+
+  Stats GetStats() const;
+
+  // Sets '*file' to the preprocessed file at 'path', in which `include
+  // directives are resolved with 'include_dirs'.  Sets '*file' to nullptr if
+  // 'path' is not a regular file.  'include_stack' lists the files that are
+  // being included, outermost first, to diagnose cycles.
+  // Concurrent misses on the same file may each preprocess it; the file that
+  // is cached last wins.  Every file loaded by this cache, including those
+  // in the 'included_files' of a loaded file, is a LoadedFile.
+  verible::util::Status Load(const std::string& path,
+                             const std::vector<std::string>& include_dirs,
+                             const std::vector<std::string>& include_stack,
+                             std::shared_ptr<const VerilogIncludedFile>* file);
+
+ private:
+  // A file that a preprocessed result was read from.
+  struct Dependency {
+    std::string path;
+
+    // Status of the file before it was read.  If it is unchanged, so are
+    // the contents; otherwise the contents are compared by 'digest'.
+    int64_t modification_time_ns;
+    int64_t size;
+
+    // ContentHasher digest of the contents that were read.
+    std::string digest;
+  };
+
+  struct LoadedFile : public VerilogIncludedFile {
+    // This file, and all files that it includes, directly or indirectly.
+    std::vector<Dependency> dependencies;
+
+    // False if this file or any file that it includes has include_warnings.
+    bool complete = true;
+  };
+
+  // Returns true if all 'dependencies' still have the contents that were
+  // read.
+  static bool IsUpToDate(const std::vector<Dependency>& dependencies);
+
+  // Guards all fields below.
+  mutable std::mutex mutex_;
+
+  // Keyed by path and include directories, which may change how the file is
+  // preprocessed.
+  std::map<std::string, std::shared_ptr<const LoadedFile>> entries_;
+
+  Stats stats_;
+};
+
+// Returns a loader for VerilogPreprocess::SetIncludeFileLoader(), that looks
+// for included files in the directory of 'including_file', and then in each
+// of 'include_dirs', in order.  Files are loaded through 'cache'.
+IncludeFileLoader MakeIncludeFileLoader(absl::string_view including_file,
+                                        std::vector<std::string> include_dirs,
+                                        IncludeFileCache* cache);
+
+}  // namespace verilog
+
+#endif  // VERIBLE_VERILOG_PREPROCESSOR_INCLUDE_FILE_CACHE_H_
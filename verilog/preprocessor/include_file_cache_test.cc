@@ -0,0 +1,204 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verilog/preprocessor/include_file_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "common/util/file_util.h"
+#include "common/util/status.h"
+#include "verilog/preprocessor/verilog_preprocess.h"
+
+namespace verilog {
+namespace {
+
+namespace file = verible::file;
+
+// Returns a fresh directory for the files of one test.
+std::string TestDir(absl::string_view name) {
+  const std::string dir = file::JoinPath(testing::TempDir(), name);
+  EXPECT_TRUE(file::CreateDir(dir));
+  return dir;
+}
+
+TEST(IncludeFileCacheTest, MissingFile) {
+  const std::string dir = TestDir("include_missing");
+  IncludeFileCache cache;
+  const auto loader =
+      MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> included;
+  EXPECT_TRUE(loader("missing.svh", &included).ok());
+  EXPECT_EQ(included, nullptr);
+  EXPECT_EQ(cache.GetStats().loads, 0);
+}
+
+TEST(IncludeFileCacheTest, NestedIncludes) {
+  const std::string dir = TestDir("include_nested");
+  const std::string include_dir = TestDir("include_nested_dirs");
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "outer.svh"),
+                                "`include \"inner.svh\"\n"
+                                "`define OUTER(x) `INNER + x\n"));
+  ASSERT_TRUE(file::SetContents(file::JoinPath(include_dir, "inner.svh"),
+                                "`define INNER 1\n"));
+  IncludeFileCache cache;
+  const auto loader = MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"),
+                                            {include_dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> included;
+  const auto status = loader("outer.svh", &included);
+  ASSERT_TRUE(status.ok()) << status.message();
+  ASSERT_NE(included, nullptr);
+  EXPECT_EQ(included->path, file::JoinPath(dir, "outer.svh"));
+  const auto& macros = included->data.macro_definitions;
+  EXPECT_EQ(macros.size(), 2);
+  EXPECT_NE(macros.find("OUTER"), macros.end());
+  EXPECT_NE(macros.find("INNER"), macros.end());
+  ASSERT_EQ(included->data.included_files.size(), 1);
+  EXPECT_EQ(included->data.included_files.front()->path,
+            file::JoinPath(include_dir, "inner.svh"));
+  EXPECT_EQ(cache.GetStats().loads, 2);
+}
+
+TEST(IncludeFileCacheTest, SharedBetweenIncluders) {
+  const std::string dir = TestDir("include_shared");
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "defs.svh"),
+                                "`define WIDTH 8\n"));
+  IncludeFileCache cache;
+  const auto loader_a =
+      MakeIncludeFileLoader(file::JoinPath(dir, "a.sv"), {dir}, &cache);
+  const auto loader_b =
+      MakeIncludeFileLoader(file::JoinPath(dir, "b.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> first, second;
+  ASSERT_TRUE(loader_a("defs.svh", &first).ok());
+  ASSERT_TRUE(loader_b("defs.svh", &second).ok());
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(cache.GetStats().loads, 1);
+  EXPECT_EQ(cache.GetStats().hits, 1);
+}
+
+TEST(IncludeFileCacheTest, ReloadsChangedFile) {
+  const std::string dir = TestDir("include_changed");
+  const std::string path = file::JoinPath(dir, "defs.svh");
+  ASSERT_TRUE(file::SetContents(path, "`define A 1\n"));
+  IncludeFileCache cache;
+  const auto loader =
+      MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> before, after;
+  ASSERT_TRUE(loader("defs.svh", &before).ok());
+  ASSERT_TRUE(file::SetContents(path, "`define A 1\n`define B 2\n"));
+  ASSERT_TRUE(loader("defs.svh", &after).ok());
+  ASSERT_NE(after, nullptr);
+  EXPECT_NE(before, after);
+  EXPECT_EQ(after->data.macro_definitions.size(), 2);
+  // The previous version remains valid for its holders.
+  EXPECT_EQ(before->data.macro_definitions.size(), 1);
+  EXPECT_EQ(cache.GetStats().loads, 2);
+}
+
+TEST(IncludeFileCacheTest, ReloadsWhenNestedFileChanges) {
+  const std::string dir = TestDir("include_nested_changed");
+  const std::string inner = file::JoinPath(dir, "inner.svh");
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "outer.svh"),
+                                "`include \"inner.svh\"\n"));
+  ASSERT_TRUE(file::SetContents(inner, "`define A 1\n"));
+  IncludeFileCache cache;
+  const auto loader =
+      MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> before, after;
+  ASSERT_TRUE(loader("outer.svh", &before).ok());
+  // Same size, and most likely within the same second.
+  ASSERT_TRUE(file::SetContents(inner, "`define B 1\n"));
+  ASSERT_TRUE(loader("outer.svh", &after).ok());
+  ASSERT_NE(after, nullptr);
+  EXPECT_NE(before, after);
+  const auto& macros = after->data.macro_definitions;
+  EXPECT_EQ(macros.find("A"), macros.end());
+  EXPECT_NE(macros.find("B"), macros.end());
+  EXPECT_EQ(cache.GetStats().loads, 4);
+}
+
+TEST(IncludeFileCacheTest, UnchangedContentsAreReused) {
+  const std::string dir = TestDir("include_touched");
+  const std::string path = file::JoinPath(dir, "defs.svh");
+  ASSERT_TRUE(file::SetContents(path, "`define A 1\n"));
+  IncludeFileCache cache;
+  const auto loader =
+      MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> before, after;
+  ASSERT_TRUE(loader("defs.svh", &before).ok());
+  // Rewriting the same contents changes the modification time only.
+  ASSERT_TRUE(file::SetContents(path, "`define A 1\n"));
+  ASSERT_TRUE(loader("defs.svh", &after).ok());
+  EXPECT_EQ(before, after);
+  EXPECT_EQ(cache.GetStats().loads, 1);
+  EXPECT_EQ(cache.GetStats().hits, 1);
+}
+
+TEST(IncludeFileCacheTest, Cycle) {
+  const std::string dir = TestDir("include_cycle");
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "a.svh"),
+                                "`include \"b.svh\"\n"));
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "b.svh"),
+                                "`include \"a.svh\"\n"));
+  IncludeFileCache cache;
+  const auto loader =
+      MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> included;
+  const auto status = loader("a.svh", &included);
+  // The cycle is cut off with a warning in the innermost file.
+  ASSERT_TRUE(status.ok()) << status.message();
+  ASSERT_NE(included, nullptr);
+  EXPECT_TRUE(included->data.include_warnings.empty());
+  ASSERT_EQ(included->data.included_files.size(), 1);
+  const auto& warnings =
+      included->data.included_files.front()->data.include_warnings;
+  ASSERT_EQ(warnings.size(), 1);
+  EXPECT_THAT(warnings.front().error_message,
+              testing::HasSubstr("`include cycle"));
+
+  // Results that were cut short depend on the include stack, so they are not
+  // reused.
+  const size_t loads = cache.GetStats().loads;
+  ASSERT_TRUE(loader("a.svh", &included).ok());
+  EXPECT_EQ(cache.GetStats().loads, loads + 2);
+  EXPECT_EQ(cache.GetStats().hits, 0);
+}
+
+TEST(IncludeFileCacheTest, BrokenIncludeIsAWarning) {
+  const std::string dir = TestDir("include_broken");
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "defs.svh"),
+                                "`define A 1\n"
+                                "`include \"bad.svh\"\n"
+                                "`define B 2\n"));
+  ASSERT_TRUE(file::SetContents(file::JoinPath(dir, "bad.svh"), "1class\n"));
+  IncludeFileCache cache;
+  const auto loader =
+      MakeIncludeFileLoader(file::JoinPath(dir, "top.sv"), {dir}, &cache);
+  std::shared_ptr<const VerilogIncludedFile> included;
+  const auto status = loader("defs.svh", &included);
+  ASSERT_TRUE(status.ok()) << status.message();
+  ASSERT_NE(included, nullptr);
+  EXPECT_EQ(included->data.macro_definitions.size(), 2);
+  EXPECT_TRUE(included->data.included_files.empty());
+  ASSERT_EQ(included->data.include_warnings.size(), 1);
+  EXPECT_EQ(included->data.include_warnings.front().token_info.text,
+            "\"bad.svh\"");
+}
+
+}  // namespace
+}  // namespace verilog
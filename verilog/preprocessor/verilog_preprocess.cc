@@ -17,20 +17,24 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 #include "common/lexer/token_generator.h"
 #include "common/lexer/token_stream_adapter.h"
 #include "common/text/macro_definition.h"
+#include "common/text/macro_expander.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
 #include "common/util/container_util.h"
 #include "common/util/logging.h"
 #include "common/util/status.h"
+#include "verilog/parser/verilog_lexer.h"
 #include "verilog/parser/verilog_parser.h"  // for verilog_symbol_name()
 #include "verilog/parser/verilog_token_enum.h"
 
@@ -39,6 +43,7 @@ namespace verilog {
 using verible::TokenGenerator;
 using verible::TokenInfo;
 using verible::TokenStreamView;
+using verible::container::FindOrNull;
 using verible::container::InsertOrUpdate;
 
 bool IsPreprocessorControlToken(const TokenInfo& token) {
@@ -67,31 +72,31 @@ std::unique_ptr<VerilogPreprocessError>
 VerilogPreprocess::ConsumeMacroDefinition(
     const StreamIteratorGenerator& generator, TokenStreamView* define_tokens) {
   // Next token to expect is macro definition name.
-  TokenStreamView::const_iterator token_iter = generator();
-  if ((*token_iter)->isEOF()) {
+  verible::TokenSequence::const_iterator token_iter = generator();
+  if (token_iter->isEOF()) {
     return absl::make_unique<VerilogPreprocessError>(
-        **token_iter, "unexpected EOF where expecting macro definition name");
+        *token_iter, "unexpected EOF where expecting macro definition name");
   }
-  const auto macro_name = *token_iter;
+  const auto macro_name = token_iter;
   if (macro_name->token_enum != PP_Identifier) {
     return absl::make_unique<VerilogPreprocessError>(
-        **token_iter,
+        *token_iter,
         absl::StrCat("Expected identifier for macro name, but got \"",
                      macro_name->text, "...\""));
   }
-  define_tokens->push_back(*token_iter);
+  define_tokens->push_back(token_iter);
 
   // Everything else covers macro parameters and the definition body.
   do {
     token_iter = generator();
-    if ((*token_iter)->isEOF()) {
+    if (token_iter->isEOF()) {
       // Diagnose unexpected EOF downstream instead of erroring here.
       // Other subroutines can give better context about the parsing state.
-      define_tokens->push_back(*token_iter);
+      define_tokens->push_back(token_iter);
       return nullptr;
     }
-    define_tokens->push_back(*token_iter);
-  } while ((*token_iter)->token_enum != PP_define_body);
+    define_tokens->push_back(token_iter);
+  } while (token_iter->token_enum != PP_define_body);
   return nullptr;
 }
 
@@ -197,18 +202,43 @@ std::unique_ptr<VerilogPreprocessError> VerilogPreprocess::ParseMacroDefinition(
 // Interprets preprocessor tokens as directives that act on this preprocessor
 // object and possibly transform the input token stream.
 verible::util::Status VerilogPreprocess::HandleTokenIterator(
-    const TokenStreamView::const_iterator iter,
+    const verible::TokenSequence::const_iterator iter,
     const StreamIteratorGenerator& generator) {
+  if (evaluate_conditionals_) {
+    switch (iter->token_enum) {
+      case PP_ifdef:
+      case PP_ifndef:
+      case PP_elsif:
+      case PP_else:
+      case PP_endif:
+        return HandleConditional(iter, generator);
+      default:
+        break;
+    }
+    if (iter->isEOF() && !conditionals_.empty()) {
+      preprocess_data_.errors.emplace_back(*iter,
+                                           "missing `endif at end of file");
+      return verible::util::InvalidArgumentError("Unterminated conditional.");
+    }
+    // Tokens of branches that are not taken are dropped one by one, even
+    // those that start directives.
+    if (!InTakenBranch()) return verible::util::OkStatus();
+    if (iter->token_enum == PP_undef) return HandleUndef(iter, generator);
+  }
   // For now, pass through all macro definition tokens to next consumer
   // (parser).
-  switch ((*iter)->token_enum) {
+  switch (iter->token_enum) {
     case PP_define:
       return HandleDefine(iter, generator);
+    case PP_include:
+      if (include_file_loader_ == nullptr) break;
+      return HandleInclude(iter, generator);
     default:
-      // All other tokens are passed through unmodified.
-      preprocess_data_.preprocessed_token_stream.push_back(*iter);
-      return verible::util::OkStatus();
+      break;
   }
+  // All other tokens are passed through unmodified.
+  preprocess_data_.preprocessed_token_stream.push_back(iter);
+  return verible::util::OkStatus();
 }
 
 // Stores a macro definition for later use.
@@ -227,10 +257,10 @@ void VerilogPreprocess::RegisterMacroDefinition(
 // Responds to `define directives.  Macro definitions are parsed and saved
 // for use within the same file.
 verible::util::Status VerilogPreprocess::HandleDefine(
-    const TokenStreamView::const_iterator iter,  // points to `define token
+    const verible::TokenSequence::const_iterator iter,  // `define token
     const StreamIteratorGenerator& generator) {
   TokenStreamView define_tokens;
-  define_tokens.push_back(*iter);
+  define_tokens.push_back(iter);
   const auto consume_error_ptr =
       ConsumeMacroDefinition(generator, &define_tokens);
   if (consume_error_ptr) {
@@ -258,22 +288,200 @@ verible::util::Status VerilogPreprocess::HandleDefine(
   return verible::util::OkStatus();
 }
 
+// Lexes macro definition or argument text, without whitespace and comments.
+static verible::util::Status LexMacroText(absl::string_view text,
+                                          verible::TokenSequence* tokens) {
+  VerilogLexer lexer(text);
+  for (;;) {
+    const TokenInfo& token = lexer.DoNextToken();
+    if (token.isEOF()) break;
+    if (lexer.TokenIsError(token)) {
+      return verible::util::InvalidArgumentError(
+          absl::StrCat("Lexical error in macro text: ", token.text));
+    }
+    if (VerilogLexer::KeepSyntaxTreeTokens(token)) tokens->push_back(token);
+  }
+  return verible::util::OkStatus();
+}
+
+verible::MacroExpander::Language VerilogMacroLanguage() {
+  verible::MacroExpander::Language language;
+  language.tokenize = &LexMacroText;
+  language.identifier_enum = SymbolIdentifier;
+  language.macro_reference_enums = {MacroIdentifier, MacroIdItem,
+                                    MacroNumericWidth};
+  language.macro_call_enum = MacroCallId;
+  language.macro_arg_enum = MacroArg;
+  language.call_close_enums = {')', MacroCallCloseToEndLine};
+  language.reference_prefix = "`";
+  return language;
+}
+
+std::unique_ptr<verible::MacroExpander> MakeMacroExpander(
+    const VerilogPreprocessData& data) {
+  const auto* definitions = &data.macro_definitions;
+  return absl::make_unique<verible::MacroExpander>(
+      VerilogMacroLanguage(),
+      [definitions](absl::string_view name) -> const verible::MacroDefinition* {
+        return FindOrNull(*definitions, name);
+      });
+}
+
+// Responds to `include directives by reading the included file, and
+// registering the macros that it defines.  Both the directive and its
+// argument are forwarded, so that the included file's tokens are not mixed
+// with those of this file.
+verible::util::Status VerilogPreprocess::HandleInclude(
+    const verible::TokenSequence::const_iterator iter,  // `include token
+    const StreamIteratorGenerator& generator) {
+  auto& preprocessed = preprocess_data_.preprocessed_token_stream;
+  preprocessed.push_back(iter);
+  const verible::TokenSequence::const_iterator argument = generator();
+  preprocessed.push_back(argument);
+  // Only literal file names can be resolved: `include `MACRO would need the
+  // macro to be expanded first.
+  if (argument->token_enum != TK_StringLiteral) {
+    if (!argument->isEOF()) {
+      preprocess_data_.unresolved_includes.push_back(*argument);
+    }
+    return verible::util::OkStatus();
+  }
+  const absl::string_view name =
+      absl::StripSuffix(absl::StripPrefix(argument->text, "\""), "\"");
+  std::shared_ptr<const VerilogIncludedFile> file;
+  const auto status = include_file_loader_(name, &file);
+  if (!status.ok()) {
+    // A broken header should not fail the analysis of its includers.
+    preprocess_data_.include_warnings.emplace_back(
+        *argument, std::string(status.message()));
+    return verible::util::OkStatus();
+  }
+  if (file == nullptr) {
+    preprocess_data_.unresolved_includes.push_back(*argument);
+    return verible::util::OkStatus();
+  }
+  // Files included more than once define the same macros again, which is
+  // not worth diagnosing.
+  for (const auto& definition : file->data.macro_definitions) {
+    InsertOrUpdate(&preprocess_data_.macro_definitions, definition.first,
+                   definition.second);
+  }
+  preprocess_data_.included_files.push_back(std::move(file));
+  return verible::util::OkStatus();
+}
+
+bool VerilogPreprocess::IsDefined(absl::string_view name) const {
+  return preprocess_data_.macro_definitions.count(name) != 0 ||
+         defines_.count(std::string(name)) != 0;
+}
+
+// Responds to conditional directives by tracking which branches are taken.
+// The directives themselves are not forwarded.
+verible::util::Status VerilogPreprocess::HandleConditional(
+    const verible::TokenSequence::const_iterator iter,  // directive token
+    const StreamIteratorGenerator& generator) {
+  const int directive = iter->token_enum;
+  bool condition = true;  // for `else
+  if (directive == PP_ifdef || directive == PP_ifndef ||
+      directive == PP_elsif) {
+    const verible::TokenSequence::const_iterator name = generator();
+    if (name->token_enum != PP_Identifier) {
+      preprocess_data_.errors.emplace_back(
+          *name, absl::StrCat("expected macro name after ", iter->text));
+      return verible::util::InvalidArgumentError(
+          "Error parsing conditional directive.");
+    }
+    condition = IsDefined(name->text) == (directive != PP_ifndef);
+  }
+  if (directive == PP_ifdef || directive == PP_ifndef) {
+    const bool enclosing_taken = InTakenBranch();
+    conditionals_.push_back(Conditional{enclosing_taken && condition,
+                                        !enclosing_taken || condition, false});
+    return verible::util::OkStatus();
+  }
+  if (conditionals_.empty()) {
+    preprocess_data_.errors.emplace_back(
+        *iter, absl::StrCat(iter->text, " without `ifdef or `ifndef"));
+    return verible::util::InvalidArgumentError(
+        "Error parsing conditional directive.");
+  }
+  Conditional& conditional = conditionals_.back();
+  if (directive == PP_endif) {
+    conditionals_.pop_back();
+    return verible::util::OkStatus();
+  }
+  if (conditional.in_else) {
+    preprocess_data_.errors.emplace_back(
+        *iter, absl::StrCat(iter->text, " after `else"));
+    return verible::util::InvalidArgumentError(
+        "Error parsing conditional directive.");
+  }
+  conditional.active = !conditional.resolved && condition;
+  conditional.resolved = conditional.resolved || condition;
+  conditional.in_else = directive == PP_else;
+  return verible::util::OkStatus();
+}
+
+// Responds to `undef directives by forgetting the macro, which matters only
+// to conditional directives.  Like `define, the directive is forwarded.
+verible::util::Status VerilogPreprocess::HandleUndef(
+    const verible::TokenSequence::const_iterator iter,  // `undef token
+    const StreamIteratorGenerator& generator) {
+  auto& preprocessed = preprocess_data_.preprocessed_token_stream;
+  preprocessed.push_back(iter);
+  const verible::TokenSequence::const_iterator name = generator();
+  if (name->token_enum != PP_Identifier) {
+    preprocess_data_.errors.emplace_back(
+        *name, absl::StrCat("expected macro name after ", iter->text));
+    return verible::util::InvalidArgumentError("Error parsing `undef.");
+  }
+  preprocessed.push_back(name);
+  preprocess_data_.macro_definitions.erase(name->text);
+  defines_.erase(std::string(name->text));
+  return verible::util::OkStatus();
+}
+
 VerilogPreprocessData VerilogPreprocess::ScanStream(
     const TokenStreamView& token_stream) {
   preprocess_data_.preprocessed_token_stream.reserve(token_stream.size());
-  auto iter_generator = verible::MakeConstIteratorStreamer(token_stream);
+  auto iter = token_stream.begin();
   const auto end = token_stream.end();
-  auto iter = iter_generator();
+  // Directives may read past the end of a stream that does not end with EOF,
+  // in which case they see its last token again.
+  const StreamIteratorGenerator generator = [&iter, end]() {
+    return (iter != end) ? *iter++ : *std::prev(end);
+  };
   // Token-pulling loop.
   while (iter != end) {
-    const auto status = HandleTokenIterator(iter, iter_generator);
+    const auto status = ScanNextToken(generator);
     if (!status.ok()) {
       // Detailed errors are already in preprocessor_data_.errors.
       break;  // For now, stop after first error.
     }
-    iter = iter_generator();
   }
   return std::move(preprocess_data_);
 }
 
+std::vector<VerilogPreprocessData> VerilogPreprocess::ScanConfigurations(
+    const TokenStreamView& token_stream,
+    const std::vector<VerilogDefineSet>& configurations,
+    const IncludeFileLoader& include_file_loader) {
+  std::vector<VerilogPreprocessData> results;
+  results.reserve(configurations.size());
+  for (const auto& defines : configurations) {
+    VerilogPreprocess preprocessor;
+    preprocessor.SetDefines(defines);
+    if (include_file_loader != nullptr) {
+      preprocessor.SetIncludeFileLoader(include_file_loader);
+    }
+    results.push_back(preprocessor.ScanStream(token_stream));
+  }
+  return results;
+}
+
+verible::util::Status VerilogPreprocess::ScanNextToken(
+    const StreamIteratorGenerator& generator) {
+  return HandleTokenIterator(generator(), generator);
+}
+
 }  // namespace verilog
@@ -23,10 +23,12 @@
 // branches.
 // Each analysis tool may configure the pseudo-preprocessor differently.
 
-// TODO(fangism): expand macros if locally defined, and feed un-lexed
-//   body text to lexer.  This approach works if the definition text
-//   does not depend on the start-condition state at the macro call site.
-// TODO(fangism): implement conditional evaluation policy (`ifdef, `else, ...)
+// TODO(fangism): substitute expansions of locally defined macros (see
+//   MakeMacroExpander) into the preprocessed stream.  Lexing body text on its
+//   own works if the definition text does not depend on the start-condition
+//   state at the macro call site.
+// TODO(fangism): evaluate conditionals by default, with the macros defined
+//   so far (see SetDefines).
 // TODO(fangism): token concatenation, e.g. a``b
 //   This will produce tokens that are not in the original source text.
 // TODO(fangism): token string-ification (turning symbol names into strings)
@@ -38,11 +40,14 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/string_view.h"
 #include "common/text/macro_definition.h"
+#include "common/text/macro_expander.h"
 #include "common/text/token_info.h"
 #include "common/text/token_stream_view.h"
 #include "common/util/status.h"
@@ -65,6 +70,8 @@ struct VerilogPreprocessError {
       : token_info(token), error_message(message) {}
 };
 
+struct VerilogIncludedFile;
+
 // Information that results from preprocessing.
 struct VerilogPreprocessData {
   using MacroDefinition = verible::MacroDefinition;
@@ -78,8 +85,57 @@ struct VerilogPreprocessData {
 
   // Sequence of tokens rejected by preprocessing.
   std::vector<VerilogPreprocessError> errors;
+
+  // Files read for `include directives, which own the text of the macros
+  // they define.  Macros defined in included files (directly or indirectly)
+  // are in macro_definitions.
+  std::vector<std::shared_ptr<const VerilogIncludedFile>> included_files;
+
+  // Arguments of `include directives whose file was not found.
+  std::vector<verible::TokenInfo> unresolved_includes;
+
+  // Arguments of `include directives whose file was found, but could not be
+  // read or preprocessed, or was nested too deeply.  These do not stop the
+  // preprocessing of the including file.
+  std::vector<VerilogPreprocessError> include_warnings;
+};
+
+// A file read for an `include directive, after preprocessing on its own:
+// macros defined in the including file before the `include are not visible
+// to it, so the same result serves every file that includes it.
+struct VerilogIncludedFile {
+  // Path of the file that was read.
+  std::string path;
+
+  std::string contents;
+
+  // Lexed contents, ending with EOF.
+  verible::TokenSequence tokens;
+
+  // Result of preprocessing 'tokens'.
+  VerilogPreprocessData data;
 };
 
+// Finds and preprocesses the file named by an `include directive (without
+// quotes).  Sets '*file' to nullptr if no such file is found, and returns an
+// error if the file cannot be read or preprocessed.
+using IncludeFileLoader = std::function<verible::util::Status(
+    absl::string_view name, std::shared_ptr<const VerilogIncludedFile>* file)>;
+
+// Names of macros that are defined before a file is preprocessed, like with
+// +define+ on a simulator's command line.  Only whether a name is defined
+// matters, to evaluate `ifdef and related directives.
+using VerilogDefineSet = std::set<std::string>;
+
+// Describes Verilog macro references and calls for verible::MacroExpander.
+// Macro bodies and arguments are lexed by VerilogLexer.
+verible::MacroExpander::Language VerilogMacroLanguage();
+
+// Returns an expander of the macros in 'data' (the last definition of each
+// name).  'data' and the preprocessed text must outlive the expander.
+std::unique_ptr<verible::MacroExpander> MakeMacroExpander(
+    const VerilogPreprocessData& data);
+
 // VerilogPreprocess transforms a TokenStreamView.
 // The input stream view is expected to have been stripped of whitespace.
 class VerilogPreprocess {
@@ -90,22 +146,88 @@ class VerilogPreprocess {
  public:
   VerilogPreprocess() : preprocess_data_() {}
 
+  // Enables `include resolution with 'loader'.  Without a loader, `include
+  // directives are passed through, like all other tokens.
+  void SetIncludeFileLoader(IncludeFileLoader loader) {
+    include_file_loader_ = std::move(loader);
+  }
+
+  // Enables evaluation of conditional directives (`ifdef, `ifndef, `elsif,
+  // `else, `endif), as if the macros in 'defines' were defined before the
+  // file, in addition to those defined (or undefined) by the file itself.
+  // The directives, and the tokens of branches that are not taken, are left
+  // out of the preprocessed stream.  Without this, all tokens of all
+  // branches are passed through.
+  void SetDefines(VerilogDefineSet defines) {
+    defines_ = std::move(defines);
+    evaluate_conditionals_ = true;
+  }
+
   // ScanStream reads in a stream of tokens returns the result as a move
   // of preprocessor_data_.  preprocessor_data_ should not be accessed
   // after this returns.
   VerilogPreprocessData ScanStream(const TokenStreamView& token_stream);
 
-  // TODO(fangism): ExpandMacro, ExpandMacroCall
+  // Preprocesses 'token_stream' once for each define set in
+  // 'configurations' (see SetDefines()), and returns the results in the same
+  // order.  The tokens are lexed only once: every resulting
+  // preprocessed_token_stream is a view of the tokens of 'token_stream'.
+  static std::vector<VerilogPreprocessData> ScanConfigurations(
+      const TokenStreamView& token_stream,
+      const std::vector<VerilogDefineSet>& configurations,
+      const IncludeFileLoader& include_file_loader = nullptr);
 
- private:
+  // Produces the tokens to preprocess, one at a time.  Once the stream ends
+  // with an EOF token, it should keep producing that token.
   using StreamIteratorGenerator =
-      std::function<TokenStreamView::const_iterator()>;
+      std::function<verible::TokenSequence::const_iterator()>;
 
+  // Incremental alternative to ScanStream: preprocesses the next token from
+  // 'generator', consuming further tokens if that token starts a directive
+  // (such as a macro definition).  Resulting tokens are appended to
+  // PreprocessedTokenStream().  Returns an error (with details in the
+  // errors of TakeData()) when the directive is malformed, after which no
+  // more tokens should be scanned.
+  verible::util::Status ScanNextToken(const StreamIteratorGenerator& generator);
+
+  // Tokens preprocessed so far by ScanNextToken().
+  const TokenStreamView& PreprocessedTokenStream() const {
+    return preprocess_data_.preprocessed_token_stream;
+  }
+
+  // Returns the results of ScanNextToken() as a move of preprocess_data_,
+  // like ScanStream.
+  VerilogPreprocessData TakeData() { return std::move(preprocess_data_); }
+
+ private:
   verible::util::Status HandleTokenIterator(
-      const TokenStreamView::const_iterator, const StreamIteratorGenerator&);
+      const verible::TokenSequence::const_iterator,
+      const StreamIteratorGenerator&);
+
+  verible::util::Status HandleDefine(
+      const verible::TokenSequence::const_iterator,
+      const StreamIteratorGenerator&);
+
+  verible::util::Status HandleInclude(
+      const verible::TokenSequence::const_iterator,
+      const StreamIteratorGenerator&);
+
+  verible::util::Status HandleConditional(
+      const verible::TokenSequence::const_iterator,
+      const StreamIteratorGenerator&);
+
+  verible::util::Status HandleUndef(
+      const verible::TokenSequence::const_iterator,
+      const StreamIteratorGenerator&);
 
-  verible::util::Status HandleDefine(const TokenStreamView::const_iterator,
-                                     const StreamIteratorGenerator&);
+  // Returns true if tokens are in a branch that is taken (or outside of any
+  // conditional).
+  bool InTakenBranch() const {
+    return conditionals_.empty() || conditionals_.back().active;
+  }
+
+  // Returns true if 'name' is a defined macro.
+  bool IsDefined(absl::string_view name) const;
 
   // The following functions return nullptr when there is no error:
   static std::unique_ptr<VerilogPreprocessError> ConsumeMacroDefinition(
@@ -121,6 +243,31 @@ class VerilogPreprocess {
 
   // Results of preprocessing
   VerilogPreprocessData preprocess_data_;
+
+  // Resolves `include directives, if set.
+  IncludeFileLoader include_file_loader_;
+
+  // If true, conditional directives are evaluated, see SetDefines().
+  bool evaluate_conditionals_ = false;
+
+  // Macros defined before the file, less those undefined by the file.
+  VerilogDefineSet defines_;
+
+  // State of one `ifdef/`ifndef ... `endif block.
+  struct Conditional {
+    // True while tokens are in the branch that is taken.
+    bool active;
+
+    // True once a branch was taken (or cannot be taken, in a branch of an
+    // enclosing block that is not taken).
+    bool resolved;
+
+    // True after `else.
+    bool in_else;
+  };
+
+  // Conditional blocks that enclose the current token, innermost last.
+  std::vector<Conditional> conditionals_;
 };
 
 }  // namespace verilog
@@ -14,13 +14,16 @@
 
 #include "verilog/preprocessor/verilog_preprocess.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
 #include "common/text/macro_definition.h"
 #include "common/text/token_info.h"
+#include "common/text/token_stream_view.h"
 #include "common/util/container_util.h"
 #include "common/util/status.h"
 #include "verilog/analysis/verilog_analyzer.h"
@@ -28,7 +31,9 @@
 namespace verilog {
 namespace {
 
+using testing::Contains;
 using testing::ElementsAre;
+using testing::Not;
 using testing::Pair;
 using verible::container::FindOrNull;
 
@@ -224,5 +229,146 @@ TEST(VerilogPreprocessTest, TwoMacroDefinitions) {
   }
 }
 
+
+TEST(VerilogPreprocessTest, ExpandMacroCalls) {
+  PreprocessorTester tester(
+      "`define WIDTH 8\n"
+      "`define ADD(a, b=1) (a + b)\n"
+      "module m;\n"
+      "  localparam int P = `ADD(`WIDTH);\n"
+      "  localparam int Q = `ADD(`WIDTH, 1);\n"
+      "  localparam int R = `UNDEFINED;\n"
+      "endmodule\n");
+  ASSERT_TRUE(tester.Status().ok()) << "Unexpected analyzer failure.";
+  const auto expander = MakeMacroExpander(tester.PreprocessorData());
+  verible::TokenSequence expanded;
+  const auto status = expander->ExpandTokens(
+      tester.Analyzer().Data().GetTokenStreamView(), &expanded);
+  ASSERT_TRUE(status.ok()) << status.message();
+
+  // Collect the right-hand sides of the parameter assignments (skipping the
+  // "=" of default macro arguments).
+  std::vector<std::vector<absl::string_view>> values;
+  auto iter = std::find_if(
+      expanded.begin(), expanded.end(),
+      [](const verible::TokenInfo& token) { return token.text == "module"; });
+  for (; iter != expanded.end(); ++iter) {
+    if (iter->token_enum == '=') {
+      values.emplace_back();
+      while (++iter != expanded.end() && iter->token_enum != ';') {
+        values.back().push_back(iter->text);
+      }
+    }
+  }
+  EXPECT_THAT(values,
+              ElementsAre(ElementsAre("(", "8", "+", "1", ")"),
+                          ElementsAre("(", "8", "+", "1", ")"),
+                          ElementsAre("`UNDEFINED")));
+  // The expanded text refers to the original text.
+  const absl::string_view contents = tester.Analyzer().Data().Contents();
+  for (const auto& token : expanded) {
+    EXPECT_TRUE(token.text.begin() >= contents.begin() &&
+                token.text.end() <= contents.end())
+        << token;
+  }
+  // `WIDTH is expanded once, and each `ADD call once.
+  EXPECT_EQ(expander->GetStats().calls, 4);
+  EXPECT_EQ(expander->GetStats().memo_hits, 1);
+}
+
+// Lexes text once, to preprocess it in several configurations.
+class ConfigurationsTester {
+ public:
+  explicit ConfigurationsTester(const char* text)
+      : analyzer_(text, "<<inline-file>>") {
+    EXPECT_TRUE(analyzer_.Tokenize().ok());
+    analyzer_.FilterTokensForSyntaxTree();
+  }
+
+  std::vector<VerilogPreprocessData> Scan(
+      const std::vector<VerilogDefineSet>& configurations) const {
+    return VerilogPreprocess::ScanConfigurations(
+        analyzer_.Data().GetTokenStreamView(), configurations);
+  }
+
+  // Returns the texts of the preprocessed tokens, without EOF.
+  static std::vector<absl::string_view> Texts(
+      const VerilogPreprocessData& data) {
+    std::vector<absl::string_view> texts;
+    for (const auto& token : data.preprocessed_token_stream) {
+      if (!token->isEOF()) texts.push_back(token->text);
+    }
+    return texts;
+  }
+
+ private:
+  VerilogAnalyzer analyzer_;
+};
+
+TEST(VerilogPreprocessTest, EvaluatesConditionalsPerConfiguration) {
+  const ConfigurationsTester tester(
+      "`ifdef A\n"
+      "a\n"
+      "`elsif B\n"
+      "b\n"
+      "`ifndef C\n"
+      "not_c\n"
+      "`endif\n"
+      "`else\n"
+      "neither\n"
+      "`endif\n"
+      "all\n");
+  const auto results = tester.Scan({{}, {"A"}, {"B"}, {"B", "C"}, {"A", "B"}});
+  ASSERT_EQ(results.size(), 5);
+  for (const auto& result : results) EXPECT_TRUE(result.errors.empty());
+  EXPECT_THAT(tester.Texts(results[0]), ElementsAre("neither", "all"));
+  EXPECT_THAT(tester.Texts(results[1]), ElementsAre("a", "all"));
+  EXPECT_THAT(tester.Texts(results[2]), ElementsAre("b", "not_c", "all"));
+  EXPECT_THAT(tester.Texts(results[3]), ElementsAre("b", "all"));
+  EXPECT_THAT(tester.Texts(results[4]), ElementsAre("a", "all"));
+}
+
+TEST(VerilogPreprocessTest, ConditionalsSeeDefinesInFile) {
+  const ConfigurationsTester tester(
+      "`ifdef A\n"
+      "`define B\n"
+      "`undef A\n"
+      "`endif\n"
+      "`ifdef B\n"
+      "b\n"
+      "`endif\n"
+      "`ifdef A\n"
+      "a\n"
+      "`endif\n");
+  const auto results = tester.Scan({{}, {"A"}});
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_TRUE(tester.Texts(results[0]).empty());
+  EXPECT_EQ(results[0].macro_definitions.size(), 0);
+  // `define and `undef are forwarded.
+  const auto texts = tester.Texts(results[1]);
+  EXPECT_THAT(texts, Contains("`define"));
+  EXPECT_THAT(texts, Contains("`undef"));
+  EXPECT_THAT(texts, Contains("b"));
+  EXPECT_THAT(texts, Not(Contains("a")));
+  EXPECT_EQ(results[1].macro_definitions.size(), 1);
+}
+
+TEST(VerilogPreprocessTest, InvalidConditionals) {
+  const char* test_cases[] = {
+      "`else\n",
+      "`endif\n",
+      "`ifdef A\n",
+      "`ifdef A\n`else\n`else\n`endif\n",
+      "`ifdef A\n`else\n`elsif B\n`endif\n",
+  };
+  for (const auto& test_case : test_cases) {
+    const ConfigurationsTester tester(test_case);
+    const auto results = tester.Scan({{}, {"A"}});
+    for (const auto& result : results) {
+      EXPECT_EQ(result.errors.size(), 1) << "on input: " << test_case;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace verilog
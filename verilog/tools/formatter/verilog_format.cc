@@ -13,16 +13,21 @@
 // limitations under the License.
 
 // verilog_format is a command-line utility to format verilog source code
-// for a given file.
+// for given files.
 //
 // Example usage:
 // verilog_format original-file > new-file
+// verilog_format --inplace files...
+// verilog_format --check files...
+// verilog_format --lines=10-20,35 original-file > new-file
+// verilog_format --check --cache_dir=$HOME/.cache/verilog_format files...
 //
 // Exit code:
 //   0: stdout output can be used to replace original file
 //   nonzero: stdout output (if any) should be discarded
+//   With --check: nonzero if any file would be changed by formatting.
 
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <sstream>  // IWYU pragma: keep  // for ostringstream
@@ -30,28 +35,52 @@
 #include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "common/util/content_cache.h"
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
 #include "common/util/logging.h"  // for operator<<, LOG, LogMessage, etc
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
+#include "common/util/thread_pool.h"
+#include "verilog/formatting/comment_controls.h"
 #include "verilog/formatting/format_style.h"
 #include "verilog/formatting/formatter.h"
 
 using verible::util::StatusCode;
 using verilog::formatter::ExecutionControl;
+using verilog::formatter::FormatStats;
 using verilog::formatter::FormatStyle;
 using verilog::formatter::FormatVerilog;
+using verilog::formatter::LineNumberSet;
 using verilog::formatter::PreserveSpaces;
 
 // TODO(fangism): Provide -i alias, as it is canonical to many formatters
 ABSL_FLAG(bool, inplace, false,
           "If true, overwrite the input file on successful conditions.");
+ABSL_FLAG(bool, check, false,
+          "If true, do not write any output, only print the names of files "
+          "whose formatting would change, and exit nonzero if there are any.");
+ABSL_FLAG(int, threads, 0,
+          "Number of files to format concurrently.  "
+          "0 means use all available hardware threads.");
+ABSL_FLAG(std::string, lines, "",
+          "Specific lines to format, 1-based, comma-separated, inclusive N-M "
+          "ranges, N is short for N-N.  By default, all lines are formatted.  "
+          "Only applies to a single file.");
+ABSL_FLAG(std::string, cache_dir, "",
+          "If set, reuse formatting results from this directory, and store "
+          "new results there.  The directory is created if it does not exist, "
+          "and may be shared by concurrent invocations.");
+ABSL_FLAG(int64_t, cache_max_bytes, 256 << 20,
+          "Limits the total size of --cache_dir, by evicting the least "
+          "recently used results.  0 means unlimited.");
 ABSL_FLAG(std::string, stdin_name, "<stdin>",
           "When using '-' to read from stdin, this gives an alternate name for "
           "diagnostic purposes.  Otherwise this is ignored.");
-
 ABSL_FLAG(int, show_largest_token_partitions, 0,
           "If > 0, print token partitioning and then "
           "exit without formatting output.");
@@ -64,6 +93,27 @@ ABSL_FLAG(bool, show_equally_optimal_wrappings, false,
 ABSL_FLAG(int, max_search_states, 100000,
           "Limits the number of search states explored during "
           "line wrap optimization.");
+ABSL_FLAG(int64_t, search_time_limit_ms, 0,
+          "Limits the time spent on each line wrap optimization, in "
+          "milliseconds.  A search that runs out of time uses the best "
+          "wrapping found so far, without error, which keeps the time to "
+          "format predictable.  Results then depend on timing, so they are "
+          "not cached.  0 means unlimited.");
+ABSL_FLAG(int64_t, file_time_budget_ms, 0,
+          "Limits the time spent formatting each file, in milliseconds.  "
+          "A file that runs out of time is left unchanged, with a diagnostic "
+          "and exit status 3, and the remaining files are still formatted.  "
+          "0 means unlimited.");
+ABSL_FLAG(int64_t, file_memory_budget_mb, 0,
+          "Limits the growth of memory usage while formatting each file, in "
+          "MiB, with the same effect as --file_time_budget_ms.  Memory is "
+          "measured for the whole process, so with --threads other than 1, "
+          "files formatted at the same time count against each other's "
+          "budget.  0 means unlimited.");
+ABSL_FLAG(bool, print_stats, false,
+          "Prints statistics about each file (sizes of the token stream and "
+          "syntax tree, line wrap search effort, and memory growth per phase) "
+          "to stderr.  Files are always formatted, bypassing --cache_dir.");
 
 ABSL_FLAG(
     PreserveSpaces, preserve_vspaces, PreserveSpaces::UnhandledCasesOnly,
@@ -72,27 +122,56 @@ ABSL_FLAG(
   all: keep original vertical spacing (newlines only, no spaces/tabs)
   unhandled: same as 'all' (for now).)");
 
-int main(int argc, char** argv) {
-  const auto usage = absl::StrCat("usage: ", argv[0],
-                                  " [options] <file>\n"
-                                  "To pipe from stdin, use '-' as <file>.");
-  const auto file_args = verible::InitCommandLine(usage, &argc, &argv);
+// Identifies the formatter's behavior in cached results.  Bump this whenever
+// the formatted output for some input may change, so that results cached by
+// an older version are not reused.
+static constexpr absl::string_view kFormatterCacheVersion = "1";
 
-  // Currently accepts only one file positional argument.
-  // TODO(fangism): Support multiple file names.
-  QCHECK_GT(file_args.size(), 1)
-      << "Missing required positional argument (filename).";
-  const absl::string_view filename = file_args[1];
+// Exit status for a file that ran out of its budget.
+static constexpr int kBudgetExhaustedExitCode = 3;
+
+// Options that apply to every file.
+struct FileFormatOptions {
+  FormatStyle style;
+  ExecutionControl control;
+  LineNumberSet lines;  // empty means all lines
+  bool inplace = false;
+  bool check = false;
+  bool print_stats = false;
+  // Budget for each file (unlimited by default).
+  absl::Duration time_budget = absl::InfiniteDuration();
+  size_t memory_budget_bytes = 0;
+  // If non-null, cache of formatted results (shared by all files).
+  verible::ContentCache* cache = nullptr;
+};
 
-  const bool inplace = FLAGS_inplace.Get();
+// Returns the key under which the formatted result of 'content' is cached.
+// This covers everything that determines the formatted output.
+static std::string FormatCacheKey(absl::string_view content,
+                                  const FileFormatOptions& options) {
+  verible::ContentHasher hasher;
+  hasher.Add(kFormatterCacheVersion);
+  const FormatStyle& style(options.style);
+  hasher.Add(style.indentation_spaces)
+      .Add(style.wrap_spaces)
+      .Add(style.column_limit)
+      .Add(style.over_column_limit_penalty)
+      .Add(static_cast<int64_t>(style.preserve_vertical_spaces));
+  hasher.Add(options.lines.size());
+  for (const auto& range : options.lines) {
+    hasher.Add(range.first).Add(range.second);
+  }
+  return hasher.Add(content).HexDigest();
+}
+
+// Formats one file, writing formatted text (and diagnostics) to 'out',
+// and errors to 'err'.  Returns the exit code for this file.
+static int FormatOneFile(absl::string_view filename,
+                         const FileFormatOptions& options, std::ostream& out,
+                         std::ostream& err) {
   const bool is_stdin = filename == "-";
   const auto& stdin_name = FLAGS_stdin_name.Get();
 
-  if (inplace && is_stdin) {
-    std::cerr << "--inplace is incompatible with stdin.  Ignoring --inplace "
-                 "and writing to stdout."
-              << std::endl;
-  }
   absl::string_view diagnostic_filename = filename;
   if (is_stdin) {
     diagnostic_filename = stdin_name;
@@ -100,15 +179,127 @@ int main(int argc, char** argv) {
 
   // Read contents into memory first.
   std::string content;
-  if (!verible::file::GetContents(filename, &content)) return 1;
+  if (!verible::file::GetContents(filename, &content)) {
+    err << "Error reading file: " << filename << std::endl;
+    return 1;
+  }
 
   // TODO(fangism): When requesting --inplace, verify that file
   // is write-able, and fail-early if it is not.
 
-  // Handle special debugging modes.
-  ExecutionControl formatter_control;
+  ExecutionControl formatter_control(options.control);
+  formatter_control.stream = &out;  // for diagnostics only
+
+  FormatStats stats;
+  if (options.print_stats) formatter_control.stats = &stats;
+
+  verible::ResourceBudget budget(options.time_budget,
+                                 options.memory_budget_bytes);
+  formatter_control.budget = &budget;
+
+  // Diagnostic modes need to run the formatter.
+  const bool use_cache = options.cache != nullptr &&
+                         !options.control.AnyStop() &&
+                         !options.control.show_equally_optimal_wrappings &&
+                         !options.print_stats &&
+                         options.control.search_time_limit ==
+                             absl::InfiniteDuration();
+  const std::string cache_key =
+      use_cache ? FormatCacheKey(content, options) : "";
+
+  std::string formatted_output;
+  if (use_cache && options.cache->Lookup(cache_key, &formatted_output)) {
+    // Cached results were already verified when they were stored.
+    VLOG(1) << "cached formatting result for: " << diagnostic_filename;
+  } else {
+    const auto format_status =
+        FormatVerilog(content, diagnostic_filename, options.style,
+                      &formatted_output, formatter_control, options.lines);
+    if (options.print_stats) {
+      err << "Statistics for " << diagnostic_filename << ":" << std::endl
+          << stats;
+    }
+
+    if (formatter_control.BudgetExhausted()) {
+      err << diagnostic_filename
+          << ": formatting stopped: " << format_status.message() << std::endl;
+      // Leave the original untouched, but still print it to stdout (in case
+      // the user is redirecting output to a file, possibly the original).
+      if (!options.check && (!options.inplace || is_stdin)) out << content;
+      return kBudgetExhaustedExitCode;
+    }
+    if (!format_status.ok()) {
+      err << format_status.message();
+      if (format_status.code() != StatusCode::kCancelled) {
+        // Don't bother printing original code
+        return 1;
+      }
+      // Do not write back to file, leave original untouched.
+      // Print original code to stdout (in case user is redirecting output
+      // to a file, possibly the original), and rejected output to stderr.
+      err << "Problematic formatter output is:\n"
+          << formatted_output << "<<EOF>>" << std::endl;
+      out << content;
+      return 1;
+    }
+    // Only successful results are cached.  Failure to store a result is
+    // not an error.
+    if (use_cache) options.cache->Insert(cache_key, formatted_output);
+  }
+
+  if (options.check) {
+    if (formatted_output == content) return 0;
+    out << diagnostic_filename << std::endl;
+    return 1;
+  }
+
+  // Safe to write out result, having passed above verification.
+  if (options.inplace && !is_stdin) {
+    // Leave unchanged files untouched, preserving their timestamps.
+    if (formatted_output == content) return 0;
+    // Write to a temporary file and rename it over the original, so that
+    // the original is never left truncated or partially written.
+    if (verible::file::SetContentsAtomically(filename, formatted_output)) {
+      return 0;
+    }
+    err << "Error writing to file: " << filename << std::endl;
+    err << "Printing to stdout instead." << std::endl;
+    out << formatted_output;
+    return 1;
+  }
+  out << formatted_output;
+  return 0;
+}
+
+// Captured output of formatting one file, for printing in input order.
+struct FileFormatResult {
+  int exit_code = 0;
+  std::ostringstream out;
+  std::ostringstream err;
+};
+
+int main(int argc, char** argv) {
+  const auto usage = absl::StrCat("usage: ", argv[0],
+                                  " [options] <file> [<file>...]\n"
+                                  "To pipe from stdin, use '-' as <file>.");
+  const auto file_args = verible::InitCommandLine(usage, &argc, &argv);
+
+  QCHECK_GT(file_args.size(), 1)
+      << "Missing required positional argument (filename).";
+  // All positional arguments are file names.  Exclude program name.
+  const std::vector<absl::string_view> filenames(file_args.begin() + 1,
+                                                 file_args.end());
+
+  FileFormatOptions options;
+  options.inplace = FLAGS_inplace.Get();
+  options.check = FLAGS_check.Get();
+  options.print_stats = FLAGS_print_stats.Get();
+  options.time_budget = absl::Milliseconds(FLAGS_file_time_budget_ms.Get());
+  options.memory_budget_bytes = static_cast<size_t>(std::max<int64_t>(
+                                    FLAGS_file_memory_budget_mb.Get(), 0))
+                                << 20;
   {
-    formatter_control.stream = &std::cout;  // for diagnostics only
+    auto& formatter_control = options.control;
     formatter_control.show_largest_token_partitions =
         FLAGS_show_largest_token_partitions.Get();
     formatter_control.show_token_partition_tree =
@@ -116,46 +307,83 @@ int main(int argc, char** argv) {
     formatter_control.show_equally_optimal_wrappings =
         FLAGS_show_equally_optimal_wrappings.Get();
     formatter_control.max_search_states = FLAGS_max_search_states.Get();
+    if (FLAGS_search_time_limit_ms.Get() > 0) {
+      formatter_control.search_time_limit =
+          absl::Milliseconds(FLAGS_search_time_limit_ms.Get());
+    }
   }
-
-  FormatStyle format_style;
-  { format_style.preserve_vertical_spaces = FLAGS_preserve_vspaces.Get(); }
-
-  std::ostringstream stream;
-  const auto format_status = FormatVerilog(
-      content, diagnostic_filename, format_style, stream, formatter_control);
-
-  const std::string& formatted_output(stream.str());
-  if (!format_status.ok()) {
-    std::cerr << format_status.message();
-    if (format_status.code() != StatusCode::kCancelled) {
-      // Don't bother printing original code
+  options.style.preserve_vertical_spaces = FLAGS_preserve_vspaces.Get();
+  {
+    std::string error;
+    if (!verilog::formatter::ParseInclusiveLineRanges(
+            FLAGS_lines.Get(), &options.lines, &error)) {
+      std::cerr << "Invalid --lines: " << error << std::endl;
       return 1;
     }
-    // Do not write back to file, leave original untouched.
-    // Print original code to stdout (in case user is redirecting output
-    // to a file, possibly the original), and rejected output to stderr.
-    std::cerr << "Problematic formatter output is:\n"
-              << formatted_output << "<<EOF>>" << std::endl;
-    std::cout << content;
-    return 1;
   }
 
-  // Safe to write out result, having passed above verification.
-  int exit_code = 0;
-  std::ostream* output_stream = &std::cout;
-  std::ofstream inplace_file;
-  if (inplace && !is_stdin) {
-    inplace_file.open(std::string(filename));
-    if (inplace_file.good()) {
-      output_stream = &inplace_file;
+  std::unique_ptr<verible::ContentCache> cache;
+  if (!FLAGS_cache_dir.Get().empty()) {
+    const int64_t max_bytes = std::max<int64_t>(FLAGS_cache_max_bytes.Get(), 0);
+    cache = absl::make_unique<verible::ContentCache>(FLAGS_cache_dir.Get(),
+                                                     max_bytes);
+    if (cache->ok()) {
+      options.cache = cache.get();
     } else {
-      std::cerr << "Error writing to file: " << filename << std::endl;
-      std::cerr << "Printing to stdout instead." << std::endl;
-      exit_code = 1;
+      std::cerr << "Unable to use --cache_dir " << FLAGS_cache_dir.Get()
+                << ", formatting without cache." << std::endl;
     }
   }
-  *output_stream << formatted_output;
 
+  const bool has_stdin =
+      std::find(filenames.begin(), filenames.end(), "-") != filenames.end();
+  if (options.inplace && has_stdin) {
+    std::cerr << "--inplace is incompatible with stdin.  Ignoring --inplace "
+                 "and writing to stdout."
+              << std::endl;
+  }
+
+  if (filenames.size() == 1) {
+    // Stream directly, there is nothing to interleave with.
+    return FormatOneFile(filenames.front(), options, std::cout, std::cerr);
+  }
+
+  // Formatted text of multiple files cannot be told apart on stdout.
+  if (!options.inplace && !options.check) {
+    std::cerr << "Formatting multiple files requires --inplace or --check."
+              << std::endl;
+    return 1;
+  }
+  if (!options.lines.empty()) {
+    std::cerr << "--lines only applies to a single file." << std::endl;
+    return 1;
+  }
+  if (has_stdin) {
+    std::cerr << "Reading from stdin ('-') is only supported for a single file."
+              << std::endl;
+    return 1;
+  }
+
+  // Format files concurrently.  Each file's output is captured, and printed
+  // in the original file order, so that results are deterministic.
+  std::vector<FileFormatResult> results(filenames.size());
+  {
+    verible::ThreadPool pool(std::min<size_t>(
+        std::max(FLAGS_threads.Get(), 0), filenames.size()));
+    for (size_t i = 0; i < filenames.size(); ++i) {
+      pool.Schedule([&filenames, &options, &results, i]() {
+        auto& result = results[i];
+        result.exit_code =
+            FormatOneFile(filenames[i], options, result.out, result.err);
+      });
+    }
+  }  // Waits for all files to finish.
+
+  int exit_code = 0;
+  for (const auto& result : results) {
+    std::cout << result.out.str();
+    std::cerr << result.err.str();
+    exit_code = std::max(exit_code, result.exit_code);
+  }
   return exit_code;
 }
@@ -0,0 +1,114 @@
+// Copyright 2017-2020 The Verible Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// verilog_index maintains an index of where modules, interfaces, packages
+// and classes are defined and referenced in a project, and looks up names in
+// it without parsing any source file.
+//
+// Example usage:
+//   verilog_index --index_file=project.idx files...
+//     (re)indexes the files, analyzing only those that changed; the new
+//     index holds only these files, so list all files of the project
+//   verilog_index --index_file=project.idx --lookup=name
+//     prints the definitions of, and references to, 'name'
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/strings/str_cat.h"
+#include "common/util/file_util.h"
+#include "common/util/init_command_line.h"
+#include "common/util/mapped_file.h"
+#include "common/util/status.h"
+#include "verilog/analysis/symbol_index.h"
+#include "verilog/analysis/verilog_symbols.h"
+
+ABSL_FLAG(std::string, index_file, "", "Path of the symbol index (required).");
+ABSL_FLAG(std::string, lookup, "",
+          "Prints the definitions of, and references to, this name, "
+          "instead of indexing files.");
+ABSL_FLAG(int, threads, 0,
+          "Number of threads that analyze files.  0 uses all available "
+          "hardware threads.");
+
+using verilog::SymbolIndexView;
+
+// Prints the matches of 'name' in the index, one per line, like
+// "path:line:column: module definition name".
+static int Lookup(const SymbolIndexView& index, const std::string& name) {
+  const auto matches = index.Lookup(name);
+  for (const auto& match : matches) {
+    std::cout << match.path << ':' << match.location << std::endl;
+  }
+  return matches.empty() ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  const auto usage = absl::StrCat(
+      "usage: ", argv[0],
+      " --index_file=FILE [options] <file> [<file>...]\n"
+      "       ",
+      argv[0],
+      " --index_file=FILE --lookup=NAME\n\n"
+      "Indexing rewrites the index with only the listed files: files that\n"
+      "were indexed before but are not listed are dropped from it.  Listed\n"
+      "files that did not change since the previous index are not "
+      "analyzed again.");
+  const auto args = verible::InitCommandLine(usage, &argc, &argv);
+  const std::string index_file = absl::GetFlag(FLAGS_index_file);
+  if (index_file.empty()) {
+    std::cerr << "--index_file is required" << std::endl;
+    return 2;
+  }
+
+  // The existing index is read in place: a lookup reads only what it needs,
+  // and an update copies only the symbols of unchanged files.
+  verible::MappedFile mapped;
+  SymbolIndexView previous;
+  auto status = mapped.Open(index_file);
+  if (status.ok()) status = previous.Init(mapped.contents());
+
+  const std::string name = absl::GetFlag(FLAGS_lookup);
+  if (!name.empty()) {
+    if (!status.ok()) {
+      std::cerr << index_file << ": " << status.message() << std::endl;
+      return 2;
+    }
+    return Lookup(previous, name);
+  }
+
+  // All positional arguments are file names.  Exclude program name.
+  const std::vector<std::string> paths(args.begin() + 1, args.end());
+  verilog::SymbolIndexStats stats;
+  // Negative thread counts mean 0, and there is no use for more threads
+  // than files.
+  const size_t threads = std::min<size_t>(
+      std::max(absl::GetFlag(FLAGS_threads), 0), paths.size());
+  const auto files = verilog::IndexFiles(
+      paths, verilog::ExtractVerilogSymbols, threads,
+      status.ok() ? &previous : nullptr, &stats);
+  const std::string data = verilog::SerializeSymbolIndex(files);
+  if (!verible::file::SetContentsAtomically(index_file, data)) {
+    std::cerr << "Cannot write " << index_file << std::endl;
+    return 2;
+  }
+  std::cerr << "Indexed " << files.size() << " files: " << stats.analyzed_files
+            << " analyzed, " << stats.reused_files << " unchanged, "
+            << stats.unreadable_files << " unreadable." << std::endl;
+  return stats.unreadable_files == 0 ? 0 : 1;
+}
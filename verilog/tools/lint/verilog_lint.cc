@@ -17,7 +17,10 @@
 //
 // Example usage:
 // verilog_lint files...
+// verilog_lint --cache_dir=$HOME/.cache/verilog_lint files...
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <sstream>  // IWYU pragma: keep  // for ostringstream
@@ -25,13 +28,23 @@
 #include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/time/time.h"
+#include "common/util/content_cache.h"
+#include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
 #include "common/util/logging.h"  // for operator<<, LOG, LogMessage, etc
+#include "common/util/resource_budget.h"
 #include "common/util/status.h"
+#include "verilog/analysis/analysis_stats.h"
 #include "verilog/analysis/verilog_linter.h"
 #include "verilog/analysis/verilog_linter_configuration.h"
+#include "verilog/preprocessor/verilog_preprocess.h"
 
 // Reminder: The linter service expects the program to return 0 unless
 // there is a fatal error, regardless of parse/lint status.
@@ -41,6 +54,45 @@ ABSL_FLAG(bool, parse_fatal, false,
           "If true, exit nonzero if there are any syntax errors.");
 ABSL_FLAG(bool, lint_fatal, false,
           "If true, exit nonzero if linter finds violations.");
+ABSL_FLAG(int, lint_threads, 1,
+          "Number of threads used to analyze each file, which helps with "
+          "very large files.  0 uses all available hardware threads.");
+ABSL_FLAG(std::string, cache_dir, "",
+          "If set, reuse lint results from this directory, and store new "
+          "results there.  The directory is created if it does not exist, "
+          "and may be shared by concurrent invocations.");
+ABSL_FLAG(int64_t, cache_max_bytes, 256 << 20,
+          "Limits the total size of --cache_dir, by evicting the least "
+          "recently used results.  0 means unlimited.");
+ABSL_FLAG(bool, print_stats, false,
+          "Prints statistics about each file (sizes of the token stream and "
+          "syntax tree, parser stack depth, macro usage, and memory growth per "
+          "phase) to stderr.  Files are always analyzed, bypassing "
+          "--cache_dir.");
+ABSL_FLAG(int64_t, file_time_budget_ms, 0,
+          "Limits the time spent analyzing each file, in milliseconds.  "
+          "Analysis of a file that runs out of time stops with a diagnostic "
+          "and exit status 3, and the remaining files are still linted.  "
+          "0 means unlimited.");
+ABSL_FLAG(int64_t, file_memory_budget_mb, 0,
+          "Limits the growth of memory usage while analyzing each file, in "
+          "MiB, with the same effect as --file_time_budget_ms.  "
+          "0 means unlimited.");
+ABSL_FLAG(std::vector<std::string>, include_dir, {},
+          "Comma-separated directories in which `include files are looked "
+          "up, after the directory of the including file.  Only used with "
+          "--define_configs, where `ifdef and related directives see the "
+          "macros defined by included files.  Each included file is "
+          "preprocessed only once for all files.");
+ABSL_FLAG(std::vector<std::string>, define_configs, {},
+          "Comma-separated configurations to lint each file in, each a "
+          "'+'-separated list of macros to define, as with +define+ "
+          "(e.g. ASIC,FPGA+SIM; values after '=' are ignored).  `ifdef and "
+          "related directives are evaluated in each configuration, and "
+          "diagnostics are reported per configuration.  Each file is lexed "
+          "once, and configurations that select the same code share one "
+          "parse.  Lint results are not cached, and --print_stats is "
+          "ignored, with this flag.");
 ABSL_FLAG(std::string, help_rules, "",
           "[all|<rule-name>], print the description of one rule/all rules "
           "and exit immediately.");
@@ -52,6 +104,82 @@ ABSL_FLAG(
 
 using verilog::LinterConfiguration;
 
+// Identifies the linter's behavior in cached results.  Bump this whenever
+// the diagnostics for some input may change, so that results cached by
+// an older version are not reused.
+static constexpr absl::string_view kLinterCacheVersion = "1";
+
+// Returns the key under which the lint results of 'content' are cached.
+// This covers everything that determines the diagnostics and exit status.
+// The file name is included because it appears in diagnostics.
+static std::string LintCacheKey(absl::string_view filename,
+                                absl::string_view content,
+                                const LinterConfiguration& config,
+                                bool parse_fatal, bool lint_fatal) {
+  std::ostringstream active_rules;
+  active_rules << config;
+  return verible::ContentHasher()
+      .Add(kLinterCacheVersion)
+      .Add(active_rules.str())
+      .Add(parse_fatal)
+      .Add(lint_fatal)
+      .Add(filename)
+      .Add(content)
+      .HexDigest();
+}
+
+// Parses a --define_configs configuration, like "FPGA+SIM" or "+define+A=1".
+static verilog::VerilogDefineSet ParseDefineSet(absl::string_view text) {
+  verilog::VerilogDefineSet defines;
+  text = absl::StripPrefix(text, "+define+");
+  for (const absl::string_view define :
+       absl::StrSplit(text, '+', absl::SkipEmpty())) {
+    defines.emplace(define.substr(0, define.find('=')));
+  }
+  return defines;
+}
+
+// Same as verilog::LintOneFile(), but replays the results from 'cache' when
+// the same file was already linted with the same configuration.
+// Cached entries hold the exit status on the first line, followed by the
+// diagnostics.
+static int LintOneFileCached(std::ostream* stream, absl::string_view filename,
+                             const LinterConfiguration& config,
+                             bool parse_fatal, bool lint_fatal,
+                             size_t num_threads, verible::ContentCache* cache,
+                             verible::ResourceBudget* budget) {
+  std::string content;
+  if (!verible::file::GetContents(filename, &content)) return 2;
+  const std::string cache_key =
+      LintCacheKey(filename, content, config, parse_fatal, lint_fatal);
+
+  std::string entry;
+  if (cache->Lookup(cache_key, &entry)) {
+    const auto newline = entry.find('\n');
+    int lint_status;
+    if (newline != std::string::npos &&
+        absl::SimpleAtoi(absl::string_view(entry).substr(0, newline),
+                         &lint_status)) {
+      VLOG(1) << "cached lint result for: " << filename;
+      *stream << absl::string_view(entry).substr(newline + 1);
+      return lint_status;
+    }
+    // Otherwise, the entry is unusable; lint and replace it.
+  }
+
+  std::ostringstream output;
+  const int lint_status = verilog::LintOneFileContents(
+      &output, filename, content, config, parse_fatal, lint_fatal, num_threads,
+      nullptr, budget);
+  *stream << output.str();
+  // Results of running out of budget depend on the machine and its load,
+  // so they are not cached.
+  if (lint_status == verilog::kLintBudgetExhausted) return lint_status;
+  // Failure to store a result is not an error.
+  cache->Insert(cache_key, absl::StrCat(lint_status, "\n", output.str()));
+  return lint_status;
+}
+
 int main(int argc, char** argv) {
   const auto usage =
       absl::StrCat("usage: ", argv[0], " [options] <file> [<file>...]");
@@ -73,16 +201,72 @@ int main(int argc, char** argv) {
   const LinterConfiguration baseline_config(
       verilog::LinterConfigurationFromFlags());
 
+  std::unique_ptr<verible::ContentCache> cache;
+  const std::string cache_dir = absl::GetFlag(FLAGS_cache_dir);
+  if (!cache_dir.empty()) {
+    const int64_t max_bytes =
+        std::max<int64_t>(absl::GetFlag(FLAGS_cache_max_bytes), 0);
+    cache = absl::make_unique<verible::ContentCache>(cache_dir, max_bytes);
+    if (!cache->ok()) {
+      std::cerr << "Unable to use --cache_dir " << cache_dir
+                << ", linting without cache." << std::endl;
+      cache.reset();
+    }
+  }
+  const std::vector<std::string> include_dirs =
+      absl::GetFlag(FLAGS_include_dir);
+  std::vector<verilog::VerilogDefineSet> configurations;
+  for (const auto& define_config : absl::GetFlag(FLAGS_define_configs)) {
+    configurations.push_back(ParseDefineSet(define_config));
+  }
+
+  const bool parse_fatal = absl::GetFlag(FLAGS_parse_fatal);
+  const bool lint_fatal = absl::GetFlag(FLAGS_lint_fatal);
+  const size_t lint_threads = std::max(absl::GetFlag(FLAGS_lint_threads), 0);
+  const bool print_stats = absl::GetFlag(FLAGS_print_stats);
+  const absl::Duration time_budget =
+      absl::Milliseconds(absl::GetFlag(FLAGS_file_time_budget_ms));
+  const int64_t memory_budget_mb =
+      std::max<int64_t>(absl::GetFlag(FLAGS_file_memory_budget_mb), 0);
+  const size_t memory_budget_bytes = static_cast<size_t>(memory_budget_mb)
+                                     << 20;
   int exit_status = 0;
   // All positional arguments are file names.  Exclude program name.
   for (const auto filename :
        verible::make_range(args.begin() + 1, args.end())) {
     // Copy configuration, so that it can be locally modified per file.
     LinterConfiguration config(baseline_config);
+    verible::ResourceBudget budget(time_budget, memory_budget_bytes);
+
+    if (!configurations.empty()) {
+      std::string content;
+      if (!verible::file::GetContents(filename, &content)) {
+        exit_status = std::max(2, exit_status);
+        continue;
+      }
+      const int lint_status = verilog::LintOneFileConfigurations(
+          &std::cout, filename, content, configurations, config, parse_fatal,
+          lint_fatal, lint_threads, &budget, include_dirs);
+      exit_status = std::max(lint_status, exit_status);
+      continue;
+    }
+
+    if (print_stats) {
+      verilog::AnalysisStats stats;
+      const int lint_status =
+          verilog::LintOneFile(&std::cout, filename, config, parse_fatal,
+                               lint_fatal, lint_threads, &stats, &budget);
+      std::cerr << "Statistics for " << filename << ":" << std::endl << stats;
+      exit_status = std::max(lint_status, exit_status);
+      continue;
+    }
 
-    const int lint_status = verilog::LintOneFile(
-        &std::cout, filename, config, absl::GetFlag(FLAGS_parse_fatal),
-        absl::GetFlag(FLAGS_lint_fatal));
+    const int lint_status =
+        cache != nullptr
+            ? LintOneFileCached(&std::cout, filename, config, parse_fatal,
+                                lint_fatal, lint_threads, cache.get(), &budget)
+            : verilog::LintOneFile(&std::cout, filename, config, parse_fatal,
+                                   lint_fatal, lint_threads, nullptr, &budget);
     exit_status = std::max(lint_status, exit_status);
   }  // for each file
 
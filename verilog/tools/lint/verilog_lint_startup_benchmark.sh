@@ -0,0 +1,60 @@
+#!/bin/bash
+# Copyright 2017-2020 The Verible Authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+usage() {
+  cat <<EOF
+Measures the time-to-first-file of verilog_lint: the average wall time of
+one invocation on a one-line file, which is dominated by process startup
+and rule setup.  Build systems run the linter once per file, so this cost
+is paid over and over.
+
+usage: $0 [runs [verilog_lint]]
+  runs: number of invocations per configuration (default: 100)
+  verilog_lint: path to the linter (default: the one next to this script)
+
+Example:
+  bazel run -c opt //verilog/tools/lint:verilog_lint_startup_benchmark -- 200
+EOF
+}
+
+case "$1" in
+  -h|--help) usage; exit 0 ;;
+esac
+
+readonly runs="${1:-100}"
+linter="${2:-$(dirname "$0")/verilog_lint}"
+[[ -x "$linter" ]] || linter="verilog/tools/lint/verilog_lint"
+[[ -x "$linter" ]] || { echo "Cannot find verilog_lint." >&2; usage; exit 1; }
+
+readonly input="$(mktemp --suffix=.sv)"
+trap 'rm -f "$input"' EXIT
+echo "module m; endmodule" > "$input"
+
+# Prints the average wall time per invocation, with the given flags.
+measure() {
+  local -r start="$(date +%s%N)"
+  for ((i = 0; i < runs; ++i)); do
+    "$linter" "$@" "$input" > /dev/null 2>&1
+  done
+  local -r end="$(date +%s%N)"
+  local -r micros=$(( (end - start) / runs / 1000 ))
+  printf "%-20s %6d.%03d ms\n" "$*" $((micros / 1000)) $((micros % 1000))
+}
+
+echo "Average time-to-first-file over $runs runs:"
+measure --ruleset=none
+measure --ruleset=default
+measure --ruleset=all
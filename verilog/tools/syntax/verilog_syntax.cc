@@ -37,8 +37,10 @@
 #include "common/util/file_util.h"
 #include "common/util/init_command_line.h"
 #include "common/util/logging.h"  // for operator<<, LOG, LogMessage, etc
+#include "common/util/memory_usage.h"
 #include "common/util/status.h"
 #include "verilog/CST/verilog_tree_print.h"
+#include "verilog/analysis/analysis_stats.h"
 #include "verilog/analysis/verilog_analyzer.h"
 #include "verilog/parser/verilog_parser.h"
 
@@ -46,9 +48,17 @@ ABSL_FLAG(bool, printtree, false, "Whether or not to print the tree");
 ABSL_FLAG(bool, printtokens, false, "Prints all lexed and filtered tokens");
 ABSL_FLAG(bool, printrawtokens, false,
           "Prints all lexed tokens, including filtered ones.");
+ABSL_FLAG(int, parse_threads, 1,
+          "Number of threads used to parse each file.  Files with many "
+          "top-level modules are parsed in concurrent pieces.  0 uses all "
+          "available hardware threads.");
 ABSL_FLAG(
     bool, verifytree, false,
     "Verifies that all tokens are parsed into tree, prints unmatched tokens");
+ABSL_FLAG(bool, print_stats, false,
+          "Prints statistics about each file (sizes of the token stream and "
+          "syntax tree, parser stack depth, macro usage, and memory growth per "
+          "phase) to stderr.");
 
 using verible::ConcreteSyntaxTree;
 using verible::ParserVerifier;
@@ -75,8 +85,11 @@ static void VerifyParseTree(const TextStructureView& text_structure) {
 static int AnalyzeOneFile(absl::string_view content,
                           absl::string_view filename) {
   int exit_status = 0;
+  const size_t resident_bytes_before_analysis =
+      verible::CurrentResidentMemoryBytes();
   const auto analyzer =
-      verilog::VerilogAnalyzer::AnalyzeAutomaticMode(content, filename);
+      verilog::VerilogAnalyzer::AnalyzeAutomaticMode(
+          content, filename, std::max(absl::GetFlag(FLAGS_parse_threads), 0));
   const auto lex_status = ABSL_DIE_IF_NULL(analyzer)->LexStatus();
   const auto parse_status = analyzer->ParseStatus();
   if (!lex_status.ok() || !parse_status.ok()) {
@@ -89,6 +102,12 @@ static int AnalyzeOneFile(absl::string_view content,
   }
   const bool parse_ok = parse_status.ok();
 
+  if (absl::GetFlag(FLAGS_print_stats)) {
+    verilog::AnalysisStats stats(verilog::ComputeAnalysisStats(*analyzer));
+    stats.RecordMemoryGrowth("analysis", resident_bytes_before_analysis);
+    std::cerr << "Statistics for " << filename << ":" << std::endl << stats;
+  }
+
   const verible::TokenInfo::Context context(
       analyzer->Data().Contents(), [](std::ostream& stream, int e) {
         stream << verilog::verilog_symbol_name(e);